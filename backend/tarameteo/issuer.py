@@ -9,6 +9,7 @@
     timedelta,
 )
 from pathlib import Path
+from typing import Literal
 
 from attrs import define
 from cryptography import x509
@@ -16,7 +17,10 @@
     hashes,
     serialization,
 )
-from cryptography.hazmat.primitives.asymmetric import rsa
+from cryptography.hazmat.primitives.asymmetric import (
+    ec,
+    rsa,
+)
 from cryptography.x509.oid import (
     ExtendedKeyUsageOID,
     NameOID,
@@ -40,11 +44,15 @@
 CA_KEY = Path(os.getenv("CA_KEY", "/pki/ca.key"))
 CA_CRT = Path(os.getenv("CA_CRT", "/pki/ca.crt"))
 CERT_DAYS = int(os.getenv("CERT_DAYS", "30"))
+KEY_TYPE = os.getenv("KEY_TYPE", "rsa")
+
+KeyType = Literal["rsa", "ec"]
 
 
 class MintRequest(BaseModel):
     device_id: str = Field(min_length=3, max_length=64, pattern=r"^[A-Za-z0-9_-]+$")
     ttl_days: int = Field(default=CERT_DAYS, ge=1, le=365)
+    key_type: KeyType = Field(default=KEY_TYPE)
 
 
 class MintResponse(BaseModel):
@@ -78,6 +86,13 @@ async def get_issuer_client(env = os.environ, timeout: float = 5.0) -> AsyncIter
         yield IssuerClient(http, token)
 
 
+def generate_device_key(key_type: KeyType) -> rsa.RSAPrivateKey | ec.EllipticCurvePrivateKey:
+    """Generate a device key, P-256 being much cheaper than RSA-2048 to sign with on the device."""
+    if key_type == "ec":
+        return ec.generate_private_key(ec.SECP256R1())
+    return rsa.generate_private_key(public_exponent=65537, key_size=2048)
+
+
 def require_token(authorization: str | None = Header(default=None)) -> None:
     if not authorization or not authorization.startswith("Bearer "):
         raise HTTPException(status_code=401, detail="Missing bearer token")
@@ -92,7 +107,7 @@ def mint_cert(request: MintRequest) -> MintResponse:
     ca_crt = x509.load_pem_x509_certificate(CA_CRT.read_bytes())
     ca_key = serialization.load_pem_private_key(CA_KEY.read_bytes(), password=None)
 
-    device_key = rsa.generate_private_key(public_exponent=65537, key_size=2048)
+    device_key = generate_device_key(request.key_type)
     subject = x509.Name([x509.NameAttribute(NameOID.COMMON_NAME, request.device_id)])
 
     now = datetime.now(UTC)
@@ -113,7 +128,7 @@ def mint_cert(request: MintRequest) -> MintResponse:
         .add_extension(
             x509.KeyUsage(
                 digital_signature=True,
-                key_encipherment=True,
+                key_encipherment=request.key_type == "rsa",
                 content_commitment=False,
                 data_encipherment=False,
                 key_agreement=False,
@@ -28,3 +28,13 @@ async def test_issuer_mint_cert(issuer_client, unique):
         expires_at=greater_than(datetime.now(UTC)),
         serial=matches_regexp(r"0x[a-f0-9]+"),
     ))
+
+
+@pytest.mark.asyncio
+async def test_issuer_mint_ec_cert(issuer_client, unique):
+    request = MintRequest(device_id=unique("text"), key_type="ec")
+    response = await issuer_client.mint(request)
+    assert_that(response, has_properties(
+        key_pem=contains_string("BEGIN EC PRIVATE KEY"),
+        cert_pem=contains_string("BEGIN CERTIFICATE"),
+    ))
@@ -0,0 +1,63 @@
+#include "AltitudeTable.h"
+
+namespace {
+
+// C++11 constexpr series, so that the table is built by the compiler and
+// the device only ever does integer interpolation.
+
+// ln(x) = 2 * atanh(y) with y = (x - 1) / (x + 1); |y| < 0.35 over the table
+constexpr double atanhSeries(double y2, double power, int k) {
+  return k >= 30 ? 0.0 : power / (2 * k + 1) + atanhSeries(y2, power * y2, k + 1);
+}
+
+constexpr double seriesLn(double x) { return 2.0 * atanhSeries(((x - 1) / (x + 1)) * ((x - 1) / (x + 1)), (x - 1) / (x + 1), 0); }
+
+constexpr double expSeries(double z, double term, int k) { return k >= 20 ? 0.0 : term + expSeries(z, term * z / (k + 1), k + 1); }
+
+constexpr double seriesExp(double z) { return expSeries(z, 1.0, 0); }
+
+constexpr double ratioAt(int i) { return 0.5 + i / 128.0; }
+
+constexpr int32_t roundToInt(double value) {
+  return static_cast<int32_t>(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+constexpr int32_t cm(int i) { return roundToInt(4433000.0 * (1.0 - seriesExp(0.1903 * seriesLn(ratioAt(i))))); }
+
+#define ALTITUDE_ROW(i) cm(i), cm(i + 1), cm(i + 2), cm(i + 3), cm(i + 4), cm(i + 5)
+
+constexpr int32_t TABLE[AltitudeTable::ENTRIES] = {
+    ALTITUDE_ROW(0),  ALTITUDE_ROW(6),  ALTITUDE_ROW(12), ALTITUDE_ROW(18), ALTITUDE_ROW(24), ALTITUDE_ROW(30),
+    ALTITUDE_ROW(36), ALTITUDE_ROW(42), ALTITUDE_ROW(48), ALTITUDE_ROW(54), ALTITUDE_ROW(60), ALTITUDE_ROW(66),
+    ALTITUDE_ROW(72)};
+
+#undef ALTITUDE_ROW
+
+const uint64_t RATIO_MIN = 1ULL << (AltitudeTable::RATIO_SHIFT - 1); // 0.5
+const uint64_t RATIO_SPAN = static_cast<uint64_t>(AltitudeTable::ENTRIES - 1) << AltitudeTable::STEP_SHIFT;
+const uint32_t STEP_MASK = (1UL << AltitudeTable::STEP_SHIFT) - 1;
+
+} // namespace
+
+int32_t AltitudeTable::centimetres(uint32_t pressure, uint32_t seaLevelPressure) {
+  if (seaLevelPressure == 0) {
+    return 0;
+  }
+
+  uint64_t ratio = (static_cast<uint64_t>(pressure) << RATIO_SHIFT) / seaLevelPressure;
+  uint64_t offset = ratio > RATIO_MIN ? ratio - RATIO_MIN : 0;
+  if (offset > RATIO_SPAN) {
+    offset = RATIO_SPAN;
+  }
+
+  // The last entry is only reached with a full step from the one before it
+  uint32_t index = static_cast<uint32_t>(offset >> STEP_SHIFT);
+  uint32_t fraction = static_cast<uint32_t>(offset) & STEP_MASK;
+  if (index == ENTRIES - 1) {
+    index--;
+    fraction = STEP_MASK + 1;
+  }
+
+  int64_t delta = static_cast<int64_t>(TABLE[index + 1] - TABLE[index]) * fraction;
+  return TABLE[index] + static_cast<int32_t>(delta >> STEP_SHIFT);
+}
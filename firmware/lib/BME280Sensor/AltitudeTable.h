@@ -0,0 +1,26 @@
+/*
+ * AltitudeTable.h
+ * Barometric altitude from a pressure ratio, without floating point pow()
+ */
+
+#ifndef ALTITUDE_TABLE_H
+#define ALTITUDE_TABLE_H
+
+#include <stdint.h>
+
+// Interpolates the international barometric formula,
+//   h = 44330 m * (1 - (p / p0)^0.1903),
+// from a table built at compile time over p / p0 in [0.5, 1.1] (about
+// 5500 m down to -800 m), in steps of 1/128. Within that range the result
+// is within 0.2 m of the formula; ratios outside it are clamped.
+class AltitudeTable {
+public:
+    static const uint32_t RATIO_SHIFT = 24;  // p / p0 in Q8.24
+    static const uint32_t STEP_SHIFT = 17;   // 1/128 in Q8.24
+    static const int ENTRIES = 78;
+
+    // Altitude in cm for a pressure and sea level pressure, both in Pa
+    static int32_t centimetres(uint32_t pressure, uint32_t seaLevelPressure);
+};
+
+#endif // ALTITUDE_TABLE_H
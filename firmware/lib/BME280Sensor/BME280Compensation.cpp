@@ -0,0 +1,95 @@
+#include "BME280Compensation.h"
+
+namespace {
+
+// Raw values the chip reports for a skipped measurement
+const int32_t SKIPPED_20BIT = 0x80000;
+const int32_t SKIPPED_16BIT = 0x8000;
+
+uint16_t le16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+int32_t raw20(const uint8_t *p) {
+  return (static_cast<int32_t>(p[0]) << 12) | (static_cast<int32_t>(p[1]) << 4) | (p[2] >> 4);
+}
+
+} // namespace
+
+BME280Calibration BME280Compensation::parseCalibration(const uint8_t *tp, const uint8_t *h) {
+  BME280Calibration c;
+  c.t1 = le16(tp + 0);
+  c.t2 = static_cast<int16_t>(le16(tp + 2));
+  c.t3 = static_cast<int16_t>(le16(tp + 4));
+  c.p1 = le16(tp + 6);
+  c.p2 = static_cast<int16_t>(le16(tp + 8));
+  c.p3 = static_cast<int16_t>(le16(tp + 10));
+  c.p4 = static_cast<int16_t>(le16(tp + 12));
+  c.p5 = static_cast<int16_t>(le16(tp + 14));
+  c.p6 = static_cast<int16_t>(le16(tp + 16));
+  c.p7 = static_cast<int16_t>(le16(tp + 18));
+  c.p8 = static_cast<int16_t>(le16(tp + 20));
+  c.p9 = static_cast<int16_t>(le16(tp + 22));
+  c.h1 = tp[25]; // 0xA1; 0xA0 is unused
+  c.h2 = static_cast<int16_t>(le16(h + 0));
+  c.h3 = h[2];
+  // H4 and H5 are signed 12-bit values sharing the nibbles of 0xE5
+  c.h4 = static_cast<int16_t>(static_cast<int8_t>(h[3]) * 16 | (h[4] & 0x0F));
+  c.h5 = static_cast<int16_t>(static_cast<int8_t>(h[5]) * 16 | (h[4] >> 4));
+  c.h6 = static_cast<int8_t>(h[6]);
+  return c;
+}
+
+// Left shifts of possibly negative values are written as multiplications;
+// right shifts stay arithmetic shifts, as in the datasheet.
+
+int32_t BME280Compensation::temperature(int32_t adcT) {
+  int32_t var1 = (((adcT >> 3) - (static_cast<int32_t>(_calib.t1) * 2)) * static_cast<int32_t>(_calib.t2)) >> 11;
+  int32_t delta = (adcT >> 4) - static_cast<int32_t>(_calib.t1);
+  int32_t var2 = (((delta * delta) >> 12) * static_cast<int32_t>(_calib.t3)) >> 14;
+  _tFine = var1 + var2;
+  return (_tFine * 5 + 128) >> 8;
+}
+
+uint32_t BME280Compensation::pressureQ24_8(int32_t adcP) {
+  int64_t var1 = static_cast<int64_t>(_tFine) - 128000;
+  int64_t var2 = var1 * var1 * _calib.p6;
+  var2 = var2 + var1 * _calib.p5 * (INT64_C(1) << 17);
+  var2 = var2 + static_cast<int64_t>(_calib.p4) * (INT64_C(1) << 35);
+  var1 = ((var1 * var1 * _calib.p3) >> 8) + var1 * _calib.p2 * (INT64_C(1) << 12);
+  var1 = ((INT64_C(1) << 47) + var1) * _calib.p1 >> 33;
+  if (var1 == 0) {
+    return 0; // Avoid division by zero
+  }
+
+  int64_t p = 1048576 - adcP;
+  p = ((p * (INT64_C(1) << 31) - var2) * 3125) / var1;
+  var1 = (static_cast<int64_t>(_calib.p9) * (p >> 13) * (p >> 13)) >> 25;
+  var2 = (static_cast<int64_t>(_calib.p8) * p) >> 19;
+  p = ((p + var1 + var2) >> 8) + static_cast<int64_t>(_calib.p7) * 16;
+  return static_cast<uint32_t>(p);
+}
+
+uint32_t BME280Compensation::humidityQ22_10(int32_t adcH) {
+  int32_t v = _tFine - 76800;
+  int32_t scaled = ((adcH * 16384) - (static_cast<int32_t>(_calib.h4) * 1048576) - (_calib.h5 * v) + 16384) >> 15;
+  int32_t gain =
+      ((((((v * _calib.h6) >> 10) * (((v * _calib.h3) >> 11) + 32768)) >> 10) + 2097152) * _calib.h2 + 8192) >> 14;
+  v = scaled * gain;
+  v = v - (((((v >> 15) * (v >> 15)) >> 7) * _calib.h1) >> 4);
+  v = v < 0 ? 0 : v;
+  v = v > 419430400 ? 419430400 : v;
+  return static_cast<uint32_t>(v >> 12);
+}
+
+bool BME280Compensation::compensate(const uint8_t *data, BME280Reading &reading) {
+  int32_t adcP = raw20(data);
+  int32_t adcT = raw20(data + 3);
+  int32_t adcH = (static_cast<int32_t>(data[6]) << 8) | data[7];
+  if (adcT == SKIPPED_20BIT || adcP == SKIPPED_20BIT || adcH == SKIPPED_16BIT) {
+    return false;
+  }
+
+  reading.temperature = temperature(adcT);
+  reading.pressure = (pressureQ24_8(adcP) + 128) >> 8;
+  reading.humidity = (humidityQ22_10(adcH) * 1000 + 512) >> 10;
+  return true;
+}
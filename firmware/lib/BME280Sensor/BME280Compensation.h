@@ -0,0 +1,78 @@
+/*
+ * BME280Compensation.h
+ * Integer-only BME280 compensation (datasheet 32/64-bit reference formulas)
+ */
+
+#ifndef BME280_COMPENSATION_H
+#define BME280_COMPENSATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Trimming parameters as stored in the chip's calibration registers
+struct BME280Calibration {
+    uint16_t t1;
+    int16_t t2;
+    int16_t t3;
+    uint16_t p1;
+    int16_t p2;
+    int16_t p3;
+    int16_t p4;
+    int16_t p5;
+    int16_t p6;
+    int16_t p7;
+    int16_t p8;
+    int16_t p9;
+    uint8_t h1;
+    int16_t h2;
+    uint8_t h3;
+    int16_t h4;
+    int16_t h5;
+    int8_t h6;
+};
+
+// One compensated measurement, in integer units
+struct BME280Reading {
+    int32_t temperature;  // 0.01 degC
+    uint32_t pressure;    // Pa
+    uint32_t humidity;    // 0.001 %RH
+};
+
+// The ESP32-C3 has no FPU, so this is the only compensation path on the
+// device: every step is the datasheet's integer arithmetic, and results stay
+// integers all the way into the payload.
+class BME280Compensation {
+public:
+    static const uint8_t REG_CALIB_TP = 0x88;    // T1..P9, 0x88..0x9F, then H1 at 0xA1
+    static const size_t CALIB_TP_LENGTH = 26;
+    static const uint8_t REG_CALIB_H = 0xE1;     // H2..H6, 0xE1..0xE7
+    static const size_t CALIB_H_LENGTH = 7;
+    static const uint8_t REG_DATA = 0xF7;        // press, temp, hum, 0xF7..0xFE
+    static const size_t DATA_LENGTH = 8;
+
+    BME280Compensation() : _calib(), _tFine(0) {}
+    explicit BME280Compensation(const BME280Calibration& calibration) : _calib(calibration), _tFine(0) {}
+
+    // Unpack the two calibration register blocks read from the chip
+    static BME280Calibration parseCalibration(const uint8_t* tp, const uint8_t* h);
+
+    void setCalibration(const BME280Calibration& calibration) { _calib = calibration; }
+    const BME280Calibration& calibration() const { return _calib; }
+
+    // Datasheet reference functions. temperature() must run first: it sets
+    // t_fine, which pressure and humidity compensation depend on.
+    int32_t temperature(int32_t adcT);        // 0.01 degC
+    uint32_t pressureQ24_8(int32_t adcP);     // Pa, Q24.8
+    uint32_t humidityQ22_10(int32_t adcH);    // %RH, Q22.10
+    int32_t tFine() const { return _tFine; }
+
+    // Compensate a raw data block (DATA_LENGTH bytes from REG_DATA). Fails on
+    // the values the chip reports for a skipped measurement.
+    bool compensate(const uint8_t* data, BME280Reading& reading);
+
+private:
+    BME280Calibration _calib;
+    int32_t _tFine;
+};
+
+#endif // BME280_COMPENSATION_H
@@ -1,12 +1,98 @@
 #include "BME280Sensor.h"
 
+namespace {
+
+const uint8_t MODE_FORCED = 0x01;
+const uint8_t OSRS_X16 = 5;
+
+// Register code for an oversampling factor, rounding down: 1 -> 1 ... 16 -> 5
+uint8_t oversamplingCode(uint8_t factor) {
+  uint8_t code = 1;
+  while (code < OSRS_X16 && (1u << code) <= factor) {
+    code++;
+  }
+  return code;
+}
+
+uint32_t oversamplingFactor(uint8_t code) { return code == 0 ? 0 : 1u << (code - 1); }
+
+int32_t divideRounded(int64_t sum, int32_t count) {
+  return static_cast<int32_t>(sum >= 0 ? (sum + count / 2) / count : (sum - count / 2) / count);
+}
+
+// Sorts values in place (bursts are at most MAX_BURST long)
+int32_t reduce(int32_t *values, uint8_t count, BME280Sensor::BurstFilter filter, int32_t &spread) {
+  for (uint8_t i = 1; i < count; i++) {
+    int32_t value = values[i];
+    uint8_t j = i;
+    for (; j > 0 && values[j - 1] > value; j--) {
+      values[j] = values[j - 1];
+    }
+    values[j] = value;
+  }
+  spread = values[count - 1] - values[0];
+
+  if (filter == BME280Sensor::BURST_TRIMMED_MEAN) {
+    uint8_t trim = count / 4;
+    if (trim == 0 && count >= 3) {
+      trim = 1;
+    }
+    int64_t sum = 0;
+    for (uint8_t i = trim; i < count - trim; i++) {
+      sum += values[i];
+    }
+    return divideRounded(sum, count - 2 * trim);
+  }
+  if (count % 2 == 0) {
+    return divideRounded(static_cast<int64_t>(values[count / 2 - 1]) + values[count / 2], 2);
+  }
+  return values[count / 2];
+}
+
+} // namespace
+
 BME280Sensor::BME280Sensor(uint8_t address, int8_t sda, int8_t scl, float seaLevelPressure)
-    : _address(address), _sda(sda), _scl(scl), _seaLevelPressure(seaLevelPressure), _available(false) {
+    : _address(address), _sda(sda), _scl(scl), _seaLevelPressure(seaLevelPressure),
+      _seaLevelPa(static_cast<uint32_t>(seaLevelPressure * 100.0f + 0.5f)), _clockHz(DEFAULT_CLOCK_HZ),
+      _timeoutMs(DEFAULT_TIMEOUT_MS), _retries(DEFAULT_RETRIES), _osrsT(oversamplingCode(2)),
+      _osrsP(oversamplingCode(16)), _osrsH(oversamplingCode(1)), _burst(1), _filter(BURST_MEDIAN),
+      _altitudeEnabled(true), _available(false), _converting(false) {
   _lastError[0] = '\0';
 }
 
+void BME280Sensor::setBus(uint32_t clockHz, uint16_t timeoutMs, uint8_t retries) {
+  _clockHz = clockHz;
+  _timeoutMs = timeoutMs;
+  _retries = retries;
+}
+
+void BME280Sensor::setOversampling(uint8_t temperature, uint8_t pressure, uint8_t humidity) {
+  _osrsT = oversamplingCode(temperature);
+  _osrsP = oversamplingCode(pressure);
+  _osrsH = oversamplingCode(humidity);
+}
+
+void BME280Sensor::setBurst(uint8_t samples, BurstFilter filter) {
+  _burst = samples < 1 ? 1 : (samples > MAX_BURST ? MAX_BURST : samples);
+  _filter = filter;
+}
+
+uint32_t BME280Sensor::conversionTimeMs() const {
+  // Datasheet 9.1, maximum measurement time in us
+  uint32_t micros = 1250 + 2300 * oversamplingFactor(_osrsT);
+  if (_osrsP != 0) {
+    micros += 2300 * oversamplingFactor(_osrsP) + 575;
+  }
+  if (_osrsH != 0) {
+    micros += 2300 * oversamplingFactor(_osrsH) + 575;
+  }
+  return (micros + 999) / 1000;
+}
+
 bool BME280Sensor::begin() {
   Wire.begin(_sda, _scl);
+  Wire.setClock(_clockHz);
+  Wire.setTimeOut(_timeoutMs);
 
   if (!_bme.begin(_address)) {
     snprintf(_lastError, sizeof(_lastError), "Could not find BME280 sensor at address 0x%02X (SDA: %d, SCL: %d)",
@@ -18,22 +104,162 @@ bool BME280Sensor::begin() {
     return false;
   }
 
+  if (!readCalibration()) {
+    snprintf(_lastError, sizeof(_lastError), "Could not read BME280 calibration at address 0x%02X", _address);
+    return false;
+  }
+
   _available = true;
   return true;
 }
 
 bool BME280Sensor::configureSensor() {
-  // Configure sensor for weather monitoring
-  _bme.setSampling(Adafruit_BME280::MODE_NORMAL,     // Operating Mode
-                   Adafruit_BME280::SAMPLING_X2,     // Temperature
-                   Adafruit_BME280::SAMPLING_X16,    // Pressure
-                   Adafruit_BME280::SAMPLING_X1,     // Humidity
-                   Adafruit_BME280::FILTER_X16,      // Filtering
-                   Adafruit_BME280::STANDBY_MS_500); // Standby time
+  // Sleep until triggered: the IIR filter would not converge between wakes,
+  // bursts of forced conversions are filtered in collect() instead
+  _bme.setSampling(Adafruit_BME280::MODE_SLEEP,
+                   static_cast<Adafruit_BME280::sensor_sampling>(_osrsT),
+                   static_cast<Adafruit_BME280::sensor_sampling>(_osrsP),
+                   static_cast<Adafruit_BME280::sensor_sampling>(_osrsH),
+                   Adafruit_BME280::FILTER_OFF,
+                   Adafruit_BME280::STANDBY_MS_0_5);
 
   return true;
 }
 
+bool BME280Sensor::readCalibration() {
+  uint8_t tp[BME280Compensation::CALIB_TP_LENGTH];
+  uint8_t h[BME280Compensation::CALIB_H_LENGTH];
+  if (!readRegisters(BME280Compensation::REG_CALIB_TP, tp, sizeof(tp)) ||
+      !readRegisters(BME280Compensation::REG_CALIB_H, h, sizeof(h))) {
+    return false;
+  }
+  _compensation.setCalibration(BME280Compensation::parseCalibration(tp, h));
+  return true;
+}
+
+bool BME280Sensor::readRegisters(uint8_t reg, uint8_t *buffer, size_t length) {
+  for (uint8_t attempt = 0; attempt <= _retries; attempt++) {
+    if (readRegistersOnce(reg, buffer, length)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool BME280Sensor::readRegistersOnce(uint8_t reg, uint8_t *buffer, size_t length) {
+  Wire.beginTransmission(_address);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0) {
+    return false;
+  }
+  if (Wire.requestFrom(static_cast<uint16_t>(_address), length, true) != length) {
+    return false;
+  }
+  for (size_t i = 0; i < length; i++) {
+    buffer[i] = static_cast<uint8_t>(Wire.read());
+  }
+  return true;
+}
+
+bool BME280Sensor::writeRegister(uint8_t reg, uint8_t value) {
+  for (uint8_t attempt = 0; attempt <= _retries; attempt++) {
+    Wire.beginTransmission(_address);
+    Wire.write(reg);
+    Wire.write(value);
+    if (Wire.endTransmission() == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool BME280Sensor::startConversion() {
+  if (!_available) {
+    updateLastError("Sensor not available");
+    return false;
+  }
+  // ctrl_hum only takes effect with the following write to ctrl_meas
+  if (!writeRegister(REG_CTRL_HUM, _osrsH) ||
+      !writeRegister(REG_CTRL_MEAS, static_cast<uint8_t>(_osrsT << 5 | _osrsP << 2 | MODE_FORCED))) {
+    updateLastError("I2C write failed");
+    return false;
+  }
+  return true;
+}
+
+uint32_t BME280Sensor::trigger() {
+  _converting = startConversion();
+  return _converting ? conversionTimeMs() : 0;
+}
+
+bool BME280Sensor::read(BME280Reading &reading) {
+  if (!_available) {
+    updateLastError("Sensor not available");
+    return false;
+  }
+
+  // Burst read from 0xF7 so that all measurements come from the same cycle
+  uint8_t data[BME280Compensation::DATA_LENGTH];
+  if (!readRegisters(BME280Compensation::REG_DATA, data, sizeof(data))) {
+    updateLastError("I2C read failed");
+    return false;
+  }
+  if (!_compensation.compensate(data, reading)) {
+    updateLastError("Measurement skipped");
+    return false;
+  }
+  return true;
+}
+
+int32_t BME280Sensor::altitude(uint32_t pressure) const {
+  return AltitudeTable::centimetres(pressure, _seaLevelPa);
+}
+
+bool BME280Sensor::collect(Measurements &out) {
+  // Without a trigger() (or after a failed one), convert here
+  bool pending = _converting;
+  _converting = false;
+
+  int32_t temperature[MAX_BURST];
+  int32_t humidity[MAX_BURST];
+  int32_t pressure[MAX_BURST];
+  for (uint8_t i = 0; i < _burst; i++) {
+    if (i > 0 || !pending) {
+      if (!startConversion()) {
+        return false;
+      }
+      delay(conversionTimeMs());
+    }
+    BME280Reading reading;
+    if (!read(reading)) {
+      return false;
+    }
+    temperature[i] = reading.temperature;
+    humidity[i] = static_cast<int32_t>(reading.humidity);
+    pressure[i] = static_cast<int32_t>(reading.pressure);
+  }
+
+  int32_t spreadT, spreadH, spreadP;
+  int32_t valueT = reduce(temperature, _burst, _filter, spreadT);
+  int32_t valueH = reduce(humidity, _burst, _filter, spreadH);
+  int32_t valueP = reduce(pressure, _burst, _filter, spreadP);
+
+  bool added = out.add(CHANNEL_TEMPERATURE, valueT) && out.add(CHANNEL_HUMIDITY, valueH) &&
+               out.add(CHANNEL_PRESSURE, valueP);
+  if (added && _altitudeEnabled) {
+    added = out.add(CHANNEL_ALTITUDE, altitude(static_cast<uint32_t>(valueP)));
+  }
+  if (added && _burst > 1) {
+    added = out.add(CHANNEL_TEMPERATURE, spreadT, STAT_SPREAD) && out.add(CHANNEL_HUMIDITY, spreadH, STAT_SPREAD) &&
+            out.add(CHANNEL_PRESSURE, spreadP, STAT_SPREAD);
+  }
+  if (!added) {
+    updateLastError("Too many measurements");
+    return false;
+  }
+  return true;
+}
+
 float BME280Sensor::getTemperature() const {
   if (!_available) {
     updateLastError("Sensor not available");
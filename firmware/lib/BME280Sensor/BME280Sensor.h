@@ -8,12 +8,25 @@
 
 #include <Wire.h>
 #include <Adafruit_BME280.h>
+#include "AltitudeTable.h"
+#include "BME280Compensation.h"
+#include "ISensor.h"
 
-class BME280Sensor {
+class BME280Sensor : public ISensor {
 public:
     static constexpr uint8_t DEFAULT_ADDRESS = 0x77;
     static constexpr int8_t DEFAULT_SDA = 6;
     static constexpr int8_t DEFAULT_SCL = 7;
+    static constexpr uint32_t DEFAULT_CLOCK_HZ = 100000;  // Wire's own defaults
+    static constexpr uint16_t DEFAULT_TIMEOUT_MS = 50;
+    static constexpr uint8_t DEFAULT_RETRIES = 0;
+    static constexpr uint8_t MAX_BURST = 9;
+
+    // How the conversions of a burst are reduced to one value per channel
+    enum BurstFilter : uint8_t {
+        BURST_MEDIAN = 0,
+        BURST_TRIMMED_MEAN  // Mean without the lowest and highest quarter
+    };
 
     // Constructor takes I2C configuration and sea level pressure
     BME280Sensor(uint8_t address = DEFAULT_ADDRESS,
@@ -21,25 +34,82 @@ public:
                  int8_t scl = DEFAULT_SCL,
                  float seaLevelPressure = 1013.25f);
     
-    bool begin();
+    // I2C bus timing, applied by begin(): clock in Hz (100 kHz standard mode,
+    // 400 kHz fast mode, 1 MHz fast mode plus), timeout per transfer, and how
+    // many times a failed transfer is retried. A stuck bus then fails a read
+    // after (retries + 1) timeouts instead of stalling the wake cycle.
+    void setBus(uint32_t clockHz, uint16_t timeoutMs, uint8_t retries);
+    uint32_t getClock() const { return _clockHz; }
+
+    // Oversampling factor per channel: 1, 2, 4, 8 or 16 (others round down).
+    // Higher factors lower the noise of each conversion but lengthen it, see
+    // conversionTimeMs().
+    void setOversampling(uint8_t temperature, uint8_t pressure, uint8_t humidity);
+    // Forced conversions per reading (1 to MAX_BURST) and how they are
+    // combined. A burst of more than one also reports the spread of each
+    // channel (highest minus lowest conversion) as STAT_SPREAD.
+    void setBurst(uint8_t samples, BurstFilter filter);
+    uint8_t getBurst() const { return _burst; }
+    // Datasheet maximum for one forced conversion at the current oversampling
+    uint32_t conversionTimeMs() const;
+
+    // Report altitude as well as temperature, humidity and pressure
+    void setAltitudeEnabled(bool enabled) { _altitudeEnabled = enabled; }
+
+    const char* getName() const override { return "BME280"; }
+    bool begin() override;
     bool isAvailable() const { return _available; }
+
+    // The sensor sleeps between readings: trigger() starts the first forced
+    // conversion of a burst, collect() runs the rest and filters them
+    uint32_t trigger() override;
+    bool collect(Measurements& out) override;
+
+    // Read all three measurements of the last conversion in one burst and
+    // compensate them with integer arithmetic only
+    bool read(BME280Reading& reading);
+    // Altitude in cm for a pressure in Pa, against the configured sea level
+    // pressure (table interpolation, see AltitudeTable)
+    int32_t altitude(uint32_t pressure) const;
+
+    // Floating point readings through the Adafruit driver, one bus transfer each
     float getTemperature() const;
     float getPressure() const;
     float getHumidity() const;
     float getAltitude() const;
-    const char* getLastError() const { return _lastError; }
+    const char* getLastError() const override { return _lastError; }
 
 private:
+    static constexpr uint8_t REG_CTRL_HUM = 0xF2;
+    static constexpr uint8_t REG_CTRL_MEAS = 0xF4;
+
     Adafruit_BME280 _bme;
+    BME280Compensation _compensation;
     uint8_t _address;
     int8_t _sda;
     int8_t _scl;
     float _seaLevelPressure;
+    uint32_t _seaLevelPa;
+    uint32_t _clockHz;
+    uint16_t _timeoutMs;
+    uint8_t _retries;
+    uint8_t _osrsT;  // Oversampling register codes
+    uint8_t _osrsP;
+    uint8_t _osrsH;
+    uint8_t _burst;
+    BurstFilter _filter;
+    bool _altitudeEnabled;
     bool _available;
+    bool _converting;  // trigger() started a conversion that collect() has not read
     mutable char _lastError[128];  // Allow modification in const methods
     
     void updateLastError(const char* error) const;  // Make const
     bool configureSensor();
+    bool readCalibration();
+    bool readRegisters(uint8_t reg, uint8_t* buffer, size_t length);
+    bool readRegistersOnce(uint8_t reg, uint8_t* buffer, size_t length);
+    bool writeRegister(uint8_t reg, uint8_t value);
+    bool startConversion();
 };
 
 #endif // BME280_SENSOR_H 
\ No newline at end of file
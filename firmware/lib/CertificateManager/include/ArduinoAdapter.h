@@ -1,6 +1,7 @@
 #ifndef ARDUINO_ADAPTER_H
 #define ARDUINO_ADAPTER_H
 
+#include "EventLog.h"
 #include "IArduino.h"
 #include <Arduino.h>
 #include <stdarg.h>
@@ -16,17 +17,33 @@ public:
         ::delay(ms);
     }
 
-    void log(const char* message) override {
+    // CertificateManager filters its messages against LOG_LEVEL itself; they
+    // are kept as text records at their level, so that errors and warnings
+    // count towards uploading the event log
+    void log(uint8_t level, const char* message) override {
+#if LOG_LEVEL > LOG_LEVEL_NONE
+        EventLog::text(level, message);
+#ifdef LOG_SERIAL
         Serial.println(message);
+#endif
+#else
+        (void)level;
+        (void)message;
+#endif
     }
 
-    void logf(const char* format, ...) override {
+    void logf(uint8_t level, const char* format, ...) override {
+#if LOG_LEVEL > LOG_LEVEL_NONE
         va_list args;
         va_start(args, format);
-        char buffer[256];
+        char buffer[EventLog::MAX_TEXT + 1];
         vsnprintf(buffer, sizeof(buffer), format, args);
         va_end(args);
-        Serial.println(buffer);
+        log(level, buffer);
+#else
+        (void)level;
+        (void)format;
+#endif
     }
 
     void restart() override {
@@ -6,6 +6,7 @@
 #include "IWebServer.h"
 #include "IWiFi.h"
 #include "IArduino.h"
+#include "TlsCredentials.h"
 
 // Forward declaration
 class WiFiManager;
@@ -28,8 +29,13 @@ public:
 
     // Loading & Validation
     bool loadCertificates(IWiFiClient& client);
+    const TlsCredentials* getCredentials();  // Parsed once, then shared by every handshake
     bool validateCertificates();
 
+    // PEM format checks: BEGIN/END markers only, no parsing
+    static bool validateCertificateFormat(const char* certPem);
+    static bool validatePrivateKeyFormat(const char* keyPem);
+
     // Provisioning
     bool startProvisioningMode(IWebServer* webServer);
     void stopProvisioningMode();
@@ -37,6 +43,8 @@ public:
     void handleProvisioningLoop();  // Must be called repeatedly to service HTTP requests
 
     // Storage Management
+    // Read the stored certificates with one NVS lookup; allocates nothing
+    bool loadFromNVS();
     bool storeCertificates(const char* certPem, const char* keyPem, const char* caCertPem = nullptr);
     bool clearCertificates();
 
@@ -63,22 +71,48 @@ private:
     IWebServer* _provisioningServer;
     WiFiManager* _wifiManager;
 
-    // Certificate storage buffers
+    // Everything the station keeps in NVS, read and written as one blob
+    // instead of a key per field: a warm boot loads it with a single NVS
+    // lookup. The PEMs are packed NUL-terminated into data, so only the used
+    // part is stored, and are used from there: loading allocates nothing, so
+    // it cannot fragment the heap ahead of the TLS handshake. The pointers
+    // point into data, or are nullptr when their part is absent.
+    static const uint32_t RECORD_MAGIC = 0x43525431;  // "CRT1"
+    static const uint16_t RECORD_LAYOUT = 1;          // Bump when the fields change
+
+    struct Record {
+        uint32_t magic;
+        uint32_t crc;          // CRC-32 of the rest of the stored blob
+        uint16_t layout;
+        uint16_t certLength;   // PEM lengths, without their NULs
+        uint16_t keyLength;
+        uint16_t caLength;     // 0: no CA certificate
+        uint32_t expiresAt;
+        int32_t certVersion;
+        char cn[MAX_CN_LENGTH];
+        char data[2 * MAX_CERT_SIZE + MAX_KEY_SIZE];
+    };
+    Record _record;
     char* _clientCert;
     char* _clientKey;
     char* _caCert;
+    TlsCredentials _credentials;
 
     // Certificate parsing
     bool extractCNFromCert(const char* certPem);
     bool extractExpirationFromCert(const char* certPem);
-    bool validateCertificateFormat(const char* certPem);
-    bool validatePrivateKeyFormat(const char* keyPem);
     bool validateCertKeyPair(const char* certPem, const char* keyPem);
     void logCertificateInfo(const char* certPem);
 
     // NVS operations
-    bool loadFromNVS();
-    bool saveToNVS(const char* certPem, const char* keyPem, const char* caCertPem);
+    bool openNVS(bool readOnly);
+    bool saveToNVS();
+    bool useRecord(size_t length);
+    bool migrateLegacyKeys();
+    // Length of a legacy string key read into buffer, 0 if missing or too long
+    size_t readLegacyString(const char* key, char* buffer, size_t size);
+    size_t recordLength() const;
+    uint32_t recordCrc() const;
 
     // Provisioning server
     void setupProvisioningServer();
@@ -88,6 +122,8 @@ private:
 
     // Utilities
     void setError(const char* error);
+    void releaseCertificates();
+    void pointIntoRecord();
     const char* getLastMACOctet();
 };
 
@@ -12,9 +12,9 @@ public:
     virtual unsigned long millis() = 0;
     virtual void delay(unsigned long ms) = 0;
 
-    // Serial/logging functions
-    virtual void log(const char* message) = 0;
-    virtual void logf(const char* format, ...) = 0;
+    // Serial/logging functions; level is one of the LOG_LEVEL_* of LogLevel.h
+    virtual void log(uint8_t level, const char* message) = 0;
+    virtual void logf(uint8_t level, const char* format, ...) = 0;
 
     // System functions
     virtual void restart() = 0;
@@ -1,12 +1,19 @@
 #ifndef I_WIFI_CLIENT_H
 #define I_WIFI_CLIENT_H
 
+class TlsCredentials;
+
 class IWiFiClient {
 public:
     virtual ~IWiFiClient() {}
     virtual void setCACert(const char* rootCA) = 0;
     virtual void setCertificate(const char* client_ca) = 0;
     virtual void setPrivateKey(const char* private_key) = 0;
+
+    // Clients that can borrow parsed credentials (reused by every handshake)
+    // override these; others are handed the PEM strings above.
+    virtual bool supportsCredentials() const { return false; }
+    virtual void setCredentials(const TlsCredentials& credentials) { (void)credentials; }
 };
 
 #endif // I_WIFI_CLIENT_H
@@ -0,0 +1,21 @@
+#ifndef TLS_BACKEND_H
+#define TLS_BACKEND_H
+
+// Which parts of the TLS stack run on real mbedTLS.
+//
+// On the device everything does. On the host, NATIVE_MBEDTLS links the host's
+// mbedTLS for certificate and key parsing (X509Parser, TlsCredentials), which
+// unit tests use by default. NATIVE_TLS additionally runs SecureClient's
+// handshake and record layer, which needs a TLS peer such as MockTlsServer;
+// without it, SecureClient is a plain pass-through to the mock broker.
+// Building with neither selects string-matching stand-ins throughout.
+
+#if !defined(UNIT_TEST) || defined(NATIVE_MBEDTLS) || defined(NATIVE_TLS)
+#define TLS_USE_MBEDTLS
+#endif
+
+#if !defined(UNIT_TEST) || defined(NATIVE_TLS)
+#define TLS_USE_MBEDTLS_TRANSPORT
+#endif
+
+#endif // TLS_BACKEND_H
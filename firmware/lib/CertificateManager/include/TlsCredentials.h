@@ -0,0 +1,64 @@
+#ifndef TLS_CREDENTIALS_H
+#define TLS_CREDENTIALS_H
+
+#include <stddef.h>
+#include "TlsBackend.h"
+
+#ifdef TLS_USE_MBEDTLS
+#include <mbedtls/pk.h>
+#include <mbedtls/x509_crt.h>
+#endif
+
+/**
+ * @brief Parsed client certificate, private key and CA chain
+ *
+ * Parsing PEM into mbedTLS contexts is a large part of a TLS handshake's
+ * cost. A TlsCredentials handle is parsed once and then borrowed by every
+ * handshake of the wake, so reconnects skip the PEM and ASN.1 work entirely.
+ */
+class TlsCredentials {
+public:
+    TlsCredentials();
+    ~TlsCredentials();
+
+    /**
+     * @brief Parse PEM-encoded credentials, replacing any previous ones
+     *
+     * @param certPem PEM-encoded client certificate
+     * @param keyPem PEM-encoded private key (unencrypted)
+     * @param caPem PEM-encoded CA certificate, or nullptr to skip server verification
+     * @return true if everything parsed, false otherwise (the handle is left empty)
+     */
+    bool load(const char* certPem, const char* keyPem, const char* caPem);
+
+    void clear();
+
+    bool isLoaded() const { return _loaded; }
+    bool hasCA() const { return _hasCA; }
+
+    // Number of times PEM input has been parsed, for tests and benchmarks
+    int getParseCount() const { return _parseCount; }
+
+#ifdef TLS_USE_MBEDTLS
+    mbedtls_x509_crt* certificate() const { return &_cert; }
+    mbedtls_pk_context* privateKey() const { return &_key; }
+    mbedtls_x509_crt* caChain() const { return _hasCA ? &_ca : nullptr; }
+#endif
+
+private:
+    bool _loaded;
+    bool _hasCA;
+    int _parseCount;
+
+#ifdef TLS_USE_MBEDTLS
+    // mbedTLS takes non-const pointers even where it only reads
+    mutable mbedtls_x509_crt _cert;
+    mutable mbedtls_pk_context _key;
+    mutable mbedtls_x509_crt _ca;
+#endif
+
+    TlsCredentials(const TlsCredentials&);
+    TlsCredentials& operator=(const TlsCredentials&);
+};
+
+#endif // TLS_CREDENTIALS_H
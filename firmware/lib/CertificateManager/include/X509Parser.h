@@ -3,6 +3,11 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "TlsBackend.h"
+
+#ifdef TLS_USE_MBEDTLS
+#include <mbedtls/pk.h>
+#endif
 
 /**
  * @brief Lightweight X.509 certificate parser for ESP32
@@ -48,7 +53,7 @@ public:
      * @brief Verify that a private key matches a certificate's public key
      *
      * This performs cryptographic verification that the private key and
-     * certificate form a valid pair.
+     * certificate form a valid pair. RSA and EC (e.g. P-256) keys are supported.
      *
      * @param certPem PEM-encoded certificate string
      * @param keyPem PEM-encoded private key string
@@ -71,6 +76,13 @@ private:
      * @brief Convert mbedTLS time structure to Unix epoch seconds
      */
     static unsigned long timeToEpoch(int year, int month, int day, int hour, int min, int sec);
+
+#ifdef TLS_USE_MBEDTLS
+    /**
+     * @brief Map ECDSA-only keys to generic EC keys so that P-256 pairs compare equal
+     */
+    static mbedtls_pk_type_t normalizeKeyType(mbedtls_pk_type_t type);
+#endif
 };
 
 #endif // X509_PARSER_H
@@ -1,7 +1,10 @@
 #include "CertificateManager.h"
+#include "Crc32.h"
+#include "LogLevel.h"
 #include "X509Parser.h"
 
 #include <ArduinoJson.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -15,43 +18,60 @@ class WiFiManager;
 
 static const int SECONDS_PER_DAY = 24 * 60 * 60;
 
+// Messages above the build's LOG_LEVEL are compiled out, string literals and
+// formatting included; the rest go to IArduino::logf with their level
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define CM_LOG_ERROR(...) _arduino->logf(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define CM_LOG_ERROR(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define CM_LOG_WARN(...) _arduino->logf(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define CM_LOG_WARN(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define CM_LOG_INFO(...) _arduino->logf(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define CM_LOG_INFO(...) ((void)0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define CM_LOG_DEBUG(...) _arduino->logf(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define CM_LOG_DEBUG(...) ((void)0)
+#endif
+
 CertificateManager::CertificateManager(Preferences &prefs, IWiFi *wifi, IArduino *arduino)
     : _prefs(prefs), _wifi(wifi), _arduino(arduino), _expiresAt(0), _certVersion(0), _provisioningActive(false),
-      _provisioningStartTime(0), _provisioningServer(nullptr), _wifiManager(nullptr), _clientCert(nullptr),
-      _clientKey(nullptr), _caCert(nullptr) {
+      _provisioningStartTime(0), _provisioningServer(nullptr), _wifiManager(nullptr), _record(),
+      _clientCert(nullptr), _clientKey(nullptr), _caCert(nullptr) {
   _lastError[0] = '\0';
   _cn[0] = '\0';
 }
 
-CertificateManager::~CertificateManager() {
-  stopProvisioningMode();
-  if (_clientCert)
-    free(_clientCert);
-  if (_clientKey)
-    free(_clientKey);
-  if (_caCert)
-    free(_caCert);
-}
+CertificateManager::~CertificateManager() { stopProvisioningMode(); }
 
 bool CertificateManager::begin() {
-  _arduino->log("CertificateManager: Initializing...");
+  CM_LOG_INFO("CertificateManager: Initializing...");
 
-  // Initialize NVS
-  if (!_prefs.begin("tarameteo_certs", false)) {
-    setError("Failed to initialize NVS");
+  // Read-only until something is written. The namespace only exists once
+  // certificates have been stored, so failing to open it means provisioning
+  if (!openNVS(true)) {
+    setError("Certificates not found in NVS");
+    CM_LOG_INFO("CertificateManager: Certificates not found - provisioning needed");
     return false;
   }
 
   // Try to load existing certificates
   if (loadFromNVS()) {
-    _arduino->log("CertificateManager: Certificates loaded from NVS");
+    CM_LOG_INFO("CertificateManager: Certificates loaded from NVS");
 
     // Validate loaded certificates
     if (validateCertificates()) {
-      _arduino->log("CertificateManager: Certificates validated successfully");
+      CM_LOG_INFO("CertificateManager: Certificates validated successfully");
       return true;
     } else {
-      _arduino->log("CertificateManager: Certificate validation failed");
+      CM_LOG_ERROR("CertificateManager: Certificate validation failed");
       // Don't return false - allow provisioning to proceed
     }
   }
@@ -59,7 +79,7 @@ bool CertificateManager::begin() {
   // No certificates found or invalid - will need provisioning
   // But don't start it here - let the main code handle it
   if (needsProvisioning()) {
-    _arduino->log("CertificateManager: Certificates not found - provisioning needed");
+    CM_LOG_INFO("CertificateManager: Certificates not found - provisioning needed");
     return false;
   }
 
@@ -70,73 +90,134 @@ bool CertificateManager::isProvisioned() const { return (_clientCert != nullptr
 
 bool CertificateManager::needsProvisioning() const { return !isProvisioned(); }
 
+// Key of the certificate record; the per-field keys it replaced are read
+// once, to migrate stations provisioned before it existed
+static const char *const RECORD_KEY = "cert_record";
+static const char *const LEGACY_KEYS[] = {"cli_cert", "cli_key", "ca_cert", "cert_cn", "cert_expires", "cert_version"};
+
 bool CertificateManager::loadFromNVS() {
+  releaseCertificates();
+
+  size_t length = _prefs.getBytes(RECORD_KEY, &_record, sizeof(_record));
+  if (length > 0) {
+    return useRecord(length);
+  }
+
   if (!_prefs.isKey("cli_cert") || !_prefs.isKey("cli_key")) {
     setError("Certificates not found in NVS");
     return false;
   }
+  return migrateLegacyKeys();
+}
 
-  _clientCert = (char *)malloc(MAX_CERT_SIZE);
-  _clientKey = (char *)malloc(MAX_KEY_SIZE);
-  if (!_clientCert || !_clientKey) {
-    setError("Failed to allocate memory for certificates");
+bool CertificateManager::useRecord(size_t length) {
+  if (length < offsetof(Record, data) || _record.magic != RECORD_MAGIC || _record.layout != RECORD_LAYOUT ||
+      _record.certLength == 0 || _record.certLength >= MAX_CERT_SIZE || _record.keyLength == 0 ||
+      _record.keyLength >= MAX_KEY_SIZE || _record.caLength >= MAX_CERT_SIZE || length != recordLength() ||
+      _record.crc != recordCrc()) {
+    setError("Certificate record in NVS is corrupted");
     return false;
   }
 
-  size_t certLen = _prefs.getString("cli_cert", _clientCert, MAX_CERT_SIZE);
+  pointIntoRecord();
+  if (_clientCert[_record.certLength] != '\0' || _clientKey[_record.keyLength] != '\0' ||
+      (_caCert && _caCert[_record.caLength] != '\0')) {
+    releaseCertificates();
+    setError("Certificate record in NVS is corrupted");
+    return false;
+  }
+
+  memcpy(_cn, _record.cn, MAX_CN_LENGTH);
+  _cn[MAX_CN_LENGTH - 1] = '\0';
+  _expiresAt = _record.expiresAt;
+  _certVersion = _record.certVersion;
+
+  CM_LOG_INFO("CertificateManager: Loaded cert CN=%s, expires=%lu, version=%d", _cn, _expiresAt, _certVersion);
+
+  return true;
+}
+
+bool CertificateManager::migrateLegacyKeys() {
+  CM_LOG_INFO("CertificateManager: Migrating certificates to a single NVS record");
+
+  // Read the PEMs straight into their packed places. getString() reads
+  // nothing when a value does not fit, and otherwise returns its size with
+  // the terminating NUL: the lengths come from the strings themselves
+  char *cert = _record.data;
+  size_t certLen = readLegacyString("cli_cert", cert, MAX_CERT_SIZE);
   if (certLen == 0) {
     setError("Failed to read client certificate from NVS");
     return false;
   }
 
-  size_t keyLen = _prefs.getString("cli_key", _clientKey, MAX_KEY_SIZE);
+  char *key = cert + certLen + 1;
+  size_t keyLen = readLegacyString("cli_key", key, MAX_KEY_SIZE);
   if (keyLen == 0) {
     setError("Failed to read client key from NVS");
     return false;
   }
 
+  size_t caLen = 0;
   if (_prefs.isKey("ca_cert")) {
-    _caCert = (char *)malloc(MAX_CERT_SIZE);
-    if (_caCert) {
-      size_t caLen = _prefs.getString("ca_cert", _caCert, MAX_CERT_SIZE);
-      if (caLen == 0) {
-        free(_caCert);
-        _caCert = nullptr;
-      }
+    caLen = readLegacyString("ca_cert", key + keyLen + 1, MAX_CERT_SIZE);
+    if (caLen == 0) {
+      CM_LOG_WARN("CertificateManager: WARNING - Failed to read CA cert from NVS, server validation disabled");
     }
   }
 
+  _record.certLength = static_cast<uint16_t>(certLen);
+  _record.keyLength = static_cast<uint16_t>(keyLen);
+  _record.caLength = static_cast<uint16_t>(caLen);
+  pointIntoRecord();
+
   _prefs.getString("cert_cn", _cn, MAX_CN_LENGTH);
   _expiresAt = _prefs.getULong("cert_expires", 0);
   _certVersion = _prefs.getInt("cert_version", 0);
 
-  _arduino->logf("CertificateManager: Loaded cert CN=%s, expires=%lu, version=%d", _cn, _expiresAt, _certVersion);
+  // The certificates are usable either way; the old keys go only once the
+  // record holding them is written
+  if (saveToNVS()) {
+    for (size_t i = 0; i < sizeof(LEGACY_KEYS) / sizeof(LEGACY_KEYS[0]); i++) {
+      _prefs.remove(LEGACY_KEYS[i]);
+    }
+  }
+
+  CM_LOG_INFO("CertificateManager: Loaded cert CN=%s, expires=%lu, version=%d", _cn, _expiresAt, _certVersion);
 
   return true;
 }
 
-bool CertificateManager::saveToNVS(const char *certPem, const char *keyPem, const char *caCertPem) {
-  _arduino->log("CertificateManager: Saving certificates to NVS");
-
-  if (_prefs.putString("cli_cert", certPem) == 0) {
-    setError("Failed to save client certificate");
-    return false;
+size_t CertificateManager::readLegacyString(const char *key, char *buffer, size_t size) {
+  if (_prefs.getString(key, buffer, size) == 0) {
+    return 0;
   }
+  size_t length = strnlen(buffer, size);
+  return length < size ? length : 0;
+}
 
-  if (_prefs.putString("cli_key", keyPem) == 0) {
-    setError("Failed to save client key");
+bool CertificateManager::saveToNVS() {
+  CM_LOG_INFO("CertificateManager: Saving certificates to NVS");
+
+  if (!openNVS(false)) {
+    setError("Failed to open NVS for writing");
     return false;
   }
 
-  if (caCertPem && strlen(caCertPem) > 0) {
-    _prefs.putString("ca_cert", caCertPem);
-  }
+  _record.magic = RECORD_MAGIC;
+  _record.layout = RECORD_LAYOUT;
+  _record.expiresAt = static_cast<uint32_t>(_expiresAt);
+  _record.certVersion = _certVersion;
+  strncpy(_record.cn, _cn, MAX_CN_LENGTH - 1);
+  _record.cn[MAX_CN_LENGTH - 1] = '\0';
+  _record.crc = recordCrc();
 
-  _prefs.putString("cert_cn", _cn);
-  _prefs.putULong("cert_expires", _expiresAt);
-  _prefs.putInt("cert_version", _certVersion);
+  size_t length = recordLength();
+  if (_prefs.putBytes(RECORD_KEY, &_record, length) != length) {
+    setError("Failed to save certificates");
+    return false;
+  }
 
-  _arduino->log("CertificateManager: Certificates saved successfully");
+  CM_LOG_INFO("CertificateManager: Certificates saved successfully");
   return true;
 }
 
@@ -146,22 +227,47 @@ bool CertificateManager::loadCertificates(IWiFiClient &client) {
     return false;
   }
 
+  if (client.supportsCredentials()) {
+    const TlsCredentials *credentials = getCredentials();
+    if (!credentials) {
+      return false;
+    }
+    client.setCredentials(*credentials);
+    CM_LOG_INFO("CertificateManager: Client credentials loaded (CN=%s%s)", _cn,
+                   credentials->hasCA() ? "" : ", server validation disabled");
+    return true;
+  }
+
   if (_caCert) {
     client.setCACert(_caCert);
-    _arduino->log("CertificateManager: CA certificate loaded");
+    CM_LOG_INFO("CertificateManager: CA certificate loaded");
   } else {
     // If no CA cert, we need to set insecure mode for server verification
     // But we still have client cert for client authentication
-    _arduino->log("CertificateManager: WARNING - No CA cert, server validation disabled");
+    CM_LOG_WARN("CertificateManager: WARNING - No CA cert, server validation disabled");
   }
 
   client.setCertificate(_clientCert);
   client.setPrivateKey(_clientKey);
 
-  _arduino->logf("CertificateManager: Client certificate loaded (CN=%s)", _cn);
+  CM_LOG_INFO("CertificateManager: Client certificate loaded (CN=%s)", _cn);
   return true;
 }
 
+const TlsCredentials *CertificateManager::getCredentials() {
+  if (!isProvisioned()) {
+    setError("Certificates not provisioned");
+    return nullptr;
+  }
+
+  if (!_credentials.isLoaded() && !_credentials.load(_clientCert, _clientKey, _caCert)) {
+    setError("Failed to parse TLS credentials");
+    return nullptr;
+  }
+
+  return &_credentials;
+}
+
 bool CertificateManager::validateCertificates() {
   if (!isProvisioned()) {
     setError("Certificates not provisioned");
@@ -184,7 +290,7 @@ bool CertificateManager::validateCertificates() {
   }
 
   if (!extractExpirationFromCert(_clientCert)) {
-    _arduino->log("CertificateManager: WARNING - Failed to extract expiration date");
+    CM_LOG_WARN("CertificateManager: WARNING - Failed to extract expiration date");
   } else {
     // Check if certificate is expired or expiring soon
     unsigned long now = _arduino->millis() / 1000; // Current time in seconds (approximation)
@@ -192,16 +298,15 @@ bool CertificateManager::validateCertificates() {
       setError("Certificate has expired");
       return false;
     } else if (_expiresAt > 0 && (_expiresAt - now) < (CERT_EXPIRY_WARNING_DAYS * SECONDS_PER_DAY)) {
-      unsigned long daysLeft = (_expiresAt - now) / SECONDS_PER_DAY;
-      _arduino->logf("CertificateManager: WARNING - Certificate expires in %lu days", daysLeft);
+      CM_LOG_WARN("CertificateManager: WARNING - Certificate expires in %lu days", (_expiresAt - now) / SECONDS_PER_DAY);
     }
   }
 
   #ifdef DEBUG_CERTS
   char certInfo[1024];
   if (X509Parser::getCertificateInfo(_clientCert, certInfo, sizeof(certInfo))) {
-    _arduino->log("Certificate details:");
-    _arduino->log(certInfo);
+    CM_LOG_DEBUG("Certificate details:");
+    CM_LOG_DEBUG("%s", certInfo);
   }
   #endif
 
@@ -243,11 +348,11 @@ bool CertificateManager::extractCNFromCert(const char *certPem) {
   bool result = X509Parser::extractCN(certPem, _cn, MAX_CN_LENGTH);
 
   if (!result) {
-    _arduino->log("CertificateManager: Failed to extract CN from certificate");
+    CM_LOG_ERROR("CertificateManager: Failed to extract CN from certificate");
     return false;
   }
 
-  _arduino->logf("CertificateManager: Extracted CN: %s", _cn);
+  CM_LOG_DEBUG("CertificateManager: Extracted CN: %s", _cn);
   return true;
 }
 
@@ -255,16 +360,15 @@ bool CertificateManager::extractExpirationFromCert(const char *certPem) {
   bool result = X509Parser::extractExpiration(certPem, &_expiresAt);
 
   if (!result) {
-    _arduino->log("CertificateManager: WARNING - Failed to extract expiration date");
+    CM_LOG_WARN("CertificateManager: WARNING - Failed to extract expiration date");
     // Set a default (10 years from now) as fallback
     _expiresAt = (_arduino->millis() / 1000) + (3650UL * 86400UL);
     return false;
   }
 
   // Log expiration date for debugging
-  unsigned long now = _arduino->millis() / 1000;
-  long daysUntilExpiry = (_expiresAt - now) / 86400;
-  _arduino->logf("CertificateManager: Certificate expires in %ld days", daysUntilExpiry);
+  CM_LOG_INFO("CertificateManager: Certificate expires in %ld days",
+              static_cast<long>((_expiresAt - _arduino->millis() / 1000) / 86400));
 
   return true;
 }
@@ -272,38 +376,42 @@ bool CertificateManager::extractExpirationFromCert(const char *certPem) {
 bool CertificateManager::validateCertKeyPair(const char *certPem, const char *keyPem) {
   // First validate PEM format
   if (!validateCertificateFormat(certPem)) {
-    _arduino->log("CertificateManager: Invalid certificate format");
+    CM_LOG_ERROR("CertificateManager: Invalid certificate format");
     return false;
   }
 
   if (!validatePrivateKeyFormat(keyPem)) {
-    _arduino->log("CertificateManager: Invalid private key format");
+    CM_LOG_ERROR("CertificateManager: Invalid private key format");
     return false;
   }
 
   // Then verify cryptographic match
-  _arduino->log("CertificateManager: Validating certificate/key pair...");
+  CM_LOG_DEBUG("CertificateManager: Validating certificate/key pair...");
   bool result = X509Parser::validateKeyPair(certPem, keyPem);
 
   if (!result) {
-    _arduino->log("CertificateManager: ERROR - Certificate and private key do not match!");
+    CM_LOG_ERROR("CertificateManager: ERROR - Certificate and private key do not match!");
     return false;
   }
 
-  _arduino->log("CertificateManager: Certificate/key pair validated successfully");
+  CM_LOG_INFO("CertificateManager: Certificate/key pair validated successfully");
   return true;
 }
 
 void CertificateManager::logCertificateInfo(const char* certPem) {
-  char info[512];
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+  char info[1024]; // mbedtls_x509_crt_info() fails rather than truncate
   if (X509Parser::getCertificateInfo(certPem, info, sizeof(info))) {
-    _arduino->log("Certificate Information:");
-    _arduino->log(info);
+    CM_LOG_DEBUG("Certificate Information:");
+    CM_LOG_DEBUG("%s", info);
   }
+#else
+  (void)certPem;
+#endif
 }
 
 bool CertificateManager::storeCertificates(const char *certPem, const char *keyPem, const char *caCertPem) {
-  _arduino->log("CertificateManager: Storing certificates");
+  CM_LOG_INFO("CertificateManager: Storing certificates");
 
   // Validate formats
   if (!validateCertificateFormat(certPem)) {
@@ -316,6 +424,18 @@ bool CertificateManager::storeCertificates(const char *certPem, const char *keyP
     return false;
   }
 
+  size_t certLen = strlen(certPem);
+  size_t keyLen = strlen(keyPem);
+  size_t caLen = caCertPem ? strlen(caCertPem) : 0;
+  if (certLen >= static_cast<size_t>(MAX_CERT_SIZE) || caLen >= static_cast<size_t>(MAX_CERT_SIZE)) {
+    setError("Certificate too large");
+    return false;
+  }
+  if (keyLen >= static_cast<size_t>(MAX_KEY_SIZE)) {
+    setError("Private key too large");
+    return false;
+  }
+
   if (!validateCertKeyPair(certPem, keyPem)) {
     setError("Certificate and key do not match");
     return false;
@@ -325,33 +445,17 @@ bool CertificateManager::storeCertificates(const char *certPem, const char *keyP
   logCertificateInfo(certPem);
   #endif
 
-  // Allocate and store in memory
-  if (_clientCert)
-    free(_clientCert);
-  if (_clientKey)
-    free(_clientKey);
-  if (_caCert)
-    free(_caCert);
-
-  _clientCert = (char *)malloc(strlen(certPem) + 1);
-  _clientKey = (char *)malloc(strlen(keyPem) + 1);
-
-  if (!_clientCert || !_clientKey) {
-    setError("Failed to allocate memory");
-    return false;
-  }
-
-  strcpy(_clientCert, certPem);
-  strcpy(_clientKey, keyPem);
-
-  if (caCertPem && strlen(caCertPem) > 0) {
-    _caCert = (char *)malloc(strlen(caCertPem) + 1);
-    if (_caCert) {
-      strcpy(_caCert, caCertPem);
-    }
-  } else {
-    _caCert = nullptr;
+  // Pack into the record (memmove: the PEMs may be the ones already held)
+  releaseCertificates();
+  memmove(_record.data, certPem, certLen + 1);
+  memmove(_record.data + certLen + 1, keyPem, keyLen + 1);
+  if (caLen > 0) {
+    memmove(_record.data + certLen + keyLen + 2, caCertPem, caLen + 1);
   }
+  _record.certLength = static_cast<uint16_t>(certLen);
+  _record.keyLength = static_cast<uint16_t>(keyLen);
+  _record.caLength = static_cast<uint16_t>(caLen);
+  pointIntoRecord();
 
   // Extract CN and set metadata
   if (!extractCNFromCert(certPem)) {
@@ -360,38 +464,30 @@ bool CertificateManager::storeCertificates(const char *certPem, const char *keyP
   }
 
   if (X509Parser::extractSerial(certPem, _serialNumber, sizeof(_serialNumber))) {
-    _arduino->logf("Certificate serial: %s", _serialNumber);
+    CM_LOG_DEBUG("Certificate serial: %s", _serialNumber);
   }
 
   extractExpirationFromCert(certPem);
   _certVersion++;
 
   // Save to NVS
-  if (!saveToNVS(certPem, keyPem, caCertPem)) {
+  if (!saveToNVS()) {
     return false;
   }
 
-  _arduino->log("CertificateManager: Certificates stored successfully");
+  CM_LOG_INFO("CertificateManager: Certificates stored successfully");
   return true;
 }
 
 bool CertificateManager::clearCertificates() {
-  _arduino->log("CertificateManager: Clearing certificates");
-
-  _prefs.clear();
+  CM_LOG_INFO("CertificateManager: Clearing certificates");
 
-  if (_clientCert) {
-    free(_clientCert);
-    _clientCert = nullptr;
-  }
-  if (_clientKey) {
-    free(_clientKey);
-    _clientKey = nullptr;
-  }
-  if (_caCert) {
-    free(_caCert);
-    _caCert = nullptr;
+  if (openNVS(false)) {
+    _prefs.clear();
   }
+  releaseCertificates();
+  // Don't leave the private key behind in RAM
+  memset(&_record, 0, sizeof(_record));
 
   _cn[0] = '\0';
   _expiresAt = 0;
@@ -401,7 +497,7 @@ bool CertificateManager::clearCertificates() {
 }
 
 bool CertificateManager::startProvisioningMode(IWebServer *webServer) {
-  _arduino->log("CertificateManager: Starting provisioning mode");
+  CM_LOG_INFO("CertificateManager: Starting provisioning mode");
 
   if (!webServer) {
     setError("Web server not provided");
@@ -428,13 +524,13 @@ bool CertificateManager::startProvisioningMode(IWebServer *webServer) {
   IPAddress subnet(255, 255, 255, 0);
 
   if (!_wifi->softAPConfig(local_IP, gateway, subnet)) {
-    _arduino->log("CertificateManager: Failed to configure AP IP");
+    CM_LOG_ERROR("CertificateManager: Failed to configure AP IP");
     setError("Failed to configure AP");
     return false;
   }
 
   if (!_wifi->softAP(macStr)) {
-    _arduino->log("CertificateManager: Failed to start AP");
+    CM_LOG_ERROR("CertificateManager: Failed to start AP");
     setError("Failed to start AP");
     return false;
   }
@@ -442,20 +538,20 @@ bool CertificateManager::startProvisioningMode(IWebServer *webServer) {
   _arduino->delay(500); // Give AP time to start
 
   auto IP = _wifi->softAPIP();
-  _arduino->log("===========================================");
-  _arduino->logf("AP SSID: %s", macStr);
+  CM_LOG_INFO("===========================================");
+  CM_LOG_INFO("AP SSID: %s", macStr);
   // Note: IP.toString() might not work with mocks, so we format manually
-  _arduino->log("AP IP: 192.168.4.1");
-  _arduino->log("AP Password: (none - open network)");
-  _arduino->log("Visit: http://192.168.4.1");
-  _arduino->log("===========================================");
+  CM_LOG_INFO("AP IP: 192.168.4.1");
+  CM_LOG_INFO("AP Password: (none - open network)");
+  CM_LOG_INFO("Visit: http://192.168.4.1");
+  CM_LOG_INFO("===========================================");
 
   setupProvisioningServer();
 
   _provisioningActive = true;
   _provisioningStartTime = _arduino->millis();
 
-  _arduino->log("CertificateManager: HTTP server started and ready for requests");
+  CM_LOG_INFO("CertificateManager: HTTP server started and ready for requests");
   return true;
 }
 
@@ -465,47 +561,49 @@ void CertificateManager::stopProvisioningMode() {
     _provisioningServer = nullptr;
   }
   _provisioningActive = false;
-  _arduino->log("CertificateManager: Provisioning mode stopped");
+  CM_LOG_INFO("CertificateManager: Provisioning mode stopped");
 }
 
 void CertificateManager::handleProvisioningLoop() {
   if (_provisioningServer && _provisioningActive) {
     _provisioningServer->handleClient();
 
-    // Check for timeout every 30 seconds
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+    // Report progress every 30 seconds
     static unsigned long lastCheck = 0;
     unsigned long now = _arduino->millis();
     if (now - lastCheck > 30000) {
       unsigned long elapsed = (now - _provisioningStartTime) / 1000;
-      _arduino->logf("Provisioning active for %lu seconds, waiting for connection...", elapsed);
+      CM_LOG_DEBUG("Provisioning active for %lu seconds, waiting for connection...", elapsed);
 
       // Show number of connected clients
       int clients = _wifi->softAPgetStationNum();
-      _arduino->logf("Connected clients to AP: %d", clients);
+      CM_LOG_DEBUG("Connected clients to AP: %d", clients);
 
       lastCheck = now;
     }
+#endif
   }
 }
 
 void CertificateManager::setupProvisioningServer() {
   _provisioningServer->on("/", [this]() {
-    _arduino->log("CertificateManager: Received GET request for /");
+    CM_LOG_DEBUG("CertificateManager: Received GET request for /");
     handleRootRequest();
   });
 
   _provisioningServer->on("/provision", [this]() {
-    _arduino->log("CertificateManager: Received POST request for /provision");
+    CM_LOG_DEBUG("CertificateManager: Received POST request for /provision");
     handleProvisionRequest();
   });
 
   _provisioningServer->onNotFound([this]() {
-    _arduino->logf("CertificateManager: 404 - Not found: %s", _provisioningServer->uri());
+    CM_LOG_DEBUG("CertificateManager: 404 - Not found: %s", _provisioningServer->uri());
     _provisioningServer->send(404, "text/plain", "Not found");
   });
 
   _provisioningServer->begin();
-  _arduino->log("CertificateManager: HTTP server started on port 80");
+  CM_LOG_INFO("CertificateManager: HTTP server started on port 80");
 }
 
 void CertificateManager::handleRootRequest() {
@@ -568,7 +666,7 @@ void CertificateManager::handleRootRequest() {
 }
 
 void CertificateManager::handleProvisionRequest() {
-  _arduino->log("CertificateManager: Received provisioning request");
+  CM_LOG_DEBUG("CertificateManager: Received provisioning request");
 
   // Check if we have the required certificate fields
   if (!_provisioningServer->hasArg("cert") || !_provisioningServer->hasArg("key")) {
@@ -589,7 +687,7 @@ void CertificateManager::handleProvisionRequest() {
     if (strlen(wifiSsid) > 0 && strlen(wifiPassword) > 0) {
 #ifndef UNIT_TEST
       if (_wifiManager->storeCredentials(wifiSsid, wifiPassword)) {
-        _arduino->log("CertificateManager: WiFi credentials stored successfully");
+        CM_LOG_INFO("CertificateManager: WiFi credentials stored successfully");
         wifiProvisioned = true;
       } else {
         sendResponse(400, "Failed to store WiFi credentials");
@@ -597,7 +695,7 @@ void CertificateManager::handleProvisionRequest() {
       }
 #else
       // In unit tests, just mark as provisioned
-      _arduino->log("CertificateManager: WiFi credentials stored successfully (mock)");
+      CM_LOG_INFO("CertificateManager: WiFi credentials stored successfully (mock)");
       wifiProvisioned = true;
 #endif
     }
@@ -649,5 +747,34 @@ const char *CertificateManager::getLastMACOctet() {
 void CertificateManager::setError(const char *error) {
   strncpy(_lastError, error, sizeof(_lastError) - 1);
   _lastError[sizeof(_lastError) - 1] = '\0';
-  _arduino->logf("CertificateManager: ERROR - %s", _lastError);
+  CM_LOG_ERROR("CertificateManager: ERROR - %s", _lastError);
+}
+
+void CertificateManager::releaseCertificates() {
+  _credentials.clear();
+  _clientCert = nullptr;
+  _clientKey = nullptr;
+  _caCert = nullptr;
+}
+
+void CertificateManager::pointIntoRecord() {
+  _clientCert = _record.data;
+  _clientKey = _clientCert + _record.certLength + 1;
+  _caCert = _record.caLength > 0 ? _clientKey + _record.keyLength + 1 : nullptr;
+}
+
+size_t CertificateManager::recordLength() const {
+  size_t length = offsetof(Record, data) + _record.certLength + 1 + _record.keyLength + 1;
+  return _record.caLength > 0 ? length + _record.caLength + 1 : length;
+}
+
+uint32_t CertificateManager::recordCrc() const {
+  // Everything after the crc field, up to the end of the stored blob
+  size_t start = offsetof(Record, layout);
+  return Crc32::compute(reinterpret_cast<const uint8_t *>(&_record) + start, recordLength() - start);
+}
+
+bool CertificateManager::openNVS(bool readOnly) {
+  _prefs.end();
+  return _prefs.begin("tarameteo_certs", readOnly);
 }
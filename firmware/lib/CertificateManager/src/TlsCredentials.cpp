@@ -0,0 +1,103 @@
+#include "TlsCredentials.h"
+#include <string.h>
+
+#ifdef TLS_USE_MBEDTLS
+// Real mbedTLS implementation for ESP32 (and native tests)
+
+TlsCredentials::TlsCredentials() : _loaded(false), _hasCA(false), _parseCount(0) {
+    mbedtls_x509_crt_init(&_cert);
+    mbedtls_pk_init(&_key);
+    mbedtls_x509_crt_init(&_ca);
+}
+
+TlsCredentials::~TlsCredentials() {
+    mbedtls_x509_crt_free(&_cert);
+    mbedtls_pk_free(&_key);
+    mbedtls_x509_crt_free(&_ca);
+}
+
+bool TlsCredentials::load(const char* certPem, const char* keyPem, const char* caPem) {
+    clear();
+
+    if (!certPem || !keyPem) {
+        return false;
+    }
+    _parseCount++;
+
+    int ret = mbedtls_x509_crt_parse(&_cert,
+                                     (const unsigned char*)certPem,
+                                     strlen(certPem) + 1);
+    if (ret != 0) {
+        clear();
+        return false;
+    }
+
+    ret = mbedtls_pk_parse_key(&_key,
+                               (const unsigned char*)keyPem,
+                               strlen(keyPem) + 1,
+                               NULL, 0); // No password
+    if (ret != 0) {
+        clear();
+        return false;
+    }
+
+    if (caPem) {
+        ret = mbedtls_x509_crt_parse(&_ca,
+                                     (const unsigned char*)caPem,
+                                     strlen(caPem) + 1);
+        if (ret != 0) {
+            clear();
+            return false;
+        }
+        _hasCA = true;
+    }
+
+    _loaded = true;
+    return true;
+}
+
+void TlsCredentials::clear() {
+    mbedtls_x509_crt_free(&_cert);
+    mbedtls_pk_free(&_key);
+    mbedtls_x509_crt_free(&_ca);
+    mbedtls_x509_crt_init(&_cert);
+    mbedtls_pk_init(&_key);
+    mbedtls_x509_crt_init(&_ca);
+    _loaded = false;
+    _hasCA = false;
+}
+
+#else
+// Mock implementation for unit tests
+// In tests, only the PEM markers are checked and parses are counted
+
+TlsCredentials::TlsCredentials() : _loaded(false), _hasCA(false), _parseCount(0) {}
+
+TlsCredentials::~TlsCredentials() {}
+
+bool TlsCredentials::load(const char* certPem, const char* keyPem, const char* caPem) {
+    clear();
+
+    if (!certPem || !keyPem) {
+        return false;
+    }
+    _parseCount++;
+
+    if (!strstr(certPem, "-----BEGIN CERTIFICATE-----") || !strstr(keyPem, "PRIVATE KEY-----")) {
+        return false;
+    }
+    if (caPem && !strstr(caPem, "-----BEGIN CERTIFICATE-----")) {
+        return false;
+    }
+
+    _hasCA = (caPem != nullptr);
+    _loaded = true;
+    return true;
+}
+
+void TlsCredentials::clear() {
+    _loaded = false;
+    _hasCA = false;
+}
+
+#endif
@@ -2,14 +2,13 @@
 #include <string.h>
 #include <stdio.h>
 
-#ifndef UNIT_TEST
-// Real mbedTLS implementation for ESP32
+#ifdef TLS_USE_MBEDTLS
+// Real mbedTLS implementation for ESP32 (and native tests)
 #include <mbedtls/x509_crt.h>
 #include <mbedtls/pk.h>
 #include <mbedtls/error.h>
 #include <mbedtls/md.h>
 #include <mbedtls/oid.h>
-#include <time.h>
 
 bool X509Parser::extractCN(const char* certPem, char* cnBuffer, size_t bufferSize) {
     if (!certPem || !cnBuffer || bufferSize == 0) {
@@ -144,9 +143,10 @@ bool X509Parser::validateKeyPair(const char* certPem, const char* keyPem) {
         return false;
     }
 
-    // Verify that the key types match
-    mbedtls_pk_type_t cert_pk_type = mbedtls_pk_get_type(&cert.pk);
-    mbedtls_pk_type_t key_pk_type = mbedtls_pk_get_type(&pk);
+    // Verify that the key types match. An EC key may be tagged as a generic
+    // EC key or as ECDSA-only depending on how it was encoded.
+    mbedtls_pk_type_t cert_pk_type = normalizeKeyType(mbedtls_pk_get_type(&cert.pk));
+    mbedtls_pk_type_t key_pk_type = normalizeKeyType(mbedtls_pk_get_type(&pk));
 
     if (cert_pk_type != key_pk_type) {
         mbedtls_x509_crt_free(&cert);
@@ -167,13 +167,15 @@ bool X509Parser::validateKeyPair(const char* certPem, const char* keyPem) {
         return match;
     }
 
-    // For EC keys, compare the public key points
-    if (cert_pk_type == MBEDTLS_PK_ECKEY || cert_pk_type == MBEDTLS_PK_ECDSA) {
+    // For EC keys, compare the curve and the public key points
+    if (cert_pk_type == MBEDTLS_PK_ECKEY) {
         mbedtls_ecp_keypair* cert_ec = mbedtls_pk_ec(cert.pk);
         mbedtls_ecp_keypair* key_ec = mbedtls_pk_ec(pk);
 
-        // Compare the EC public key points
-        bool match = (mbedtls_ecp_point_cmp(&cert_ec->Q, &key_ec->Q) == 0);
+        // SEC1 keys carry the public point; PKCS#8 keys may omit it, in which
+        // case mbedTLS derives Q from d while parsing.
+        bool match = (cert_ec->grp.id == key_ec->grp.id) &&
+                     (mbedtls_ecp_point_cmp(&cert_ec->Q, &key_ec->Q) == 0);
 
         mbedtls_x509_crt_free(&cert);
         mbedtls_pk_free(&pk);
@@ -209,20 +211,26 @@ bool X509Parser::getCertificateInfo(const char* certPem, char* infoBuffer, size_
     return (ret >= 0);
 }
 
+mbedtls_pk_type_t X509Parser::normalizeKeyType(mbedtls_pk_type_t type) {
+    return type == MBEDTLS_PK_ECDSA ? MBEDTLS_PK_ECKEY : type;
+}
+
 unsigned long X509Parser::timeToEpoch(int year, int month, int day, int hour, int min, int sec) {
-    // Simple conversion to Unix epoch (seconds since Jan 1, 1970)
-    // This is approximate and doesn't handle all edge cases perfectly
-
-    struct tm timeinfo = {0};
-    timeinfo.tm_year = year - 1900;  // Years since 1900
-    timeinfo.tm_mon = month - 1;     // 0-11
-    timeinfo.tm_mday = day;          // 1-31
-    timeinfo.tm_hour = hour;         // 0-23
-    timeinfo.tm_min = min;           // 0-59
-    timeinfo.tm_sec = sec;           // 0-59
-
-    time_t epoch = mktime(&timeinfo);
-    return (unsigned long)epoch;
+    // X.509 times are UTC, so mktime() would be off by the local time zone,
+    // and a 32-bit time_t overflows in 2038. Count days from 1970-01-01 in
+    // the proleptic Gregorian calendar instead, with March as the first
+    // month so that leap days fall at the end of the year.
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yearOfEra = y - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    long days = era * 146097L + dayOfEra - 719468L;
+    if (days < 0) {
+        return 0;
+    }
+
+    return (unsigned long)days * 86400UL + hour * 3600UL + min * 60UL + sec;
 }
 
 #else
@@ -299,4 +307,4 @@ unsigned long X509Parser::timeToEpoch(int year, int month, int day, int hour, in
     return 946684800UL; // Jan 1, 2000
 }
 
-#endif // UNIT_TEST
+#endif // TLS_USE_MBEDTLS
@@ -0,0 +1,15 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, as zlib computes it), for records kept in NVS or RTC
+// memory. The device uses the ROM implementation, tests a table built on
+// first use. Pass the previous result to continue over several buffers.
+class Crc32 {
+public:
+    static uint32_t compute(const void* data, size_t length, uint32_t crc = 0);
+};
+
+#endif // CRC32_H
@@ -0,0 +1,105 @@
+#include "EventLog.h"
+#include "RtcState.h"
+
+EventLogState *EventLog::_state = nullptr;
+
+void EventLog::begin(EventLogState *state, uint32_t bootMs) {
+  _state = state;
+  if (!_state) {
+    return;
+  }
+  RtcState::adopt(*_state, MAGIC, _state->used <= EventLogState::RING_SIZE && _state->head < EventLogState::RING_SIZE);
+  _state->boot++;
+  write(LOG_LEVEL_INFO, ID_BOOT, static_cast<uint32_t>(_state->boot), bootMs);
+}
+
+void EventLog::text(uint8_t level, const char *message) {
+  if (!_state) {
+    return;
+  }
+  if (reserve(level, ID_TEXT, RECORD_HEADER + 1 + stringLength(message, MAX_TEXT))) {
+    putString(message, MAX_TEXT);
+  }
+}
+
+bool EventLog::reserve(uint8_t level, uint32_t id, size_t length) {
+  if (length > MAX_RECORD) {
+    _state->dropped++;
+    return false;
+  }
+
+  // Evict the oldest records until the new one fits
+  while (static_cast<size_t>(EventLogState::RING_SIZE - _state->used) < length) {
+    uint16_t oldest = (_state->head + EventLogState::RING_SIZE - _state->used) % EventLogState::RING_SIZE;
+    uint8_t oldestLength = _state->ring[oldest];
+    if (oldestLength == 0 || oldestLength > _state->used) {
+      // Corrupted (e.g. RTC memory disturbed by a brownout): start over
+      _state->used = 0;
+      break;
+    }
+    _state->used -= oldestLength;
+    _state->dropped++;
+  }
+  if (_state->worst == LOG_LEVEL_NONE || level < _state->worst) {
+    _state->worst = level;
+  }
+
+  uint8_t header[2] = {static_cast<uint8_t>(length), level};
+  put(header, sizeof(header));
+  put32(id);
+  put32(static_cast<uint32_t>(millis()));
+  return true;
+}
+
+void EventLog::put(const uint8_t *data, size_t length) {
+  for (size_t i = 0; i < length; i++) {
+    _state->ring[_state->head] = data[i];
+    _state->head = (_state->head + 1) % EventLogState::RING_SIZE;
+  }
+  _state->used += length;
+}
+
+void EventLog::put32(uint32_t value) {
+  uint8_t bytes[4] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16),
+                      static_cast<uint8_t>(value >> 24)};
+  put(bytes, sizeof(bytes));
+}
+
+void EventLog::putString(const char *s, size_t max) {
+  uint8_t length = static_cast<uint8_t>(stringLength(s, max));
+  put(&length, 1);
+  put(reinterpret_cast<const uint8_t *>(s), length);
+}
+
+size_t EventLog::dump(Print &out) {
+  uint16_t used = size();
+  uint16_t lost = dropped();
+  uint8_t header[8] = {static_cast<uint8_t>(MAGIC >> 24), static_cast<uint8_t>(MAGIC >> 16),
+                       static_cast<uint8_t>(MAGIC >> 8),  static_cast<uint8_t>(MAGIC),
+                       static_cast<uint8_t>(used),        static_cast<uint8_t>(used >> 8),
+                       static_cast<uint8_t>(lost),        static_cast<uint8_t>(lost >> 8)};
+  size_t written = out.write(header, sizeof(header));
+  if (used == 0) {
+    return written;
+  }
+
+  // The held bytes, oldest first, in at most two runs around the end of the ring
+  uint16_t start = (_state->head + EventLogState::RING_SIZE - used) % EventLogState::RING_SIZE;
+  size_t first = EventLogState::RING_SIZE - start;
+  if (first > used) {
+    first = used;
+  }
+  written += out.write(_state->ring + start, first);
+  written += out.write(_state->ring, used - first);
+  return written;
+}
+
+void EventLog::clear() {
+  if (!_state) {
+    return;
+  }
+  _state->head = 0;
+  _state->used = 0;
+  _state->dropped = 0;
+  _state->worst = LOG_LEVEL_NONE;
+}
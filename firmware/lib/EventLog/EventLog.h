@@ -0,0 +1,195 @@
+/*
+ * EventLog.h
+ * Deferred binary logging into an RTC memory ring, decoded on the host
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include "LogLevel.h"
+
+
+// In RTC memory across deep sleep (see RtcState.h)
+struct EventLogState {
+    static const uint16_t RING_SIZE = 1024;
+
+    uint32_t magic;
+    uint16_t head;     // Offset of the next byte to write
+    uint16_t used;     // Bytes held, oldest record at head - used
+    uint16_t dropped;  // Records evicted or too large since the last clear()
+    uint16_t boot;     // Boots since the ring was created
+    uint8_t worst;     // Most severe level held (0 = none)
+    uint8_t ring[RING_SIZE];
+};
+
+// Records are written as [length][level][format id][millis][arguments],
+// little-endian. The format id is the FNV-1a hash of the format string,
+// computed by the compiler: the string itself is never stored, and without
+// LOG_SERIAL it is not even linked in. scripts/decode_log.py hashes the
+// LOG_* format strings of the source tree to turn a dump back into text.
+//
+// Arguments are encoded by type: integers up to 32 bits as 4 bytes, 64-bit
+// integers as 8, floating point as a 4-byte float, strings as a length byte
+// followed by up to MAX_STRING characters. long and pointers take 4 bytes, as
+// on the device, even on a 64-bit host (where int64_t is a long: log 64-bit
+// values as long long there). When the ring is full the oldest records are
+// evicted.
+class EventLog {
+public:
+    static const uint32_t MAGIC = 0x544C4731;  // "TLG1"
+    static const uint32_t ID_TEXT = 0;         // Preformatted text: one string argument
+    static const uint32_t ID_BOOT = 1;         // Boot marker: boot count, boot time in ms
+    static const uint8_t MAX_STRING = 48;
+    static const uint8_t MAX_TEXT = 120;
+    static const uint8_t MAX_RECORD = 255;
+    static const uint8_t RECORD_HEADER = 10;
+
+    // Log into state from now on; resets it if it does not carry a valid
+    // magic (cold boot, layout change) and records a boot marker with the
+    // time from reset to this boot's setup(), whatever the LOG_LEVEL. Until
+    // then records are discarded.
+    static void begin(EventLogState* state, uint32_t bootMs = 0);
+
+    static constexpr uint32_t hash(const char* s, uint32_t h = 2166136261u) {
+        return *s ? hash(s + 1, (h ^ static_cast<uint8_t>(*s)) * 16777619u) : h;
+    }
+
+    template <typename... Args>
+    static void write(uint8_t level, uint32_t id, Args... args) {
+        if (!_state) {
+            return;
+        }
+        size_t length = RECORD_HEADER + argsSize(args...);
+        if (!reserve(level, id, length)) {
+            return;
+        }
+        encode(args...);
+    }
+
+    // Text formatted elsewhere (e.g. by an IArduino::logf implementation)
+    static void text(uint8_t level, const char* message);
+
+    static uint16_t size() { return _state ? _state->used : 0; }
+    static uint16_t dropped() { return _state ? _state->dropped : 0; }
+    static uint8_t worst() { return _state ? _state->worst : LOG_LEVEL_NONE; }
+    // Whether a record at level or more severe is held (LOG_LEVEL_NONE: never)
+    static bool holds(uint8_t level) { return level != LOG_LEVEL_NONE && worst() != LOG_LEVEL_NONE && worst() <= level; }
+
+    // Write the magic, held and dropped counts (2 bytes each) and the
+    // records, oldest first; returns the bytes written
+    static size_t dump(Print& out);
+    static size_t dumpSize() { return 8 + size(); }
+    // Forget the records once uploaded; the boot count is kept
+    static void clear();
+
+private:
+    static EventLogState* _state;
+
+    static bool reserve(uint8_t level, uint32_t id, size_t length);
+    static void put(const uint8_t* data, size_t length);
+    static void put32(uint32_t value);
+    static void putString(const char* s, size_t max = MAX_STRING);
+    static size_t stringLength(const char* s, size_t max = MAX_STRING) { return s ? strnlen(s, max) : 0; }
+
+    static size_t argSize(const char* s) { return 1 + stringLength(s); }
+    static size_t argSize(char* s) { return argSize(static_cast<const char*>(s)); }
+    static size_t argSize(float) { return 4; }
+    static size_t argSize(double) { return 4; }
+    static size_t argSize(long) { return 4; }
+    static size_t argSize(unsigned long) { return 4; }
+    template <typename T>
+    static size_t argSize(T*) {
+        return 4;
+    }
+    template <typename T>
+    static size_t argSize(T) {
+        return sizeof(T) > 4 ? 8 : 4;
+    }
+
+    static size_t argsSize() { return 0; }
+    template <typename T, typename... Rest>
+    static size_t argsSize(T first, Rest... rest) {
+        return argSize(first) + argsSize(rest...);
+    }
+
+    static void encodeArg(const char* s) { putString(s); }
+    static void encodeArg(char* s) { putString(s); }
+    static void encodeArg(float value) { encodeFloat(value); }
+    static void encodeArg(double value) { encodeFloat(static_cast<float>(value)); }
+    static void encodeArg(long value) { put32(static_cast<uint32_t>(value)); }
+    static void encodeArg(unsigned long value) { put32(static_cast<uint32_t>(value)); }
+    template <typename T>
+    static void encodeArg(T* value) {
+        put32(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(value)));
+    }
+    template <typename T>
+    static void encodeArg(T value) {
+        if (sizeof(T) > 4) {
+            uint64_t wide = static_cast<uint64_t>(value);
+            put32(static_cast<uint32_t>(wide));
+            put32(static_cast<uint32_t>(wide >> 32));
+        } else {
+            put32(static_cast<uint32_t>(value));
+        }
+    }
+    static void encodeFloat(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        put32(bits);
+    }
+
+    static void encode() {}
+    template <typename T, typename... Rest>
+    static void encode(T first, Rest... rest) {
+        encodeArg(first);
+        encode(rest...);
+    }
+};
+
+// Forces the hash of a format string to be computed at compile time
+template <uint32_t Id>
+struct EventLogId {
+    static const uint32_t value = Id;
+};
+
+#ifdef LOG_SERIAL
+#define LOG_ECHO(format, ...) Serial.printf(format "\n", ##__VA_ARGS__)
+#else
+#define LOG_ECHO(format, ...) ((void)0)
+#endif
+
+// format must be a string literal
+#define LOG_AT(level, format, ...)                                                             \
+    do {                                                                                       \
+        EventLog::write(level, EventLogId<EventLog::hash(format)>::value, ##__VA_ARGS__);     \
+        LOG_ECHO(format, ##__VA_ARGS__);                                                       \
+    } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) LOG_AT(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) LOG_AT(LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) LOG_AT(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) LOG_AT(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) ((void)0)
+#endif
+
+#endif // EVENT_LOG_H
@@ -0,0 +1,22 @@
+/*
+ * LogLevel.h
+ * Build-time log verbosity, shared by every module that logs
+ */
+
+#ifndef LOG_LEVEL_H
+#define LOG_LEVEL_H
+
+// Levels, as plain macros so that LOG_LEVEL can be tested by the preprocessor
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// Most verbose level compiled in (build flag, e.g. -DLOG_LEVEL=4). Calls
+// above it are removed by the preprocessor, string literals included.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#endif // LOG_LEVEL_H
@@ -0,0 +1,53 @@
+#include "MemoryMonitor.h"
+#include "EventLog.h"
+
+MemoryMonitor::MemoryMonitor() : _last(), _lowest(), _phases(0), _warnStackFree(0), _warnLargestBlock(0) {}
+
+MemorySample MemoryMonitor::sample() {
+  MemorySample sample;
+  sample.freeHeap = ESP.getFreeHeap();
+  sample.minFreeHeap = ESP.getMinFreeHeap();
+  sample.largestBlock = ESP.getMaxAllocHeap();
+  // Bytes on ESP-IDF, whose stacks are allocated in bytes rather than words
+  sample.stackFree = uxTaskGetStackHighWaterMark(nullptr);
+  return sample;
+}
+
+const MemorySample &MemoryMonitor::mark(const char *phase) {
+  MemorySample now = sample();
+  _last = now;
+  LOG_DEBUG("Memory after %s: heap %u free (%u min), largest block %u, stack %u free", phase,
+            static_cast<unsigned>(now.freeHeap), static_cast<unsigned>(now.minFreeHeap),
+            static_cast<unsigned>(now.largestBlock), static_cast<unsigned>(now.stackFree));
+  if (_warnStackFree > 0 && now.stackFree < _warnStackFree) {
+    LOG_WARN("Memory after %s: stack %u free, below %u", phase, static_cast<unsigned>(now.stackFree),
+             static_cast<unsigned>(_warnStackFree));
+  }
+  if (_warnLargestBlock > 0 && now.largestBlock < _warnLargestBlock) {
+    LOG_WARN("Memory after %s: largest block %u of %u free, below %u", phase, static_cast<unsigned>(now.largestBlock),
+             static_cast<unsigned>(now.freeHeap), static_cast<unsigned>(_warnLargestBlock));
+  }
+  (void)phase;
+
+  if (_phases == 0) {
+    _lowest = now;
+  } else {
+    _lowest.freeHeap = now.freeHeap < _lowest.freeHeap ? now.freeHeap : _lowest.freeHeap;
+    _lowest.minFreeHeap = now.minFreeHeap < _lowest.minFreeHeap ? now.minFreeHeap : _lowest.minFreeHeap;
+    _lowest.largestBlock = now.largestBlock < _lowest.largestBlock ? now.largestBlock : _lowest.largestBlock;
+    _lowest.stackFree = now.stackFree < _lowest.stackFree ? now.stackFree : _lowest.stackFree;
+  }
+  if (_phases < UINT8_MAX) {
+    _phases++;
+  }
+  return _last;
+}
+
+bool MemoryMonitor::report(Measurements &measurements) const {
+  if (_phases == 0) {
+    return false;
+  }
+  return measurements.add(CHANNEL_HEAP_MIN, static_cast<int32_t>(_lowest.minFreeHeap)) &&
+         measurements.add(CHANNEL_HEAP_BLOCK, static_cast<int32_t>(_lowest.largestBlock)) &&
+         measurements.add(CHANNEL_STACK_FREE, static_cast<int32_t>(_lowest.stackFree));
+}
@@ -0,0 +1,54 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+#include "Measurements.h"
+
+// Heap and stack state at one point of a wake, in bytes
+struct MemorySample {
+    uint32_t freeHeap;      // Free now
+    uint32_t minFreeHeap;   // Lowest free since boot
+    uint32_t largestBlock;  // Largest single allocation that would succeed now
+    uint32_t stackFree;     // Loop task stack never touched since it started
+};
+
+// Samples the heap and the loop task's stack at the end of each phase of a
+// wake (sensors, WiFi, TLS handshake, publish...), so that buffers can be
+// sized against measured peaks. Each phase gets a debug record in the event
+// log; one that leaves less stack or a smaller free block than the warning
+// limits gets a warning, which has the log uploaded. The lowest values of
+// the wake are published with the reading.
+//
+// A largest free block well below the free heap means fragmentation: the
+// heap has room, but not in one piece.
+class MemoryMonitor {
+public:
+    MemoryMonitor();
+
+    // Warn below these; 0 disables a limit
+    void setWarnings(uint32_t stackFree, uint32_t largestBlock) {
+        _warnStackFree = stackFree;
+        _warnLargestBlock = largestBlock;
+    }
+
+    // Sample and log at the end of phase (e.g. "wifi"); returns the sample
+    const MemorySample& mark(const char* phase);
+
+    // Lowest value of each field over the marks so far (all zero before the first)
+    const MemorySample& lowest() const { return _lowest; }
+    uint8_t getPhaseCount() const { return _phases; }
+
+    // Add the lowest values to a reading; false when it is full or nothing was marked
+    bool report(Measurements& measurements) const;
+
+    static MemorySample sample();
+
+private:
+    MemorySample _last;
+    MemorySample _lowest;
+    uint8_t _phases;
+    uint32_t _warnStackFree;
+    uint32_t _warnLargestBlock;
+};
+
+#endif // MEMORY_MONITOR_H
@@ -0,0 +1,121 @@
+#include "JsonWriter.h"
+
+JsonWriter::JsonWriter(Print &out) : _out(out), _written(0), _first(true) {}
+
+void JsonWriter::beginObject() {
+  writeChar('{');
+  _first = true;
+}
+
+void JsonWriter::endObject() { writeChar('}'); }
+
+void JsonWriter::add(const char *key, long value) {
+  writeKey(key);
+  if (value < 0) {
+    writeChar('-');
+    writeUnsigned(0UL - static_cast<unsigned long>(value));
+  } else {
+    writeUnsigned(static_cast<unsigned long>(value));
+  }
+}
+
+void JsonWriter::add(const char *key, unsigned long value) {
+  writeKey(key);
+  writeUnsigned(value);
+}
+
+void JsonWriter::add(const char *key, const char *value) {
+  writeKey(key);
+  if (!value) {
+    writeRaw("null");
+    return;
+  }
+
+  writeChar('"');
+  for (const char *p = value; *p; p++) {
+    char c = *p;
+    if (c == '"' || c == '\\') {
+      writeChar('\\');
+      writeChar(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      // Control characters never appear in our values; drop them rather than escape
+      continue;
+    } else {
+      writeChar(c);
+    }
+  }
+  writeChar('"');
+}
+
+void JsonWriter::addFixed(const char *key, long value, uint8_t scale, uint8_t decimals) {
+  writeKey(key);
+
+  bool negative = value < 0;
+  unsigned long scaled = negative ? 0UL - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+  // Drop the extra digits with a single rounding step, not one per digit
+  unsigned long divisor = 1;
+  for (; scale > decimals; scale--) {
+    divisor *= 10;
+  }
+  scaled = (scaled + divisor / 2) / divisor;
+  for (; scale < decimals; scale++) {
+    scaled *= 10;
+  }
+  writeDecimal(negative, scaled, decimals);
+}
+
+void JsonWriter::writeKey(const char *key) {
+  if (!_first) {
+    writeChar(',');
+  }
+  _first = false;
+
+  writeChar('"');
+  writeRaw(key);
+  writeChar('"');
+  writeChar(':');
+}
+
+void JsonWriter::writeRaw(const char *text) {
+  size_t len = strlen(text);
+  _written += _out.write(reinterpret_cast<const uint8_t *>(text), len);
+}
+
+void JsonWriter::writeChar(char c) { _written += _out.write(static_cast<uint8_t>(c)); }
+
+void JsonWriter::writeDecimal(bool negative, unsigned long scaled, uint8_t decimals) {
+  unsigned long scale = 1;
+  for (uint8_t i = 0; i < decimals; i++) {
+    scale *= 10;
+  }
+
+  if (negative && scaled != 0) {
+    writeChar('-');
+  }
+
+  writeUnsigned(scaled / scale);
+  if (decimals == 0) {
+    return;
+  }
+
+  writeChar('.');
+  unsigned long fraction = scaled % scale;
+  for (unsigned long digit = scale / 10; digit > 0; digit /= 10) {
+    writeChar(static_cast<char>('0' + (fraction / digit) % 10));
+  }
+}
+
+void JsonWriter::writeUnsigned(unsigned long value) {
+  char digits[12];
+  size_t len = 0;
+  do {
+    digits[len++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+
+  char text[12];
+  for (size_t i = 0; i < len; i++) {
+    text[i] = digits[len - 1 - i];
+  }
+  _written += _out.write(reinterpret_cast<const uint8_t *>(text), len);
+}
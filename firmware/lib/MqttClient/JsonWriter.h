@@ -0,0 +1,104 @@
+/*
+ * JsonWriter.h
+ * Streaming JSON object writer that emits tokens straight into a Print
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Print sink that only counts bytes, used to size a packet before streaming it
+class CountingPrint : public Print {
+public:
+    size_t write(uint8_t) override { _count++; return 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { (void)buffer; _count += size; return size; }
+    size_t count() const { return _count; }
+
+private:
+    size_t _count = 0;
+};
+
+// Print sink that coalesces small writes into fixed-size chunks before
+// forwarding them, so that a TLS transport sees one record per chunk
+// instead of one per token.
+template <size_t N>
+class ChunkedPrint : public Print {
+public:
+    explicit ChunkedPrint(Print& out) : _out(out) {}
+    ~ChunkedPrint() { flush(); }
+
+    size_t write(uint8_t byte) override { return write(&byte, 1); }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        size_t written = 0;
+        while (written < size) {
+            if (_used == N) {
+                flush();
+                if (_used != 0) {
+                    break;
+                }
+            }
+            size_t n = size - written;
+            if (n > N - _used) {
+                n = N - _used;
+            }
+            memcpy(_buffer + _used, buffer + written, n);
+            _used += n;
+            written += n;
+        }
+        return written;
+    }
+
+    void flush() override {
+        if (_used == 0) {
+            return;
+        }
+        size_t sent = _out.write(_buffer, _used);
+        _ok = _ok && (sent == _used);
+        _used = 0;
+    }
+
+    bool ok() const { return _ok; }
+
+private:
+    Print& _out;
+    uint8_t _buffer[N];
+    size_t _used = 0;
+    bool _ok = true;
+};
+
+class JsonWriter {
+public:
+    explicit JsonWriter(Print& out);
+
+    void beginObject();
+    void endObject();
+
+    void add(const char* key, long value);
+    void add(const char* key, unsigned long value);
+    void add(const char* key, int value) { add(key, static_cast<long>(value)); }
+    void add(const char* key, const char* value);
+
+    // Fixed-point integer holding value / 10^scale, written with the given
+    // number of decimals (rounded half away from zero when fewer than scale)
+    void addFixed(const char* key, long value, uint8_t scale, uint8_t decimals);
+
+    size_t bytesWritten() const { return _written; }
+
+private:
+    Print& _out;
+    size_t _written;
+    bool _first;
+
+    void writeKey(const char* key);
+    void writeRaw(const char* text);
+    void writeChar(char c);
+    void writeUnsigned(unsigned long value);
+    void writeDecimal(bool negative, unsigned long scaled, uint8_t decimals);
+};
+
+#endif // JSON_WRITER_H
@@ -1,9 +1,13 @@
 #include "MqttClient.h"
 #include "CertificateManager.h"
-#include "WiFiClientSecureAdapter.h"
+#include "EventLog.h"
+#include <WiFi.h>
 
 MqttClient::MqttClient(const char *server, int port, CertificateManager *certManager)
-    : _server(server), _port(port), _certManager(certManager), _retryCount(0), _mqttClient(_wifiClientSecure) {
+    : _server(server), _port(port), _certManager(certManager), _retryCount(0), _statusInPayload(false),
+      _qos(0), _readingQueued(false), _session(&_localSession), _localSession(), _retryState(&_localRetryState),
+      _localRetryState(), _lastFailure(FAILURE_NONE), _wakeStarted(false), _connectAllowed(true), _retriesEnabled(true), _ciphersuites(nullptr), _curves(nullptr),
+      _maxFragmentLength(SecureClient::DEFAULT_MAX_FRAGMENT_LENGTH), _mqttClient(_secureClient) {
 
   _lastError[0] = '\0';
 
@@ -16,15 +20,18 @@ MqttClient::MqttClient(const char *server, int port, CertificateManager *certMan
 bool MqttClient::begin() {
   _mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
   _mqttClient.setServer(_server, _port);
+  _secureClient.setCiphersuites(_ciphersuites);
+  _secureClient.setCurves(_curves);
+  _secureClient.setMaxFragmentLength(_maxFragmentLength);
 
-  // Load client certificates for mTLS authentication
-  // Wrap WiFiClientSecure with adapter to match IWiFiClient interface
-  WiFiClientSecureAdapter clientAdapter(_wifiClientSecure);
+  // Borrow the client credentials for mTLS authentication. They are parsed
+  // once and reused by every handshake, including reconnects within the wake.
+  SecureClientAdapter clientAdapter(_secureClient);
   if (!_certManager->loadCertificates(clientAdapter)) {
     setError("Failed to load certificates for mTLS");
     return false;
   }
-  Serial.println("MqttClient: mTLS certificates loaded successfully");
+  LOG_INFO("MqttClient: mTLS certificates loaded successfully");
 
   // Initialize topics using sensor name from certificate CN
   const char *sensorName = _certManager->getSensorName();
@@ -32,7 +39,7 @@ bool MqttClient::begin() {
     snprintf(_topic, sizeof(_topic), "weather/%s", sensorName);
     snprintf(_clientId, sizeof(_clientId), "tarameteo-%s", sensorName);
     snprintf(_lwTopic, sizeof(_lwTopic), "status/%s", sensorName);
-    Serial.printf("MqttClient: Initialized for sensor: %s\n", sensorName);
+    LOG_INFO("MqttClient: Initialized for sensor: %s", sensorName);
   } else {
     setError("Failed to get sensor name from certificate");
     return false;
@@ -41,23 +48,52 @@ bool MqttClient::begin() {
   return true;
 }
 
+bool MqttClient::startWake() {
+  if (!_wakeStarted) {
+    _wakeStarted = true;
+    RetryPolicy policy(*_retryState);
+    _connectAllowed = policy.startWake();
+    if (!_connectAllowed) {
+      LOG_WARN("Circuit breaker open, %u wake(s) left", policy.getSkipWakes());
+      _lastFailure = FAILURE_PERSISTENT;
+      setError("Circuit breaker open (broker rejected this station)");
+    }
+  }
+  return _connectAllowed;
+}
+
 bool MqttClient::connect() {
   if (_mqttClient.connected()) {
     return true;
   }
 
-  Serial.printf("Connecting to MQTT broker at %s:%d using mTLS...\n", _server, _port);
+  // After a persistent failure no further handshakes are made until the next wake
+  if (!startWake()) {
+    return false;
+  }
+  RetryPolicy policy(*_retryState);
+
+  LOG_INFO("Connecting to MQTT broker at %s:%d using mTLS...", _server, _port);
+  if (policy.isFragmentRefused()) {
+    _secureClient.setMaxFragmentLengthRefused();
+  }
 
   const char *lwMessage = "offline";
 
-  // Connect with mTLS (no username/password needed)
+  // Connect with mTLS (no username/password needed). When liveness travels in
+  // the data message the LWT is an event, not a state, so it isn't retained.
+  // QoS 1 needs a persistent session so the broker keeps packet IDs across wakes.
   bool connected = _mqttClient.connect(_clientId,
                                        NULL, // no username (using mTLS)
                                        NULL, // no password (using mTLS)
                                        _lwTopic,
-                                       0,    // QoS
-                                       true, // retain
-                                       lwMessage);
+                                       0,                 // QoS
+                                       !_statusInPayload, // retain
+                                       lwMessage,
+                                       _qos == 0); // clean session
+  if (_secureClient.isMaxFragmentLengthRefused()) {
+    policy.recordFragmentRefused();
+  }
 
   if (!connected) {
     int state = _mqttClient.state();
@@ -93,13 +129,29 @@ bool MqttClient::connect() {
       setError("Unknown error");
       break;
     }
+
+    _lastFailure = RetryPolicy::classify(state, WiFi.status() == WL_CONNECTED, _secureClient.getLastTlsError(),
+                                         _secureClient.getLastTlsAlert());
+    if (state == -2 && _lastFailure == FAILURE_PERSISTENT) {
+      setError("Certificate rejected in TLS handshake");
+    }
+    policy.recordFailure(_lastFailure);
+    if (_lastFailure == FAILURE_PERSISTENT) {
+      _connectAllowed = false;
+    }
     return false;
   }
+  policy.recordSuccess();
+  LOG_INFO("TLS handshake (%s): record limit %u bytes, peak heap %u bytes",
+           _secureClient.isResumed() ? "resumed" : "full", getTlsRecordLimit(),
+           static_cast<unsigned>(getTlsHeapPeak()));
 
   // Publish online status
-  _mqttClient.publish(_lwTopic, "online", true);
+  if (!_statusInPayload) {
+    _mqttClient.publish(_lwTopic, "online", true);
+  }
 
-  Serial.printf("Connected to MQTT broker with mTLS (CN=%s)\n", _certManager->getCN());
+  LOG_INFO("Connected to MQTT broker with mTLS (CN=%s)", _certManager->getCN());
   return true;
 }
 
@@ -107,85 +159,303 @@ bool MqttClient::isConnected() { return _mqttClient.connected(); }
 
 bool MqttClient::publishWeatherData(const WeatherData &data) {
   _retryCount = 0;
+  _lastFailure = FAILURE_NONE;
+  _readingQueued = false;
 
-  if (!isConnected()) {
-    if (!connect()) {
-      return false;
-    }
-  }
-
-  char payload[MQTT_BUFFER_SIZE];
-  if (!buildPayload(data, payload, sizeof(payload))) {
-    setError("Failed to build JSON payload");
-    return false;
+  if (_qos > 0) {
+    return publishReliable(data);
   }
 
-  // Publish with retries
-  for (_retryCount = 0; _retryCount <= MAX_RETRIES; _retryCount++) {
-    if (_retryCount > 0) {
-      Serial.printf("Retry attempt %d/%d\n", _retryCount, MAX_RETRIES);
-      delay(1000 * _retryCount);
+  // Publish with retries; the failure class decides how many and how far apart
+  for (_retryCount = 0; _retryCount == 0 || backoff(); _retryCount++) {
+    if (!isConnected()) {
+      if (_retryCount > 0) {
+        LOG_WARN("Connection lost, attempting to reconnect...");
+      }
+      if (!connect()) {
+        continue;
+      }
     }
 
-    bool success = _mqttClient.publish(_topic, payload, false);
+    bool success = streamPublish(_topic, data, false);
 
     if (success) {
-      Serial.printf("Published to topic: %s\n", _topic);
+      LOG_INFO("Published to topic: %s", _topic);
       _mqttClient.loop();
       return true;
     }
+    _lastFailure = FAILURE_TRANSIENT;
+  }
 
+  if (_lastFailure != FAILURE_PERSISTENT) {
+    setError("Failed to publish after max retries");
+  }
+  return false;
+}
+
+bool MqttClient::publishReliable(const WeatherData &data) {
+  MqttSession session(*_session);
+  if (session.epoch() == 0) {
+    session.setEpoch(nextEpoch());
+  }
+  session.enqueue(data);
+  _readingQueued = true;
+
+  // Only records still waiting for a PUBACK are (re)sent; no blind duplicates
+  for (_retryCount = 0; _retryCount == 0 || backoff(); _retryCount++) {
     if (!isConnected()) {
-      Serial.println("Connection lost, attempting to reconnect...");
       if (!connect()) {
-        setError("Reconnection failed");
         continue;
       }
     }
+
+    if (flushInFlight()) {
+      LOG_INFO("Published to topic: %s (QoS 1)", _topic);
+      return true;
+    }
+
+    // MQTT 3.1.1 only retransmits on a new connection of the persistent session
+    LOG_WARN("PUBACK timeout, reconnecting...");
+    _lastFailure = FAILURE_TRANSIENT;
+    _mqttClient.disconnect();
   }
 
-  setError("Failed to publish after max retries");
+  if (_lastFailure != FAILURE_PERSISTENT) {
+    char error[64];
+    snprintf(error, sizeof(error), "%d message(s) not acknowledged", session.count());
+    setError(error);
+  }
   return false;
 }
 
+uint32_t MqttClient::nextEpoch() {
+  // Once per session start (cold boot, brown-out, layout change), not per wake
+  uint32_t epoch = 1;
+  if (_prefs.begin("tarameteo_mqtt", false)) {
+    epoch = _prefs.getULong("epoch", 0) + 1;
+    _prefs.putULong("epoch", epoch);
+    _prefs.end();
+  }
+  LOG_INFO("MqttClient: Session epoch %lu", static_cast<unsigned long>(epoch));
+  return epoch;
+}
+
+bool MqttClient::backoff() {
+  if (!_retriesEnabled) {
+    return false;
+  }
+  int maxRetries = RetryPolicy::maxRetries(_lastFailure);
+  if (_retryCount > maxRetries) {
+    return false;
+  }
+
+  LOG_WARN("Retry attempt %d/%d", _retryCount, maxRetries);
+  delay(RetryPolicy::backoffMs(_lastFailure, _retryCount));
+  return true;
+}
+
+bool MqttClient::flushInFlight() {
+  MqttSession session(*_session);
+
+  for (uint8_t i = 0; i < session.count(); i++) {
+    MqttInFlight &record = session.at(i);
+    if (!streamPublish(_topic, record.data, false, 1, record.packetId, record.sent)) {
+      return false;
+    }
+    record.sent = true;
+  }
+
+  return awaitAcks(ACK_TIMEOUT_MS);
+}
+
+bool MqttClient::awaitAcks(unsigned long timeoutMs) {
+  // PubSubClient::loop() silently drops PUBACKs, so they are read off the transport here
+  MqttSession session(*_session);
+  unsigned long deadline = millis() + timeoutMs;
+
+  while (session.count() > 0) {
+    uint8_t header;
+    if (!readByte(header, deadline)) {
+      return false;
+    }
+
+    size_t remaining = 0;
+    uint8_t lengthBytes = 0;
+    uint8_t digit;
+    do {
+      if (lengthBytes == MQTT_MAX_LENGTH_BYTES || !readByte(digit, deadline)) {
+        return false;
+      }
+      remaining |= static_cast<size_t>(digit & 0x7F) << (7 * lengthBytes++);
+    } while (digit & 0x80);
+
+    // Nothing the broker sends while acks are awaited is longer than a
+    // PUBACK: anything else means the stream is out of step
+    if (remaining > MQTT_PUBACK_LENGTH) {
+      LOG_WARN("Malformed packet (type 0x%02x, %u bytes) while awaiting PUBACK", header,
+               static_cast<unsigned>(remaining));
+      return false;
+    }
+
+    uint8_t body[MQTT_PUBACK_LENGTH] = {0, 0};
+    for (size_t i = 0; i < remaining; i++) {
+      if (!readByte(body[i], deadline)) {
+        return false;
+      }
+    }
+
+    if ((header & 0xF0) == MQTT_PUBACK && remaining == MQTT_PUBACK_LENGTH) {
+      session.acknowledge((body[0] << 8) | body[1]);
+    }
+  }
+
+  return true;
+}
+
+bool MqttClient::readByte(uint8_t &byte, unsigned long deadline) {
+  while (!_secureClient.available()) {
+    if (!_secureClient.connected() || static_cast<long>(millis() - deadline) >= 0) {
+      return false;
+    }
+    delay(10);
+  }
+  byte = static_cast<uint8_t>(_secureClient.read());
+  return true;
+}
+
 void MqttClient::disconnect() {
   if (_mqttClient.connected()) {
-    _mqttClient.publish(_lwTopic, "offline", true);
+    // A clean DISCONNECT discards the LWT, so the broker only publishes it on abnormal drops
+    if (!_statusInPayload) {
+      _mqttClient.publish(_lwTopic, "offline", true);
+    }
     _mqttClient.disconnect();
   }
 }
 
-void MqttClient::setCACert(const char *caCert) { _wifiClientSecure.setCACert(caCert); }
-
-bool MqttClient::buildPayload(const WeatherData &data, char *buffer, size_t size) {
-  StaticJsonDocument<MQTT_BUFFER_SIZE> doc;
+void MqttClient::writePayload(const WeatherData &data, Print &out) {
+  JsonWriter json(out);
+  json.beginObject();
 
   // Authentication now handled at MQTT connection level
-  doc["timestamp"] = data.timestamp;
-  doc["temperature"] = data.temperature;
-  doc["humidity"] = data.humidity;
-  doc["pressure"] = data.pressure;
+  json.add("timestamp", data.timestamp);
+
+  // Fixed-point measurements in the order they were sampled, published in
+  // the units of their channel; statistics get a suffix ("temperature_min")
+  for (uint8_t i = 0; i < data.measurements.count && i < Measurements::MAX_MEASUREMENTS; i++) {
+    const Measurement &measurement = data.measurements.items[i];
+    const ChannelInfo *info = Measurements::info(measurement.channel);
+    const char *suffix = Measurements::suffix(measurement.statistic);
+    if (!info || !suffix) {
+      continue;
+    }
+    // Concatenated by hand: snprintf would cost this path 2 KB of stack
+    char key[24];
+    size_t keyLen = strlen(info->key);
+    size_t suffixLen = strlen(suffix);
+    if (keyLen + suffixLen >= sizeof(key)) {
+      continue;
+    }
+    memcpy(key, info->key, keyLen);
+    memcpy(key + keyLen, suffix, suffixLen + 1);
+    json.addFixed(key, measurement.value, info->scale, info->decimals);
+  }
 
-  if (data.altitude != 0) {
-    doc["altitude"] = data.altitude;
+  if (data.measurements.samples > 0) {
+    json.add("samples", static_cast<unsigned long>(data.measurements.samples));
   }
 
   if (data.rssi != 0) {
-    doc["rssi"] = data.rssi;
+    json.add("rssi", data.rssi);
   }
 
   if (data.retryCount > 0) {
-    doc["retry_count"] = data.retryCount;
+    json.add("retry_count", data.retryCount);
+  }
+
+  if (data.nextWake != 0) {
+    json.add("next_wake", data.nextWake);
   }
 
-  size_t len = serializeJson(doc, buffer, size);
-  if (len == 0 || len >= size) {
+  if (data.sequence != 0) {
+    json.add("epoch", static_cast<unsigned long>(data.epoch));
+    json.add("seq", static_cast<unsigned long>(data.sequence));
+  }
+
+  json.endObject();
+}
+
+bool MqttClient::publishLog() {
+  if (EventLog::size() == 0) {
+    return true;
+  }
+  if (!isConnected() && !connect()) {
     return false;
   }
 
+  char topic[sizeof(_topic) + 4];
+  snprintf(topic, sizeof(topic), "%s/log", _topic);
+  ChunkedPrint<MQTT_CHUNK_SIZE> out(_mqttClient);
+  writePublishHeader(out, topic, EventLog::dumpSize(), false, 0, 0, false);
+  EventLog::dump(out);
+  out.flush();
+
+  if (!out.ok()) {
+    setError("Failed to publish log");
+    return false;
+  }
+  EventLog::clear();
   return true;
 }
 
+bool MqttClient::streamPublish(const char *topic, const WeatherData &data, bool retained, uint8_t qos,
+                               uint16_t packetId, bool dup) {
+  if (!_mqttClient.connected()) {
+    return false;
+  }
+
+  // First pass sizes the payload so the fixed header can be written up front
+  CountingPrint counter;
+  writePayload(data, counter);
+
+  // Second pass writes header, topic and payload straight into the outgoing
+  // packet, coalesced into chunks rather than copied into a staging buffer
+  ChunkedPrint<MQTT_CHUNK_SIZE> out(_mqttClient);
+  writePublishHeader(out, topic, counter.count(), retained, qos, packetId, dup);
+  writePayload(data, out);
+  out.flush();
+
+  return out.ok();
+}
+
+void MqttClient::writePublishHeader(Print &out, const char *topic, size_t payloadLen, bool retained, uint8_t qos,
+                                    uint16_t packetId, bool dup) {
+  size_t topicLen = strlen(topic);
+  size_t remaining = 2 + topicLen + (qos > 0 ? 2 : 0) + payloadLen;
+
+  uint8_t header[5];
+  size_t headerLen = 0;
+  header[headerLen++] = MQTT_PUBLISH | (dup ? 0x08 : 0x00) | (qos << 1) | (retained ? 0x01 : 0x00);
+  do {
+    uint8_t digit = remaining & 0x7F;
+    remaining >>= 7;
+    if (remaining > 0) {
+      digit |= 0x80;
+    }
+    header[headerLen++] = digit;
+  } while (remaining > 0);
+  out.write(header, headerLen);
+
+  uint8_t topicHeader[2] = {static_cast<uint8_t>(topicLen >> 8), static_cast<uint8_t>(topicLen & 0xFF)};
+  out.write(topicHeader, sizeof(topicHeader));
+  out.write(reinterpret_cast<const uint8_t *>(topic), topicLen);
+
+  if (qos > 0) {
+    uint8_t id[2] = {static_cast<uint8_t>(packetId >> 8), static_cast<uint8_t>(packetId & 0xFF)};
+    out.write(id, sizeof(id));
+  }
+}
+
 void MqttClient::setError(const char *error) {
   strncpy(_lastError, error, sizeof(_lastError) - 1);
   _lastError[sizeof(_lastError) - 1] = '\0';
@@ -2,28 +2,23 @@
 #define MQTT_CLIENT_H
 
 #include <Arduino.h>
-#include <WiFiClient.h>
-#include <WiFiClientSecure.h>
+#include <Preferences.h>
 #include <PubSubClient.h>
-#include <ArduinoJson.h>
+#include "JsonWriter.h"
+#include "MqttSession.h"
+#include "RetryPolicy.h"
+#include "SecureClient.h"
+#include "WeatherData.h"
 
 // Forward declaration
 class CertificateManager;
 
-struct WeatherData {
-    float temperature;
-    float pressure;
-    float humidity;
-    float altitude;
-    int rssi;
-    unsigned long timestamp;
-    int retryCount;
-};
-
 class MqttClient {
 public:
-    static const int MAX_RETRIES = 3;
-    static const int MQTT_BUFFER_SIZE = 512;
+    static const int MAX_RETRIES = RetryPolicy::MAX_TRANSIENT_RETRIES;
+    static const int MQTT_BUFFER_SIZE = 128;  // PubSubClient buffer: CONNECT and status packets only
+    static const int MQTT_CHUNK_SIZE = 256;   // Write-combining chunk for streamed PUBLISH packets
+    static const unsigned long ACK_TIMEOUT_MS = 5000;
 
     MqttClient(const char* server, int port, CertificateManager* certManager);
 
@@ -31,26 +26,109 @@ public:
     bool connect();
     bool isConnected();
     bool publishWeatherData(const WeatherData& data);
+    // Upload the event log on <topic>/log as one QoS 0 message and clear it
+    // once sent; true when there was nothing to send
+    bool publishLog();
     void disconnect();
     const char* getLastError() const { return _lastError; }
     int getRetryCount() const { return _retryCount; }
-    void setCACert(const char* caCert);
+    int getHandshakeCount() const { return _secureClient.getHandshakeCount(); }
+    int getResumedHandshakeCount() const { return _secureClient.getResumedCount(); }
+    size_t getTlsHeapPeak() const { return _secureClient.getHandshakeHeapPeak(); }
+    uint16_t getTlsRecordLimit() { return _secureClient.getRecordLimit(); }
+
+    // Carry liveness in the data message (timestamp + next_wake) instead of
+    // retained online/offline publishes; the LWT then only reports abnormal
+    // disconnects and is not retained.
+    void setStatusInPayload(bool enabled) { _statusInPayload = enabled; }
+    bool isStatusInPayload() const { return _statusInPayload; }
+
+    // QoS 1 publishes over a persistent session (clean session off). Readings
+    // stay in the session state until the broker acknowledges them, and only
+    // those are resent. Pass RTC-resident state to keep them across deep sleep.
+    void setQos(uint8_t qos) { _qos = qos > 0 ? 1 : 0; }
+    uint8_t getQos() const { return _qos; }
+    void setSessionState(MqttSessionState* state) { _session = state ? state : &_localSession; }
+    uint8_t getInFlightCount() { return MqttSession(*_session).count(); }
+    // Whether the last publishWeatherData() left the reading in the session,
+    // to be resent until acknowledged, even if it returned false. The caller
+    // must then not carry its contents over into the next reading.
+    bool isReadingQueued() const { return _readingQueued; }
+
+    // Failure classification and circuit breaker. Pass RTC-resident state so
+    // that a station the broker keeps rejecting stops connecting on every wake.
+    void setRetryState(RetryPolicyState* state) { _retryState = state ? state : &_localRetryState; }
+    FailureClass getLastFailure() const { return _lastFailure; }
+    // One attempt per publish when off (e.g. on a low battery); a QoS 1
+    // reading still stays queued for the next wake
+    void setRetriesEnabled(bool enabled) { _retriesEnabled = enabled; }
+    bool isCircuitOpen() const { return !_connectAllowed; }
+    // Counts down an open breaker, once per wake; connect() does it on its
+    // first attempt. Call it before bringing the radio up to skip the whole
+    // transmit when it returns false.
+    bool startWake();
+
+    // Cipher suite and curve allowlists for the TLS handshake, applied in
+    // begin(). Zero-terminated, in preference order; nullptr keeps the
+    // SecureClient defaults. The arrays must outlive the client.
+    void setTlsProfile(const int* ciphersuites, const uint16_t* curves) {
+        _ciphersuites = ciphersuites;
+        _curves = curves;
+    }
+
+    // TLS max_fragment_length to request (512-4096, 0 = off, the default),
+    // applied in begin(). Our packets are a few hundred bytes, so smaller
+    // records cost nothing and let mbedTLS size its buffers down where it
+    // supports that, provided the broker's certificate chain fits in one.
+    // A refusal is kept in the retry state, so later wakes don't ask again.
+    void setMaxFragmentLength(uint16_t length) { _maxFragmentLength = length; }
+
+    // Serialize the weather payload to any Print sink (used for sizing and streaming)
+    static void writePayload(const WeatherData& data, Print& out);
 
 private:
+    static const uint8_t MQTT_PUBLISH = 0x30;
+    static const uint8_t MQTT_PUBACK = 0x40;
+    static const uint8_t MQTT_MAX_LENGTH_BYTES = 4;  // Remaining length field, MQTT 3.1.1 2.2.3
+    static const size_t MQTT_PUBACK_LENGTH = 2;
+
     const char* _server;
     int _port;
     CertificateManager* _certManager;
     char _lastError[128];
     int _retryCount;
+    bool _statusInPayload;
+    uint8_t _qos;
+    bool _readingQueued;
+    MqttSessionState* _session;
+    MqttSessionState _localSession;
+    RetryPolicyState* _retryState;
+    RetryPolicyState _localRetryState;
+    FailureClass _lastFailure;
+    bool _wakeStarted;
+    bool _connectAllowed;
+    bool _retriesEnabled;
+    const int* _ciphersuites;
+    const uint16_t* _curves;
+    uint16_t _maxFragmentLength;
     char _topic[64];
     char _clientId[32];
     char _lwTopic[64];
 
-    WiFiClient _wifiClient;
-    WiFiClientSecure _wifiClientSecure;
+    SecureClient _secureClient;
     PubSubClient _mqttClient;
+    Preferences _prefs;  // Session epoch
 
-    bool buildPayload(const WeatherData& data, char* buffer, size_t size);
+    bool streamPublish(const char* topic, const WeatherData& data, bool retained, uint8_t qos = 0,
+                       uint16_t packetId = 0, bool dup = false);
+    static void writePublishHeader(Print& out, const char* topic, size_t payloadLen, bool retained, uint8_t qos,
+                                   uint16_t packetId, bool dup);
+    bool publishReliable(const WeatherData& data);
+    uint32_t nextEpoch();
+    bool backoff();
+    bool flushInFlight();
+    bool awaitAcks(unsigned long timeoutMs);
+    bool readByte(uint8_t& byte, unsigned long deadline);
     void setError(const char* error);
 };
 
@@ -0,0 +1,70 @@
+#include "MqttSession.h"
+#include "EventLog.h"
+#include "RtcState.h"
+#include <stddef.h>
+#include <string.h>
+
+static_assert(offsetof(MqttSessionState, count) == 12, "MqttSessionState header must keep its layout");
+
+MqttSession::MqttSession(MqttSessionState &state) : _state(state) {
+  // An older version still has its count where it always was, its records not
+  bool older = RtcState::isOlderVersion(_state.magic, MAGIC);
+  uint8_t held = _state.count;
+  if (RtcState::adopt(_state, MAGIC, held <= MqttSessionState::MAX_IN_FLIGHT)) {
+    return;
+  }
+
+  uint8_t lost = older && held <= MqttSessionState::MAX_IN_FLIGHT ? held : 0;
+  _state.lost = lost;
+  if (lost > 0) {
+    LOG_WARN("MqttSession: %u queued reading(s) lost to a layout change", static_cast<unsigned>(lost));
+  }
+}
+
+MqttInFlight &MqttSession::enqueue(const WeatherData &data) {
+  if (_state.count == MqttSessionState::MAX_IN_FLIGHT) {
+    memmove(&_state.records[0], &_state.records[1], sizeof(MqttInFlight) * (_state.count - 1));
+    _state.count--;
+  }
+
+  MqttInFlight &record = _state.records[_state.count++];
+  record.packetId = nextPacketId();
+  record.sent = false;
+  record.data = data;
+  record.data.epoch = _state.epoch;
+  record.data.sequence = ++_state.lastSequence;
+  return record;
+}
+
+bool MqttSession::acknowledge(uint16_t packetId) {
+  for (uint8_t i = 0; i < _state.count; i++) {
+    if (_state.records[i].packetId == packetId) {
+      memmove(&_state.records[i], &_state.records[i + 1], sizeof(MqttInFlight) * (_state.count - i - 1));
+      _state.count--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void MqttSession::clear() { _state.count = 0; }
+
+uint16_t MqttSession::nextPacketId() {
+  // Packet ID 0 is reserved; skip IDs still in flight after a wrap-around
+  while (true) {
+    if (++_state.lastPacketId == 0) {
+      _state.lastPacketId = 1;
+    }
+
+    bool inUse = false;
+    for (uint8_t i = 0; i < _state.count; i++) {
+      if (_state.records[i].packetId == _state.lastPacketId) {
+        inUse = true;
+        break;
+      }
+    }
+    if (!inUse) {
+      return _state.lastPacketId;
+    }
+  }
+}
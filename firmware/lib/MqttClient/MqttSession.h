@@ -0,0 +1,65 @@
+/*
+ * MqttSession.h
+ * QoS 1 in-flight message tracking that survives deep sleep
+ */
+
+#ifndef MQTT_SESSION_H
+#define MQTT_SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "WeatherData.h"
+
+struct MqttInFlight {
+    uint16_t packetId;
+    bool sent;  // Sent at least once, so resends carry the DUP flag
+    WeatherData data;
+};
+
+// In RTC memory across deep sleep (see RtcState.h). The fields before
+// records keep their layout across versions, so that a state of an older
+// version can still tell how many readings it held when it is reset.
+struct MqttSessionState {
+    static const uint8_t MAX_IN_FLIGHT = 8;
+
+    uint32_t magic;
+    uint16_t lastPacketId;
+    uint32_t lastSequence;
+    uint8_t count;
+    uint32_t epoch;    // Starts of the session, kept in NVS (0 = not assigned yet)
+    uint16_t lost;     // Queued readings the reset of an older layout dropped
+    MqttInFlight records[MAX_IN_FLIGHT];
+};
+
+class MqttSession {
+public:
+    static const uint32_t MAGIC = 0x4D515338;  // "MQS8"
+
+    // Readings queued in a state of an older version are counted in lost
+    // and logged, as they cannot be read back
+    explicit MqttSession(MqttSessionState& state);
+
+    // Sequence numbers restart with the state: the epoch, assigned once per
+    // session start, makes (epoch, sequence) unique for the station
+    uint32_t epoch() const { return _state.epoch; }
+    void setEpoch(uint32_t epoch) { _state.epoch = epoch; }
+    uint16_t lost() const { return _state.lost; }
+
+    // Queue a reading with a fresh packet ID and sequence number; with the
+    // epoch, its dedup key. When the queue is full the oldest record is evicted.
+    MqttInFlight& enqueue(const WeatherData& data);
+
+    // Remove the record acknowledged by a PUBACK; false if the ID is unknown
+    bool acknowledge(uint16_t packetId);
+
+    uint8_t count() const { return _state.count; }
+    MqttInFlight& at(uint8_t index) { return _state.records[index]; }
+    void clear();
+
+private:
+    MqttSessionState& _state;
+
+    uint16_t nextPacketId();
+};
+
+#endif // MQTT_SESSION_H
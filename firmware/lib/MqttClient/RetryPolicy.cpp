@@ -0,0 +1,103 @@
+#include "RetryPolicy.h"
+#include "RtcState.h"
+#include <string.h>
+
+// mbedTLS errors for a certificate rejected on either side of the handshake
+static const int TLS_ERR_FATAL_ALERT = -0x7780;   // MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE
+static const int TLS_ERR_VERIFY_FAILED = -0x2700; // MBEDTLS_ERR_X509_CERT_VERIFY_FAILED
+
+static bool isCertificateRejected(int tlsError, uint8_t tlsAlert) {
+  if (tlsError == TLS_ERR_VERIFY_FAILED) {
+    return true;
+  }
+  if (tlsError != TLS_ERR_FATAL_ALERT) {
+    return false;
+  }
+  switch (tlsAlert) { // RFC 5246, 7.2
+  case 42:            // bad_certificate
+  case 43:            // unsupported_certificate
+  case 44:            // certificate_revoked
+  case 45:            // certificate_expired
+  case 46:            // certificate_unknown
+  case 48:            // unknown_ca
+    return true;
+  default:
+    return false;
+  }
+}
+
+RetryPolicy::RetryPolicy(RetryPolicyState &state) : _state(state) {
+  RtcState::adopt(_state, MAGIC);
+}
+
+FailureClass RetryPolicy::classify(int mqttState, bool networkUp, int tlsError, uint8_t tlsAlert) {
+  if (mqttState != 0 && isCertificateRejected(tlsError, tlsAlert)) {
+    return FAILURE_PERSISTENT;
+  }
+  switch (mqttState) {
+  case 0:
+    return FAILURE_NONE;
+  case 1: // Bad protocol
+  case 2: // Bad client ID
+  case 4: // Bad credentials
+  case 5: // Unauthorized
+    return FAILURE_PERSISTENT;
+  default:
+    // Timeouts, socket errors and "unavailable" are only worth retrying with a network
+    return networkUp ? FAILURE_TRANSIENT : FAILURE_ENVIRONMENTAL;
+  }
+}
+
+int RetryPolicy::maxRetries(FailureClass failure) {
+  switch (failure) {
+  case FAILURE_TRANSIENT:
+    return MAX_TRANSIENT_RETRIES;
+  case FAILURE_ENVIRONMENTAL:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+unsigned long RetryPolicy::backoffMs(FailureClass failure, int attempt) {
+  switch (failure) {
+  case FAILURE_TRANSIENT:
+    return 1000UL * attempt;
+  case FAILURE_ENVIRONMENTAL:
+    return 5000UL; // Give the WiFi stack time to re-associate
+  default:
+    return 0;
+  }
+}
+
+bool RetryPolicy::startWake() {
+  if (_state.skipWakes == 0) {
+    return true;
+  }
+  _state.skipWakes--;
+  return false;
+}
+
+void RetryPolicy::recordSuccess() {
+  _state.persistentFailures = 0;
+  _state.skipWakes = 0;
+}
+
+void RetryPolicy::recordFailure(FailureClass failure) {
+  if (failure != FAILURE_PERSISTENT) {
+    return;
+  }
+
+  if (_state.persistentFailures < UINT8_MAX) {
+    _state.persistentFailures++;
+  }
+  if (_state.persistentFailures < TRIP_THRESHOLD) {
+    return;
+  }
+
+  // Double the skipped wakes every time a half-open attempt fails again
+  uint8_t exponent = _state.persistentFailures - TRIP_THRESHOLD;
+  uint32_t skip = exponent < 16 ? (1UL << exponent) : MAX_SKIP_WAKES;
+  _state.skipWakes = skip > MAX_SKIP_WAKES ? MAX_SKIP_WAKES : skip;
+  _state.trips++;
+}
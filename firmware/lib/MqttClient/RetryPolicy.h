@@ -0,0 +1,64 @@
+/*
+ * RetryPolicy.h
+ * Failure classification, per-class backoff and a circuit breaker that survives deep sleep
+ */
+
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include <stdint.h>
+
+enum FailureClass {
+    FAILURE_NONE = 0,
+    FAILURE_TRANSIENT,      // Timeouts, lost connections, broker unavailable: retry with backoff
+    FAILURE_PERSISTENT,     // Broker rejected the client (certificate, client ID): retrying won't help
+    FAILURE_ENVIRONMENTAL   // No network underneath: leave it to the WiFi layer
+};
+
+// In RTC memory across deep sleep (see RtcState.h)
+struct RetryPolicyState {
+    uint32_t magic;
+    uint8_t persistentFailures;  // Consecutive wakes that ended in a persistent failure
+    uint8_t fragmentRefused;     // The broker refused TLS max_fragment_length: don't ask again
+    uint16_t skipWakes;          // Wakes left before the breaker lets one attempt through
+    uint32_t trips;              // Times the breaker has opened since cold boot
+};
+
+class RetryPolicy {
+public:
+    static const uint32_t MAGIC = 0x52545032;  // "RTP2"
+    static const int MAX_TRANSIENT_RETRIES = 3;
+    static const uint8_t TRIP_THRESHOLD = 2;    // Persistent failures before the breaker opens
+    static const uint16_t MAX_SKIP_WAKES = 96;  // Cap on the exponential skip (~1 day at 15 min)
+
+    explicit RetryPolicy(RetryPolicyState& state);
+
+    // Map a PubSubClient state() code to a failure class. With mTLS the broker
+    // rejects a bad, revoked or unknown client certificate in the handshake,
+    // before MQTT: pass the SecureClient's last TLS error and alert as well.
+    static FailureClass classify(int mqttState, bool networkUp, int tlsError = 0, uint8_t tlsAlert = 0);
+
+    // Retries allowed after the first attempt, and the delay before retry N (1-based)
+    static int maxRetries(FailureClass failure);
+    static unsigned long backoffMs(FailureClass failure, int attempt);
+
+    // Called once per wake: counts down an open breaker. Returns true when
+    // connection attempts are allowed during this wake.
+    bool startWake();
+
+    bool isOpen() const { return _state.skipWakes > 0; }
+    uint16_t getSkipWakes() const { return _state.skipWakes; }
+
+    // A broker that refused max_fragment_length once is not asked again
+    // until the next cold boot
+    bool isFragmentRefused() const { return _state.fragmentRefused != 0; }
+    void recordFragmentRefused() { _state.fragmentRefused = 1; }
+
+    void recordSuccess();
+    void recordFailure(FailureClass failure);
+
+private:
+    RetryPolicyState& _state;
+};
+
+#endif // RETRY_POLICY_H
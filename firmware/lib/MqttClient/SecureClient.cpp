@@ -0,0 +1,462 @@
+#include "SecureClient.h"
+#include "EventLog.h"
+
+// The allowlist is small on purpose: every extra suite and curve lengthens the
+// ClientHello, and the server picks the first match in its own order. ECDHE-ECDSA
+// comes first: with a P-256 server certificate the whole handshake stays on one
+// curve, and ECDSA verification is much cheaper than RSA on the C3. AES-256 and
+// SHA-384 suites are left out, they only add cost at this security level.
+const int SecureClient::DEFAULT_CIPHERSUITES[] = {
+    0xC02B, // TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256
+    0xCCA9, // TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256
+    0xC02F, // TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256
+    0xCCA8, // TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256
+    0,
+};
+
+// X25519 is the cheapest ECDHE; P-256 is kept for brokers without it
+const uint16_t SecureClient::DEFAULT_CURVES[] = {
+    TLS_GROUP_X25519,
+    TLS_GROUP_SECP256R1,
+    0,
+};
+
+int SecureClient::connect(IPAddress ip, uint16_t port) { return open(&ip, nullptr, port); }
+
+int SecureClient::connect(const char *host, uint16_t port) { return open(nullptr, host, port); }
+
+int SecureClient::open(const IPAddress *ip, const char *host, uint16_t port) {
+  if (handshake(ip, host, port)) {
+    return 1;
+  }
+
+  // Some servers honour max_fragment_length with handshake messages split
+  // across records, which mbedTLS can't reassemble, or ignore it. Other
+  // failures (aborts, resets) go to the caller's retry policy as they are.
+  if (_maxFragmentLength == 0 || _fragmentRefused || !isFragmentError(_lastTlsError)) {
+    return 0;
+  }
+  LOG_WARN("SecureClient: max_fragment_length refused, retrying without it");
+  _fragmentRefused = true;
+  return handshake(ip, host, port) ? 1 : 0;
+}
+
+void SecureClient::sampleHeap() {
+  uint32_t free = ESP.getFreeHeap();
+  if (free < _heapLowest) {
+    _heapLowest = free;
+  }
+  _heapPeak = _heapBefore - _heapLowest;
+}
+
+#ifdef TLS_USE_MBEDTLS_TRANSPORT
+// Real mbedTLS implementation for ESP32 (and native benchmarks)
+#include <mbedtls/ecp.h>
+#include <mbedtls/net_sockets.h>
+
+static const char *DRBG_PERSONALIZATION = "tarameteo";
+
+SecureClient::SecureClient()
+    : _credentials(nullptr), _connected(false), _handshakes(0), _lastTlsError(0), _lastTlsAlert(0), _ciphersuites(DEFAULT_CIPHERSUITES),
+      _curves(DEFAULT_CURVES), _bytesSent(0), _bytesReceived(0), _maxFragmentLength(DEFAULT_MAX_FRAGMENT_LENGTH),
+      _fragmentRefused(false), _heapBefore(0), _heapLowest(0), _heapPeak(0), _sessionReuse(true), _hasSession(false),
+      _resumed(false), _resumedHandshakes(0), _rngSeeded(false) {
+  mbedtls_ssl_init(&_ssl);
+  mbedtls_ssl_config_init(&_conf);
+  mbedtls_ssl_session_init(&_session);
+  mbedtls_entropy_init(&_entropy);
+  mbedtls_ctr_drbg_init(&_drbg);
+}
+
+SecureClient::~SecureClient() {
+  stop();
+  mbedtls_ssl_session_free(&_session);
+  mbedtls_ctr_drbg_free(&_drbg);
+  mbedtls_entropy_free(&_entropy);
+}
+
+static unsigned char maxFragmentLengthCode(uint16_t length) {
+  switch (length) {
+  case 512:
+    return MBEDTLS_SSL_MAX_FRAG_LEN_512;
+  case 1024:
+    return MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+  case 2048:
+    return MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+  case 4096:
+    return MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+  default:
+    return MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+  }
+}
+
+bool SecureClient::handshake(const IPAddress *ip, const char *host, uint16_t port) {
+  _lastTlsError = 0;
+  _lastTlsAlert = 0;
+  if (!_credentials || !_credentials->isLoaded()) {
+    _lastTlsError = MBEDTLS_ERR_SSL_NO_CLIENT_CERTIFICATE;
+    return false;
+  }
+  if (!(ip ? _tcp.connect(*ip, port) : _tcp.connect(host, port))) {
+    return false;
+  }
+  _heapBefore = ESP.getFreeHeap();
+  _heapLowest = _heapBefore;
+
+  // The DRBG is seeded once per wake, like the credentials are parsed once
+  if (!_rngSeeded) {
+    _lastTlsError = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                                          (const unsigned char *)DRBG_PERSONALIZATION, strlen(DRBG_PERSONALIZATION));
+    if (_lastTlsError != 0) {
+      _tcp.stop();
+      return false;
+    }
+    _rngSeeded = true;
+  }
+
+  _lastTlsError = mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                              MBEDTLS_SSL_PRESET_DEFAULT);
+  if (_lastTlsError != 0) {
+    stop();
+    return false;
+  }
+
+  if (_credentials->hasCA()) {
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ca_chain(&_conf, _credentials->caChain(), NULL);
+  } else {
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_NONE);
+  }
+  mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+  mbedtls_ssl_conf_ciphersuites(&_conf, _ciphersuites);
+
+  // Map TLS named groups to mbedTLS curve IDs, skipping ones compiled out
+  size_t curveCount = 0;
+  for (const uint16_t *group = _curves; *group != 0 && curveCount < MAX_CURVES; group++) {
+    const mbedtls_ecp_curve_info *info = mbedtls_ecp_curve_info_from_tls_id(*group);
+    if (info) {
+      _curveIds[curveCount++] = info->grp_id;
+    }
+  }
+  _curveIds[curveCount] = MBEDTLS_ECP_DP_NONE;
+  mbedtls_ssl_conf_curves(&_conf, _curveIds);
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+  if (!_fragmentRefused) {
+    mbedtls_ssl_conf_max_frag_len(&_conf, maxFragmentLengthCode(_maxFragmentLength));
+  }
+#endif
+
+  _lastTlsError = mbedtls_ssl_conf_own_cert(&_conf, _credentials->certificate(), _credentials->privateKey());
+  if (_lastTlsError != 0) {
+    stop();
+    return false;
+  }
+
+  _lastTlsError = mbedtls_ssl_setup(&_ssl, &_conf);
+  if (_lastTlsError == 0 && host) {
+    _lastTlsError = mbedtls_ssl_set_hostname(&_ssl, host);
+  }
+  if (_lastTlsError == 0 && _sessionReuse && _hasSession) {
+    _lastTlsError = mbedtls_ssl_set_session(&_ssl, &_session);
+  }
+  if (_lastTlsError != 0) {
+    stop();
+    return false;
+  }
+  mbedtls_ssl_set_bio(&_ssl, this, sendCallback, recvCallback, NULL);
+  sampleHeap(); // Record buffers are allocated by mbedtls_ssl_setup()
+
+  unsigned long start = millis();
+  while ((_lastTlsError = mbedtls_ssl_handshake(&_ssl)) != 0) {
+    sampleHeap();
+    if (_lastTlsError != MBEDTLS_ERR_SSL_WANT_READ && _lastTlsError != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      if (_lastTlsError == MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE) {
+        _lastTlsAlert = _ssl.in_msg[1]; // Level, description
+      }
+      stop();
+      return false;
+    }
+    if (millis() - start > HANDSHAKE_TIMEOUT_MS) {
+      stop();
+      return false;
+    }
+    delay(1);
+  }
+
+  sampleHeap();
+  saveSession();
+  _handshakes++;
+  _connected = true;
+  return true;
+}
+
+void SecureClient::saveSession() {
+  mbedtls_ssl_session fresh;
+  mbedtls_ssl_session_init(&fresh);
+  if (mbedtls_ssl_get_session(&_ssl, &fresh) != 0) {
+    mbedtls_ssl_session_free(&fresh);
+    _resumed = false;
+    return;
+  }
+
+  // A resuming server echoes the offered session ID; a new session gets a new one
+  _resumed = _sessionReuse && _hasSession && fresh.id_len > 0 && fresh.id_len == _session.id_len &&
+             memcmp(fresh.id, _session.id, fresh.id_len) == 0;
+  if (_resumed) {
+    _resumedHandshakes++;
+  }
+
+  // Take over the fresh session's buffers
+  mbedtls_ssl_session_free(&_session);
+  _session = fresh;
+  _hasSession = true;
+}
+
+bool SecureClient::isFragmentError(int error) {
+  switch (error) {
+  case MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE: // Handshake message split across records
+  case MBEDTLS_ERR_SSL_INVALID_RECORD:      // Record larger than the negotiated limit
+    return true;
+  default:
+    return false;
+  }
+}
+
+int SecureClient::sendCallback(void *ctx, const unsigned char *buf, size_t len) {
+  SecureClient *self = static_cast<SecureClient *>(ctx);
+  size_t written = self->_tcp.write(buf, len);
+  if (written == 0) {
+    return self->_tcp.connected() ? MBEDTLS_ERR_SSL_WANT_WRITE : MBEDTLS_ERR_NET_CONN_RESET;
+  }
+  self->_bytesSent += written;
+  return static_cast<int>(written);
+}
+
+int SecureClient::recvCallback(void *ctx, unsigned char *buf, size_t len) {
+  SecureClient *self = static_cast<SecureClient *>(ctx);
+  if (!self->_tcp.available()) {
+    return self->_tcp.connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+  }
+  int n = self->_tcp.read(buf, len);
+  if (n <= 0) {
+    return MBEDTLS_ERR_SSL_WANT_READ;
+  }
+  self->_bytesReceived += n;
+  return n;
+}
+
+size_t SecureClient::write(const uint8_t *buf, size_t size) {
+  if (!_connected) {
+    return 0;
+  }
+
+  // A stalled server keeps the socket connected while it takes no more
+  // bytes: give up after a while rather than keep the chip awake
+  size_t written = 0;
+  unsigned long start = millis();
+  while (written < size) {
+    int ret = mbedtls_ssl_write(&_ssl, buf + written, size - written);
+    if (ret > 0) {
+      written += ret;
+      continue;
+    }
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      _lastTlsError = ret;
+      stop();
+      break;
+    }
+    if (millis() - start > WRITE_TIMEOUT_MS) {
+      _lastTlsError = MBEDTLS_ERR_SSL_TIMEOUT;
+      stop();
+      break;
+    }
+    delay(1);
+  }
+  return written;
+}
+
+int SecureClient::available() {
+  if (!_connected) {
+    return 0;
+  }
+
+  // A zero-length read makes mbedTLS decrypt a pending record, if any
+  int ret = mbedtls_ssl_read(&_ssl, NULL, 0);
+  if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+    _lastTlsError = ret;
+    stop();
+    return 0;
+  }
+  return static_cast<int>(mbedtls_ssl_get_bytes_avail(&_ssl));
+}
+
+int SecureClient::read() {
+  uint8_t byte;
+  return read(&byte, 1) == 1 ? byte : -1;
+}
+
+int SecureClient::read(uint8_t *buf, size_t size) {
+  if (!_connected) {
+    return -1;
+  }
+
+  int ret = mbedtls_ssl_read(&_ssl, buf, size);
+  if (ret > 0) {
+    return ret;
+  }
+  if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+    _lastTlsError = ret;
+    stop();
+  }
+  return -1;
+}
+
+void SecureClient::stop() {
+  if (_connected) {
+    mbedtls_ssl_close_notify(&_ssl);
+    _connected = false;
+  }
+  mbedtls_ssl_free(&_ssl);
+  mbedtls_ssl_config_free(&_conf);
+  mbedtls_ssl_init(&_ssl);
+  mbedtls_ssl_config_init(&_conf);
+  _tcp.stop();
+}
+
+uint8_t SecureClient::connected() {
+  if (_connected && !_tcp.connected() && !available()) {
+    stop();
+  }
+  return _connected;
+}
+
+const char *SecureClient::getCiphersuite() { return _connected ? mbedtls_ssl_get_ciphersuite(&_ssl) : nullptr; }
+
+uint16_t SecureClient::getRecordLimit() {
+  if (!_connected) {
+    return 0;
+  }
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+  return static_cast<uint16_t>(mbedtls_ssl_get_input_max_frag_len(&_ssl));
+#else
+  return MAX_RECORD_LENGTH;
+#endif
+}
+
+#else
+// Mock implementation for unit tests
+// In tests, the handshake is a two-byte hello answered with the handshake's
+// error and alert, and bytes then pass straight through to the mock WiFiClient (and
+// therefore to an attached MockBroker).
+
+static const uint8_t MOCK_HELLO = 0x16;
+static const uint8_t MOCK_HELLO_MAX_FRAGMENT_LENGTH = 0x01;
+static const int MOCK_ERR_FRAGMENT_REFUSED = -0x7080; // MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE
+
+SecureClient::SecureClient()
+    : _credentials(nullptr), _connected(false), _handshakes(0), _lastTlsError(0), _lastTlsAlert(0), _ciphersuites(DEFAULT_CIPHERSUITES),
+      _curves(DEFAULT_CURVES), _bytesSent(0), _bytesReceived(0), _maxFragmentLength(DEFAULT_MAX_FRAGMENT_LENGTH),
+      _fragmentRefused(false), _heapBefore(0), _heapLowest(0), _heapPeak(0), _sessionReuse(true), _hasSession(false),
+      _resumed(false), _resumedHandshakes(0) {}
+
+SecureClient::~SecureClient() {}
+
+bool SecureClient::handshake(const IPAddress *ip, const char *host, uint16_t port) {
+  _lastTlsError = 0;
+  _lastTlsAlert = 0;
+  if (!_credentials || !_credentials->isLoaded()) {
+    _lastTlsError = -1;
+    return false;
+  }
+  if (!(ip ? _tcp.connect(*ip, port) : _tcp.connect(host, port))) {
+    return false;
+  }
+  _heapBefore = ESP.getFreeHeap();
+  _heapLowest = _heapBefore;
+  sampleHeap();
+
+  // An empty allowlist can never be negotiated
+  if (_ciphersuites[0] == 0 || _curves[0] == 0) {
+    _lastTlsError = -1;
+    _tcp.stop();
+    return false;
+  }
+
+  uint8_t hello[2] = {MOCK_HELLO, 0};
+  if (_maxFragmentLength > 0 && !_fragmentRefused) {
+    hello[1] |= MOCK_HELLO_MAX_FRAGMENT_LENGTH;
+  }
+  _tcp.write(hello, sizeof(hello));
+  // Nothing answers when no broker is listening
+  if (_tcp.available() >= 3) {
+    uint8_t answer[3];
+    _tcp.read(answer, sizeof(answer));
+    _lastTlsError = -((answer[0] << 8) | answer[1]);
+    _lastTlsAlert = answer[2];
+  }
+  if (_lastTlsError != 0) {
+    _tcp.stop();
+    return false;
+  }
+
+  // Like the broker, the mock resumes whenever the client offers a session
+  _resumed = _sessionReuse && _hasSession;
+  if (_resumed) {
+    _resumedHandshakes++;
+  }
+  _hasSession = true;
+  _handshakes++;
+  _connected = true;
+  return true;
+}
+
+bool SecureClient::isFragmentError(int error) { return error == MOCK_ERR_FRAGMENT_REFUSED; }
+
+size_t SecureClient::write(const uint8_t *buf, size_t size) {
+  size_t written = _connected ? _tcp.write(buf, size) : 0;
+  _bytesSent += written;
+  return written;
+}
+
+int SecureClient::available() { return _connected ? _tcp.available() : 0; }
+
+int SecureClient::read() {
+  int byte = _connected ? _tcp.read() : -1;
+  if (byte >= 0) {
+    _bytesReceived++;
+  }
+  return byte;
+}
+
+int SecureClient::read(uint8_t *buf, size_t size) {
+  int n = _connected ? _tcp.read(buf, size) : -1;
+  if (n > 0) {
+    _bytesReceived += n;
+  }
+  return n;
+}
+
+void SecureClient::stop() {
+  _connected = false;
+  _tcp.stop();
+}
+
+uint8_t SecureClient::connected() {
+  if (_connected && !_tcp.connected()) {
+    _connected = false;
+  }
+  return _connected;
+}
+
+// No cipher suite is negotiated in tests
+const char *SecureClient::getCiphersuite() { return nullptr; }
+
+uint16_t SecureClient::getRecordLimit() {
+  if (!_connected) {
+    return 0;
+  }
+  return _maxFragmentLength > 0 && !_fragmentRefused ? _maxFragmentLength : MAX_RECORD_LENGTH;
+}
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * SecureClient.h
+ * TLS client over WiFiClient that borrows pre-parsed credentials
+ */
+
+#ifndef SECURE_CLIENT_H
+#define SECURE_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <WiFiClient.h>
+#include "IWiFiClient.h"
+#include "TlsCredentials.h"
+
+#ifdef TLS_USE_MBEDTLS_TRANSPORT
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ssl.h>
+#endif
+
+// Unlike WiFiClientSecure, which re-parses the PEM certificate, key and CA on
+// every connect(), this client references a TlsCredentials handle that stays
+// parsed for the whole wake. Only the handshake itself is repeated.
+class SecureClient : public Client {
+public:
+    static const unsigned long HANDSHAKE_TIMEOUT_MS = 10000;
+    static const unsigned long WRITE_TIMEOUT_MS = 5000;
+    static const size_t MAX_CURVES = 4;
+    static const uint16_t DEFAULT_MAX_FRAGMENT_LENGTH = 0;
+    static const uint16_t MAX_RECORD_LENGTH = 16384;
+
+    // TLS named groups (IANA), used for the curve allowlist
+    static const uint16_t TLS_GROUP_SECP256R1 = 23;
+    static const uint16_t TLS_GROUP_SECP384R1 = 24;
+    static const uint16_t TLS_GROUP_X25519 = 29;
+
+    // Zero-terminated defaults: ECDHE with AES-128-GCM or ChaCha20-Poly1305 only,
+    // key exchange on X25519 or P-256. See DEFAULT_CIPHERSUITES in the .cpp.
+    static const int DEFAULT_CIPHERSUITES[];
+    static const uint16_t DEFAULT_CURVES[];
+
+    SecureClient();
+    ~SecureClient();
+
+    void setCredentials(const TlsCredentials* credentials) {
+        _credentials = credentials;
+        _hasSession = false;
+    }
+
+    // Zero-terminated allowlists in preference order (IANA cipher suite IDs
+    // and TLS named groups); nullptr restores the defaults. Unknown or
+    // compiled-out entries are skipped by mbedTLS.
+    void setCiphersuites(const int* ciphersuites) { _ciphersuites = ciphersuites ? ciphersuites : DEFAULT_CIPHERSUITES; }
+    void setCurves(const uint16_t* curves) { _curves = curves ? curves : DEFAULT_CURVES; }
+
+    // Ask the server for records of at most 512, 1024, 2048 or 4096 bytes
+    // (max_fragment_length); 0, the default, disables it. Where mbedTLS is
+    // built with variable or asymmetric buffers, the record buffers shrink
+    // accordingly. The server's certificate chain must then fit in one record:
+    // mbedTLS can't reassemble a handshake message split across records. A
+    // server that refuses the extension gets one retry without it, and it
+    // stays off from then on; the caller may carry that over to later wakes.
+    void setMaxFragmentLength(uint16_t length) { _maxFragmentLength = length; }
+    void setMaxFragmentLengthRefused() { _fragmentRefused = true; }
+    bool isMaxFragmentLengthRefused() const { return _fragmentRefused; }
+
+    // Offer the previous connection's session on reconnect, so the server can
+    // resume it with an abbreviated handshake: no certificates, no key
+    // exchange, no signatures. The session is kept in this object, i.e. for
+    // one wake.
+    void setSessionReuse(bool enabled) { _sessionReuse = enabled; }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t byte) override { return write(&byte, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override { return -1; }
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    int getHandshakeCount() const { return _handshakes; }
+    int getResumedCount() const { return _resumedHandshakes; }
+    bool isResumed() const { return _resumed; }
+    int getLastTlsError() const { return _lastTlsError; }
+    // Description of the fatal alert the server ended the last handshake with, 0 if none
+    uint8_t getLastTlsAlert() const { return _lastTlsAlert; }
+
+    // Negotiated suite and incoming record limit of the current connection,
+    // bytes on the wire since construction, and the heap used by the last
+    // handshake at its peak
+    const char* getCiphersuite();
+    uint16_t getRecordLimit();
+    size_t getHandshakeHeapPeak() const { return _heapPeak; }
+    size_t getBytesSent() const { return _bytesSent; }
+    size_t getBytesReceived() const { return _bytesReceived; }
+
+private:
+    WiFiClient _tcp;
+    const TlsCredentials* _credentials;
+    bool _connected;
+    int _handshakes;
+    int _lastTlsError;
+    uint8_t _lastTlsAlert;
+    const int* _ciphersuites;
+    const uint16_t* _curves;
+    size_t _bytesSent;
+    size_t _bytesReceived;
+    uint16_t _maxFragmentLength;
+    bool _fragmentRefused;
+    uint32_t _heapBefore;
+    uint32_t _heapLowest;
+    size_t _heapPeak;
+    bool _sessionReuse;
+    bool _hasSession;
+    bool _resumed;
+    int _resumedHandshakes;
+
+    int open(const IPAddress* ip, const char* host, uint16_t port);
+    bool handshake(const IPAddress* ip, const char* host, uint16_t port);
+    static bool isFragmentError(int error);
+    void sampleHeap();
+
+#ifdef TLS_USE_MBEDTLS_TRANSPORT
+    mbedtls_ssl_context _ssl;
+    mbedtls_ssl_config _conf;
+    mbedtls_entropy_context _entropy;
+    mbedtls_ctr_drbg_context _drbg;
+    mbedtls_ecp_group_id _curveIds[MAX_CURVES + 1];
+    mbedtls_ssl_session _session;
+    bool _rngSeeded;
+
+    void saveSession();
+    static int sendCallback(void* ctx, const unsigned char* buf, size_t len);
+    static int recvCallback(void* ctx, unsigned char* buf, size_t len);
+#endif
+
+    SecureClient(const SecureClient&);
+    SecureClient& operator=(const SecureClient&);
+};
+
+// IWiFiClient adapter so that CertificateManager can hand over its credentials
+class SecureClientAdapter : public IWiFiClient {
+public:
+    SecureClientAdapter(SecureClient& client) : _client(client) {}
+
+    // PEM strings are not accepted: credentials are always borrowed pre-parsed
+    void setCACert(const char* rootCA) override { (void)rootCA; }
+    void setCertificate(const char* client_ca) override { (void)client_ca; }
+    void setPrivateKey(const char* private_key) override { (void)private_key; }
+
+    bool supportsCredentials() const override { return true; }
+    void setCredentials(const TlsCredentials& credentials) override { _client.setCredentials(&credentials); }
+
+private:
+    SecureClient& _client;
+};
+
+#endif // SECURE_CLIENT_H
@@ -0,0 +1,17 @@
+#ifndef WEATHER_DATA_H
+#define WEATHER_DATA_H
+
+#include <stdint.h>
+#include "Measurements.h"
+
+struct WeatherData {
+    Measurements measurements;  // Whatever the registered sensors sampled
+    int rssi;
+    unsigned long timestamp;
+    int retryCount;
+    unsigned long nextWake;  // Expected timestamp of the next reading (0 = unknown)
+    uint32_t sequence;       // QoS 1 resends: with epoch, the station's dedup key (0 = none)
+    uint32_t epoch;          // Session the sequence number belongs to
+};
+
+#endif // WEATHER_DATA_H
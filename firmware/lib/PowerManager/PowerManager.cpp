@@ -1,27 +1,101 @@
 #include "PowerManager.h"
+#include "EventLog.h"
 #include <cstring>
+#include <sys/time.h>
 
-PowerManager::PowerManager(unsigned long sleepDurationSeconds) : _sleepDuration(sleepDurationSeconds) {
+PowerManager::PowerManager(unsigned long sleepDurationSeconds)
+    : _sleepDuration(sleepDurationSeconds), _pulses(nullptr), _batteryPin(-1), _batteryScale(1000),
+      _batteryOffset(0), _batterySamples(DEFAULT_BATTERY_SAMPLES), _batteryMv(0), _policy() {
   _lastError[0] = '\0';
 }
 
 bool PowerManager::begin() {
-  esp_sleep_enable_timer_wakeup(_sleepDuration * 1000000ULL); // Convert to microseconds
+  esp_sleep_enable_timer_wakeup(getSleepDuration() * 1000000ULL); // Convert to microseconds
   return true;
 }
 
+void PowerManager::setBattery(int8_t pin, uint16_t scalePermille, int16_t offsetMv, uint8_t samples) {
+  _batteryPin = pin;
+  _batteryScale = scalePermille;
+  _batteryOffset = offsetMv;
+  _batterySamples = samples < 1 ? 1 : (samples > MAX_BATTERY_SAMPLES ? MAX_BATTERY_SAMPLES : samples);
+}
+
+uint16_t PowerManager::readBattery() {
+  _batteryMv = 0;
+  if (_batteryPin < 0) {
+    return 0;
+  }
+
+  // analogReadMilliVolts applies the ADC's factory calibration
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < _batterySamples; i++) {
+    sum += analogReadMilliVolts(_batteryPin);
+  }
+  uint32_t pinMv = (sum + _batterySamples / 2) / _batterySamples;
+  int32_t mv = static_cast<int32_t>((pinMv * _batteryScale + 500) / 1000) + _batteryOffset;
+  _batteryMv = static_cast<uint16_t>(mv < 1 ? 1 : (mv > UINT16_MAX ? UINT16_MAX : mv));
+  return _batteryMv;
+}
+
+unsigned long PowerManager::getSleepDuration() const {
+  if (below(_policy.lowMv) && _policy.sleepFactor > 1) {
+    return _sleepDuration * _policy.sleepFactor;
+  }
+  return _sleepDuration;
+}
+
+uint64_t PowerManager::rtcMicros() {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000ULL + now.tv_usec;
+}
+
 void PowerManager::prepareForSleep() {
-  Serial.println("Preparing for deep sleep...");
+  LOG_DEBUG("Preparing for deep sleep...");
   // Add any cleanup needed before sleep
   // For example: close files, disconnect peripherals, etc.
 }
 
 void PowerManager::sleep() {
   prepareForSleep();
-  Serial.println("Entering deep sleep...");
+  if (_pulses) {
+    // Wakeup sources do not survive a deep sleep: set the timer here too, in
+    // case begin() has not run this boot, and start the interval that pulse
+    // wakes sleep out
+    esp_sleep_enable_timer_wakeup(getSleepDuration() * 1000000ULL);
+    _pulses->startInterval(rtcMicros(), getSleepDuration() * 1000000ULL);
+    armPulseWake();
+  }
+  LOG_DEBUG("Entering deep sleep...");
+#ifdef LOG_SERIAL
+  Serial.flush();
+#endif
   esp_deep_sleep_start();
 }
 
+void PowerManager::sleepRemaining() {
+  // No logging: this is the pulse wake fast path
+  uint64_t remaining = _pulses ? _pulses->remainingUs(rtcMicros()) : 0;
+  esp_sleep_enable_timer_wakeup(remaining > 0 ? remaining : 1);
+  armPulseWake();
+  esp_deep_sleep_start();
+}
+
+void PowerManager::armPulseWake() {
+  if (!_pulses || _pulses->count() == 0) {
+    return;
+  }
+  uint64_t lowMask, highMask;
+  _pulses->arm(_pulses->readLevels(), lowMask, highMask);
+  if (lowMask) {
+    esp_deep_sleep_enable_gpio_wakeup(lowMask, ESP_GPIO_WAKEUP_GPIO_LOW);
+  }
+  if (highMask) {
+    esp_deep_sleep_enable_gpio_wakeup(highMask, ESP_GPIO_WAKEUP_GPIO_HIGH);
+  }
+}
+
 void PowerManager::updateLastError(const char *error) {
   strncpy(_lastError, error, sizeof(_lastError) - 1);
   _lastError[sizeof(_lastError) - 1] = '\0';
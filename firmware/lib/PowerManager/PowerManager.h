@@ -3,27 +3,80 @@
 
 #include <Arduino.h>
 #include <esp_sleep.h>
+#include "PulseCounter.h"
+
+// Battery thresholds in mV below which the station saves energy; 0 disables
+// a threshold. Below lowMv it sleeps sleepFactor times longer, below noNtpMv
+// it keeps the RTC time instead of syncing, below noRetryMv a failed publish
+// waits for the next wake, and below criticalMv it does not start the radio
+// at all (a WiFi connect draws enough to brown out a nearly flat cell).
+struct EnergyPolicy {
+    uint16_t lowMv;
+    uint8_t sleepFactor;
+    uint16_t noNtpMv;
+    uint16_t noRetryMv;
+    uint16_t criticalMv;
+};
 
 class PowerManager {
 public:
+    static constexpr uint8_t DEFAULT_BATTERY_SAMPLES = 16;
+    static constexpr uint8_t MAX_BATTERY_SAMPLES = 64;
+
     // Constructor takes sleep duration in seconds
     PowerManager(unsigned long sleepDurationSeconds);
     
     // Initialize power management
     bool begin();
     
+    // Also wake on the pulses of this counter's inputs
+    void setPulseCounter(PulseCounter* pulses) { _pulses = pulses; }
+
     // Enter deep sleep mode
     void sleep();
+
+    // After a pulse wake: sleep out the rest of the interval
+    void sleepRemaining();
+
+    // RTC time in microseconds, which keeps counting through deep sleep
+    static uint64_t rtcMicros();
+
+    // Battery voltage through a divider on an ADC pin (-1: none). The mean of
+    // the samples, in mV at the pin, is scaled by scalePermille / 1000 (2000
+    // for a 1:1 divider) and offset by offsetMv, from one comparison against
+    // a multimeter.
+    void setBattery(int8_t pin, uint16_t scalePermille, int16_t offsetMv,
+                    uint8_t samples = DEFAULT_BATTERY_SAMPLES);
+    // Sample the battery; 0 without a battery pin. Read it before the radio
+    // starts, so that the reading is not pulled down by its current draw.
+    uint16_t readBattery();
+    uint16_t getBatteryMv() const { return _batteryMv; }
+
+    // What the last battery reading allows; everything without a reading
+    void setEnergyPolicy(const EnergyPolicy& policy) { _policy = policy; }
+    unsigned long getSleepDuration() const;
+    bool allowNtp() const { return !below(_policy.noNtpMv); }
+    bool allowRetries() const { return !below(_policy.noRetryMv); }
+    bool allowRadio() const { return !below(_policy.criticalMv); }
     
     // Get last error message
     const char* getLastError() const { return _lastError; }
 
 private:
     unsigned long _sleepDuration;  // Sleep duration in seconds
+    PulseCounter* _pulses;
+    int8_t _batteryPin;
+    uint16_t _batteryScale;
+    int16_t _batteryOffset;
+    uint8_t _batterySamples;
+    uint16_t _batteryMv;
+    EnergyPolicy _policy;
     char _lastError[128];
     
     void updateLastError(const char* error);
     void prepareForSleep();
+    void armPulseWake();
+    bool below(uint16_t thresholdMv) const { return _batteryMv != 0 && _batteryMv < thresholdMv; }
 };
 
 #endif 
\ No newline at end of file
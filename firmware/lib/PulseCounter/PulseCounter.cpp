@@ -0,0 +1,92 @@
+#include "PulseCounter.h"
+#include "RtcState.h"
+#include <Arduino.h>
+#include <string.h>
+
+PulseCounter::PulseCounter(PulseCounterState &state) : _state(state), _inputs(), _count(0) {
+  RtcState::adopt(_state, MAGIC);
+}
+
+bool PulseCounter::addInput(uint8_t pin, Channel channel, uint8_t activeLevel, uint16_t debounceMs) {
+  if (pin > MAX_WAKE_PIN || _count >= PulseCounterState::MAX_INPUTS) {
+    return false;
+  }
+  Input &input = _inputs[_count++];
+  input.pin = pin;
+  input.channel = channel;
+  input.activeLevel = activeLevel ? HIGH : LOW;
+  input.debounceUs = static_cast<uint32_t>(debounceMs) * 1000;
+  return true;
+}
+
+void PulseCounter::begin() {
+  for (uint8_t i = 0; i < _count; i++) {
+    pinMode(_inputs[i].pin, INPUT);
+  }
+}
+
+uint64_t PulseCounter::readLevels() const {
+  uint64_t levels = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (digitalRead(_inputs[i].pin) == HIGH) {
+      levels |= 1ULL << _inputs[i].pin;
+    }
+  }
+  return levels;
+}
+
+void PulseCounter::onWake(uint64_t wakeMask, uint64_t levels, uint64_t nowUs) {
+  for (uint8_t i = 0; i < _count; i++) {
+    const Input &input = _inputs[i];
+    PulseInputState &state = _state.inputs[i];
+    uint64_t bit = 1ULL << input.pin;
+    bool woke = (wakeMask & bit) != 0;
+    bool active = ((levels & bit) != 0) == (input.activeLevel == HIGH);
+
+    // Armed while idle, a wake (or another pin's wake catching the contact
+    // closed) is a pulse, even if the contact opened again before the pin
+    // was read. Armed while closed, a wake means the contact opened, and a
+    // pulse only if it has closed again since.
+    bool pulse = state.idle ? (woke || active) : (woke && active);
+    if (pulse && nowUs - state.lastPulseUs >= input.debounceUs) {
+      state.count++;
+      state.lastPulseUs = nowUs;
+    }
+  }
+}
+
+void PulseCounter::arm(uint64_t levels, uint64_t &lowMask, uint64_t &highMask) {
+  lowMask = 0;
+  highMask = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    const Input &input = _inputs[i];
+    uint64_t bit = 1ULL << input.pin;
+    bool high = (levels & bit) != 0;
+    _state.inputs[i].idle = high != (input.activeLevel == HIGH);
+    // Wake on the level the pin is not at
+    if (high) {
+      lowMask |= bit;
+    } else {
+      highMask |= bit;
+    }
+  }
+}
+
+uint64_t PulseCounter::remainingUs(uint64_t nowUs) const {
+  return _state.timerDueUs > nowUs ? _state.timerDueUs - nowUs : 0;
+}
+
+bool PulseCounter::collect(Measurements &out) const {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!out.add(static_cast<Channel>(_inputs[i].channel), static_cast<int32_t>(_state.inputs[i].count))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PulseCounter::clear() {
+  for (uint8_t i = 0; i < PulseCounterState::MAX_INPUTS; i++) {
+    _state.inputs[i].count = 0;
+  }
+}
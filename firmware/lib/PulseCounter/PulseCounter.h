@@ -0,0 +1,86 @@
+/*
+ * PulseCounter.h
+ * Rain gauge and anemometer pulses counted across deep sleep on GPIO wakes
+ */
+
+#ifndef PULSE_COUNTER_H
+#define PULSE_COUNTER_H
+
+#include <stdint.h>
+#include "Measurements.h"
+
+struct PulseInputState {
+    uint32_t count;        // Pulses since the last clear()
+    uint64_t lastPulseUs;  // Time of the last counted pulse, for debouncing
+    bool idle;             // Input was idle when armed: the next wake is a pulse
+};
+
+// In RTC memory across deep sleep (see RtcState.h)
+struct PulseCounterState {
+    static const uint8_t MAX_INPUTS = 4;
+
+    uint32_t magic;
+    uint64_t timerDueUs;  // End of the sleep interval a pulse wake cuts short
+    PulseInputState inputs[MAX_INPUTS];
+};
+
+// Deep sleep on the ESP32-C3 can only wake on a GPIO level, not an edge.
+// Each input is therefore armed for the level it is not at: the active level
+// while idle, the idle level while a contact is held closed. A wake on the
+// active level is a pulse; a wake on the idle level only re-arms.
+//
+// The wake handler takes the wake status and pin levels as arguments and
+// touches nothing else, so that a pulse wake goes back to sleep in a few
+// milliseconds without starting WiFi or the sensors.
+class PulseCounter {
+public:
+    static const uint32_t MAGIC = 0x504C5331;  // "PLS1"
+    static const uint8_t MAX_WAKE_PIN = 5;     // ESP32-C3 deep sleep wakes on GPIO0-5 only
+
+    explicit PulseCounter(PulseCounterState& state);
+
+    // Count pulses on a pin that reads activeLevel while the contact is
+    // closed. Edges within debounceMs of a counted pulse are contact bounce.
+    // False for a pin that cannot wake from deep sleep or when all inputs
+    // are in use.
+    bool addInput(uint8_t pin, Channel channel, uint8_t activeLevel, uint16_t debounceMs);
+    uint8_t count() const { return _count; }
+
+    // Configure the input pins (the pins keep their external pull resistors
+    // during deep sleep)
+    void begin();
+    // Level of every input pin, one bit per GPIO
+    uint64_t readLevels() const;
+
+    // Wake handler: count the pulses behind a GPIO wake. wakeMask holds the
+    // pins that woke the chip, levels the pin levels now.
+    void onWake(uint64_t wakeMask, uint64_t levels, uint64_t nowUs);
+    // Pins to wake on next, by level, for the given pin levels
+    void arm(uint64_t levels, uint64_t& lowMask, uint64_t& highMask);
+
+    // Sleep interval bookkeeping, so that a pulse wake sleeps out the rest of
+    // the interval instead of starting a new one
+    void startInterval(uint64_t nowUs, uint64_t durationUs) { _state.timerDueUs = nowUs + durationUs; }
+    uint64_t remainingUs(uint64_t nowUs) const;
+
+    uint32_t pulses(uint8_t input) const { return input < _count ? _state.inputs[input].count : 0; }
+
+    // Add the count of every input; false if out ran out of room
+    bool collect(Measurements& out) const;
+    // Reset the counts once published; debounce and arming state are kept
+    void clear();
+
+private:
+    struct Input {
+        uint8_t pin;
+        uint8_t channel;
+        uint8_t activeLevel;
+        uint32_t debounceUs;
+    };
+
+    PulseCounterState& _state;
+    Input _inputs[PulseCounterState::MAX_INPUTS];
+    uint8_t _count;
+};
+
+#endif // PULSE_COUNTER_H
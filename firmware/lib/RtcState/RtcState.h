@@ -0,0 +1,34 @@
+#ifndef RTC_STATE_H
+#define RTC_STATE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// State kept across deep sleep in RTC memory (RTC_DATA_ATTR).
+//
+// Such state is a plain-old-data struct whose first field is a uint32_t
+// magic: four characters naming the layout, the last one its version, bumped
+// whenever the fields change. RTC memory is zeroed on a cold boot and holds
+// whatever the previous firmware left there after an update, so the owner
+// adopts the state before using it: anything without the owner's magic, or
+// failing the owner's own consistency checks, starts over from zero.
+class RtcState {
+public:
+    // True if the state was kept, false if it was reset
+    template <typename T>
+    static bool adopt(T& state, uint32_t magic, bool consistent = true) {
+        if (state.magic == magic && consistent) {
+            return true;
+        }
+        memset(&state, 0, sizeof(state));
+        state.magic = magic;
+        return false;
+    }
+
+    // Same name, another version: a state an update left behind
+    static bool isOlderVersion(uint32_t found, uint32_t magic) {
+        return found != magic && (found >> 8) == (magic >> 8);
+    }
+};
+
+#endif // RTC_STATE_H
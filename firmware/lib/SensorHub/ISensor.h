@@ -0,0 +1,26 @@
+#ifndef I_SENSOR_H
+#define I_SENSOR_H
+
+#include <stdint.h>
+#include "Measurements.h"
+
+// A sensor sampled by SensorHub in two phases, so that the conversions of
+// all sensors on the bus run at the same time.
+class ISensor {
+public:
+    virtual ~ISensor() {}
+
+    virtual const char* getName() const = 0;
+    virtual bool begin() = 0;
+
+    // Start a conversion and return the milliseconds until its result can be
+    // read (0 when the sensor converts continuously)
+    virtual uint32_t trigger() = 0;
+
+    // Read back the conversion started by trigger() and add its channels
+    virtual bool collect(Measurements& out) = 0;
+
+    virtual const char* getLastError() const = 0;
+};
+
+#endif // I_SENSOR_H
@@ -0,0 +1,101 @@
+#include "IntervalStats.h"
+#include "RtcState.h"
+#include <string.h>
+
+namespace {
+
+uint32_t isqrt(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return static_cast<uint32_t>(root);
+}
+
+// Round a Q8 value to the nearest unit (arithmetic shift: halves round up)
+int32_t roundQ8(int64_t value) { return static_cast<int32_t>((value + 128) >> 8); }
+
+} // namespace
+
+IntervalStats::IntervalStats(IntervalStatsState &state) : _state(state) {
+  RtcState::adopt(_state, MAGIC, _state.count <= IntervalStatsState::MAX_CHANNELS);
+}
+
+void IntervalStats::add(const Measurements &sample) {
+  for (uint8_t i = 0; i < sample.count && i < Measurements::MAX_MEASUREMENTS; i++) {
+    const Measurement &measurement = sample.items[i];
+    if (measurement.statistic != STAT_VALUE) {
+      continue;
+    }
+    ChannelStats *stats = find(measurement.channel);
+    if (!stats || stats->count == UINT16_MAX) {
+      continue;
+    }
+
+    int32_t value = measurement.value;
+    if (stats->count == 0 || value < stats->min) {
+      stats->min = value;
+    }
+    if (stats->count == 0 || value > stats->max) {
+      stats->max = value;
+    }
+
+    // Welford: the deltas before and after the mean update share a sign
+    stats->count++;
+    int64_t x = static_cast<int64_t>(value) * 256;
+    int64_t delta = x - stats->meanQ8;
+    stats->meanQ8 += delta / stats->count;
+    stats->m2Q16 += static_cast<uint64_t>(delta * (x - stats->meanQ8));
+  }
+  if (_state.samples < UINT16_MAX) {
+    _state.samples++;
+  }
+}
+
+bool IntervalStats::summarize(Measurements &out) const {
+  for (uint8_t i = 0; i < _state.count; i++) {
+    const ChannelStats &stats = _state.channels[i];
+    if (stats.count == 0) {
+      continue;
+    }
+
+    Channel channel = static_cast<Channel>(stats.channel);
+    uint32_t deviationQ8 = stats.count > 1 ? isqrt(stats.m2Q16 / (stats.count - 1)) : 0;
+    if (!out.add(channel, stats.min, STAT_MIN) || !out.add(channel, stats.max, STAT_MAX) ||
+        !out.add(channel, roundQ8(stats.meanQ8), STAT_MEAN) || !out.add(channel, roundQ8(deviationQ8), STAT_STDDEV)) {
+      return false;
+    }
+  }
+  out.samples = _state.samples;
+  return true;
+}
+
+void IntervalStats::clear() {
+  memset(&_state, 0, sizeof(_state));
+  _state.magic = MAGIC;
+}
+
+ChannelStats *IntervalStats::find(uint8_t channel) {
+  for (uint8_t i = 0; i < _state.count; i++) {
+    if (_state.channels[i].channel == channel) {
+      return &_state.channels[i];
+    }
+  }
+  if (_state.count == IntervalStatsState::MAX_CHANNELS) {
+    return nullptr;
+  }
+  ChannelStats &stats = _state.channels[_state.count++];
+  memset(&stats, 0, sizeof(stats));
+  stats.channel = channel;
+  return &stats;
+}
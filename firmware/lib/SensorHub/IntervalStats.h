@@ -0,0 +1,59 @@
+/*
+ * IntervalStats.h
+ * Per-channel min/max/mean/stddev over the samples of one transmit interval
+ */
+
+#ifndef INTERVAL_STATS_H
+#define INTERVAL_STATS_H
+
+#include <stdint.h>
+#include "Measurements.h"
+
+// Welford accumulator in fixed point: the mean is kept in value units * 256
+// and the sum of squared deviations in value units^2 * 65536, so no floats
+// are involved. That holds for channel ranges up to about 10^6 units over a
+// few hundred samples, well beyond any reading we take.
+struct ChannelStats {
+    uint8_t channel;
+    uint16_t count;
+    int32_t min;
+    int32_t max;
+    int64_t meanQ8;
+    uint64_t m2Q16;
+};
+
+// In RTC memory across deep sleep (see RtcState.h)
+struct IntervalStatsState {
+    static const uint8_t MAX_CHANNELS = 6;
+
+    uint32_t magic;
+    uint16_t samples;  // Samples added since the last clear()
+    uint8_t count;     // Channels in use
+    ChannelStats channels[MAX_CHANNELS];
+};
+
+class IntervalStats {
+public:
+    static const uint32_t MAGIC = 0x49535431;  // "IST1"
+
+    explicit IntervalStats(IntervalStatsState& state);
+
+    // Fold the point values of one sample into their channel's accumulator.
+    // Channels beyond MAX_CHANNELS are ignored.
+    void add(const Measurements& sample);
+
+    uint16_t samples() const { return _state.samples; }
+
+    // Append min, max, mean and sample standard deviation of every channel,
+    // in the channel's units; false if out ran out of room
+    bool summarize(Measurements& out) const;
+
+    void clear();
+
+private:
+    IntervalStatsState& _state;
+
+    ChannelStats* find(uint8_t channel);
+};
+
+#endif // INTERVAL_STATS_H
@@ -0,0 +1,45 @@
+#include "Measurements.h"
+
+namespace {
+
+const ChannelInfo CHANNELS[CHANNEL_COUNT] = {
+    {"temperature", 2, 2}, // 0.01 degC
+    {"humidity", 3, 2},    // 0.001 %RH
+    {"pressure", 2, 2},    // Pa, published in hPa
+    {"altitude", 2, 1},    // cm, published in m
+    {"rain_pulses", 0, 0}, // Bucket tips; the backend knows the mm per tip
+    {"wind_pulses", 0, 0}, // Anemometer pulses over the interval
+    {"battery", 3, 2},     // mV, published in V
+    {"heap_min", 0, 0},    // Bytes
+    {"heap_block", 0, 0},  // Bytes
+    {"stack_free", 0, 0},  // Bytes
+};
+
+const char *const SUFFIXES[STAT_COUNT] = {"", "_min", "_max", "_mean", "_sd", "_spread"};
+
+} // namespace
+
+bool Measurements::add(Channel channel, int32_t value, Statistic statistic) {
+  if (count >= MAX_MEASUREMENTS) {
+    return false;
+  }
+  items[count].channel = channel;
+  items[count].statistic = statistic;
+  items[count].value = value;
+  count++;
+  return true;
+}
+
+bool Measurements::get(Channel channel, int32_t &value, Statistic statistic) const {
+  for (uint8_t i = 0; i < count && i < MAX_MEASUREMENTS; i++) {
+    if (items[i].channel == channel && items[i].statistic == statistic) {
+      value = items[i].value;
+      return true;
+    }
+  }
+  return false;
+}
+
+const ChannelInfo *Measurements::info(uint8_t channel) { return channel < CHANNEL_COUNT ? &CHANNELS[channel] : nullptr; }
+
+const char *Measurements::suffix(uint8_t statistic) { return statistic < STAT_COUNT ? SUFFIXES[statistic] : nullptr; }
@@ -0,0 +1,80 @@
+/*
+ * Measurements.h
+ * Fixed-point sensor readings tagged by channel
+ */
+
+#ifndef MEASUREMENTS_H
+#define MEASUREMENTS_H
+
+#include <stdint.h>
+
+// Every quantity a sensor can report. Adding a sensor means adding its
+// channels here (and to the table in Measurements.cpp); the payload writes
+// whatever channels were sampled.
+enum Channel : uint8_t {
+    CHANNEL_TEMPERATURE = 0,
+    CHANNEL_HUMIDITY,
+    CHANNEL_PRESSURE,
+    CHANNEL_ALTITUDE,
+    CHANNEL_RAIN_PULSES,  // Counted during deep sleep (see PulseCounter)
+    CHANNEL_WIND_PULSES,
+    CHANNEL_BATTERY,  // Measured by PowerManager
+    CHANNEL_HEAP_MIN,    // Lowest free heap of the wake (see MemoryMonitor)
+    CHANNEL_HEAP_BLOCK,  // Smallest largest-free-block of the wake
+    CHANNEL_STACK_FREE,  // Loop task stack never used
+    CHANNEL_COUNT
+};
+
+// What a measurement of a channel stands for: a point reading, a statistic
+// over the samples of one interval (see IntervalStats), or the spread of the
+// conversions behind a point reading
+enum Statistic : uint8_t {
+    STAT_VALUE = 0,
+    STAT_MIN,
+    STAT_MAX,
+    STAT_MEAN,
+    STAT_STDDEV,
+    STAT_SPREAD,
+    STAT_COUNT
+};
+
+// Payload key, and how the integer value maps to the published number:
+// value / 10^scale, written with the given number of decimals
+struct ChannelInfo {
+    const char* key;
+    uint8_t scale;
+    uint8_t decimals;
+};
+
+struct Measurement {
+    uint8_t channel;
+    uint8_t statistic;
+    int32_t value;
+};
+
+// Plain-old-data so that it can be queued in RTC memory with the rest of a
+// reading; channels are stored as indexes rather than pointers for the same
+// reason.
+struct Measurements {
+    static const uint8_t MAX_MEASUREMENTS = 30;  // Point values, spreads and statistics of 4 channels, pulses, battery, memory
+
+    uint8_t count;
+    uint16_t samples;  // Samples behind the statistics (0: point values only)
+    Measurement items[MAX_MEASUREMENTS];
+
+    void clear() {
+        count = 0;
+        samples = 0;
+    }
+
+    // False when full; a channel added twice keeps both values
+    bool add(Channel channel, int32_t value, Statistic statistic = STAT_VALUE);
+    bool get(Channel channel, int32_t& value, Statistic statistic = STAT_VALUE) const;
+
+    // nullptr for an unknown channel (e.g. a reading queued by other firmware)
+    static const ChannelInfo* info(uint8_t channel);
+    // Payload key suffix ("" for a point value, "_min", ...); nullptr if unknown
+    static const char* suffix(uint8_t statistic);
+};
+
+#endif // MEASUREMENTS_H
@@ -0,0 +1,69 @@
+#include "SensorHub.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+SensorHub::SensorHub() : _sensors(), _active(), _count(0), _lastWaitMs(0) { _lastError[0] = '\0'; }
+
+bool SensorHub::add(ISensor *sensor) {
+  if (!sensor || _count >= MAX_SENSORS) {
+    return false;
+  }
+  _sensors[_count] = sensor;
+  _active[_count] = false;
+  _count++;
+  return true;
+}
+
+uint8_t SensorHub::activeCount() const {
+  uint8_t active = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_active[i]) {
+      active++;
+    }
+  }
+  return active;
+}
+
+bool SensorHub::begin() {
+  bool ok = true;
+  for (uint8_t i = 0; i < _count; i++) {
+    _active[i] = _sensors[i]->begin();
+    if (!_active[i]) {
+      setError(_sensors[i]);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+bool SensorHub::sample(Measurements &out) {
+  out.clear();
+
+  uint32_t wait = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_active[i]) {
+      uint32_t conversion = _sensors[i]->trigger();
+      if (conversion > wait) {
+        wait = conversion;
+      }
+    }
+  }
+
+  _lastWaitMs = wait;
+  if (wait > 0) {
+    delay(wait);
+  }
+
+  bool ok = true;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_active[i] && !_sensors[i]->collect(out)) {
+      setError(_sensors[i]);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+void SensorHub::setError(const ISensor *sensor) {
+  snprintf(_lastError, sizeof(_lastError), "%s: %s", sensor->getName(), sensor->getLastError());
+}
@@ -0,0 +1,47 @@
+/*
+ * SensorHub.h
+ * Registry of sensors and a sampling scheduler that overlaps their conversions
+ */
+
+#ifndef SENSOR_HUB_H
+#define SENSOR_HUB_H
+
+#include <stdint.h>
+#include "ISensor.h"
+#include "Measurements.h"
+
+class SensorHub {
+public:
+    static const uint8_t MAX_SENSORS = 4;
+
+    SensorHub();
+
+    // Register a sensor; false when the registry is full
+    bool add(ISensor* sensor);
+    uint8_t count() const { return _count; }
+    uint8_t activeCount() const;
+
+    // Begin every sensor. A sensor that fails to begin is left out of
+    // sampling; false if any failed.
+    bool begin();
+
+    // Trigger all active sensors, wait once for the slowest conversion, then
+    // collect the results back to back. Measurements from sensors that
+    // succeeded are kept even when another fails; false if any failed.
+    bool sample(Measurements& out);
+
+    // Time waited for conversions by the last sample()
+    uint32_t getLastWaitMs() const { return _lastWaitMs; }
+    const char* getLastError() const { return _lastError; }
+
+private:
+    ISensor* _sensors[MAX_SENSORS];
+    bool _active[MAX_SENSORS];
+    uint8_t _count;
+    uint32_t _lastWaitMs;
+    char _lastError[128];
+
+    void setError(const ISensor* sensor);
+};
+
+#endif // SENSOR_HUB_H
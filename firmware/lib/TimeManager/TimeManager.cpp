@@ -21,6 +21,15 @@ bool TimeManager::syncTime() {
   return syncTimeWithNTP();
 }
 
+bool TimeManager::useClock() {
+  if (time(nullptr) < 24 * 3600) {
+    updateLastError("Clock not set");
+    return false;
+  }
+  _timeSynced = true;
+  return true;
+}
+
 bool TimeManager::syncTimeWithNTP() {
   // Configure time (in case begin() wasn't called)
   configTime(0, 0, "pool.ntp.org", "time.nist.gov");
@@ -12,6 +12,10 @@ public:
     
     // Sync time with NTP servers
     bool syncTime();
+
+    // Use the RTC time kept through deep sleep without starting SNTP (e.g.
+    // on a low battery); false if the clock has never been set
+    bool useClock();
     
     // Get current Unix timestamp
     unsigned long getCurrentTimestamp();
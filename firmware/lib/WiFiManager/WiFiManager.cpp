@@ -1,4 +1,8 @@
 #include "WiFiManager.h"
+#include "Crc32.h"
+#include "EventLog.h"
+
+#include <stddef.h>
 
 #ifdef UNIT_TEST
 #include "Arduino.h"
@@ -8,7 +12,8 @@
 #include <WiFi.h>
 #endif
 
-WiFiManager::WiFiManager(const char *ssid, const char *password) : _reconnectAttempts(0) {
+WiFiManager::WiFiManager(const char *ssid, const char *password)
+    : _reconnectAttempts(0), _generation(0), _fromCache(false), _cache(nullptr) {
   _lastError[0] = '\0';
   _ssid[0] = '\0';
   _password[0] = '\0';
@@ -19,7 +24,7 @@ WiFiManager::WiFiManager(const char *ssid, const char *password) : _reconnectAtt
     _ssid[sizeof(_ssid) - 1] = '\0';
     strncpy(_password, password, sizeof(_password) - 1);
     _password[sizeof(_password) - 1] = '\0';
-    Serial.println("WiFiManager: Using credentials from constructor");
+    LOG_INFO("WiFiManager: Using credentials from constructor");
   }
   // Otherwise, they will be loaded from NVS in begin()
 }
@@ -27,13 +32,18 @@ WiFiManager::WiFiManager(const char *ssid, const char *password) : _reconnectAtt
 WiFiManager::~WiFiManager() { _prefs.end(); }
 
 bool WiFiManager::begin() {
-  // If no credentials were provided in constructor, try to load from NVS
+  // If no credentials were provided in constructor, try the RTC cache, then NVS
   if (strlen(_ssid) == 0) {
-    if (!loadFromNVS()) {
+    if (loadFromCache()) {
+      LOG_INFO("WiFiManager: Loaded credentials from RTC cache (generation %lu)",
+               static_cast<unsigned long>(_generation));
+    } else if (loadFromNVS()) {
+      fillCache();
+      LOG_INFO("WiFiManager: Loaded credentials from NVS");
+    } else {
       updateLastError("No WiFi credentials found in NVS or constructor");
       return false; // Don't set WiFi mode yet - might need provisioning
     }
-    Serial.println("WiFiManager: Loaded credentials from NVS");
   }
 
   // Only set to STA mode if we have credentials
@@ -44,7 +54,13 @@ bool WiFiManager::begin() {
   return true;
 }
 
-bool WiFiManager::connect() { return attemptConnection(); }
+bool WiFiManager::connect() {
+  if (attemptConnection()) {
+    return true;
+  }
+  // Unless the cache is stale, the network is at fault, not the credentials
+  return reloadIfStale() && attemptConnection();
+}
 
 bool WiFiManager::reconnect() {
   if (_reconnectAttempts >= MAX_RECONNECT_ATTEMPTS) {
@@ -125,6 +141,7 @@ bool WiFiManager::loadFromNVS() {
 
   size_t ssidLen = _prefs.getString("ssid", _ssid, sizeof(_ssid));
   size_t passLen = _prefs.getString("password", _password, sizeof(_password));
+  _generation = _prefs.getULong("generation", 0);
 
   _prefs.end();
 
@@ -134,7 +151,7 @@ bool WiFiManager::loadFromNVS() {
     return false;
   }
 
-  Serial.printf("WiFiManager: Loaded WiFi credentials from NVS (SSID: %s)\n", _ssid);
+  LOG_INFO("WiFiManager: Loaded WiFi credentials from NVS (SSID: %s)", _ssid);
   return true;
 }
 
@@ -144,6 +161,8 @@ bool WiFiManager::saveToNVS() {
     return false;
   }
 
+  _generation = _prefs.getULong("generation", 0) + 1;
+
   if (_prefs.putString("ssid", _ssid) == 0) {
     _prefs.end();
     updateLastError("Failed to save SSID to NVS");
@@ -156,8 +175,10 @@ bool WiFiManager::saveToNVS() {
     return false;
   }
 
+  _prefs.putULong("generation", _generation);
   _prefs.end();
-  Serial.printf("WiFiManager: Saved WiFi credentials to NVS (SSID: %s)\n", _ssid);
+  fillCache();
+  LOG_INFO("WiFiManager: Saved WiFi credentials to NVS (SSID: %s)", _ssid);
   return true;
 }
 
@@ -180,12 +201,72 @@ bool WiFiManager::clearCredentials() {
     return false;
   }
 
-  _prefs.clear();
+  // The generation outlives the credentials, so it never repeats
+  _generation = _prefs.getULong("generation", 0) + 1;
+  _prefs.remove("ssid");
+  _prefs.remove("password");
+  _prefs.putULong("generation", _generation);
   _prefs.end();
 
   _ssid[0] = '\0';
   _password[0] = '\0';
+  if (_cache) {
+    memset(_cache, 0, sizeof(*_cache));
+  }
+
+  LOG_INFO("WiFiManager: Cleared WiFi credentials from NVS");
+  return true;
+}
+
+bool WiFiManager::loadFromCache() {
+  if (!_cache || _cache->magic != CACHE_MAGIC || _cache->crc != cacheCrc(*_cache) || _cache->ssid[0] == '\0') {
+    return false;
+  }
+
+  memcpy(_ssid, _cache->ssid, sizeof(_ssid));
+  memcpy(_password, _cache->password, sizeof(_password));
+  _ssid[sizeof(_ssid) - 1] = '\0';
+  _password[sizeof(_password) - 1] = '\0';
+  _generation = _cache->generation;
+  _fromCache = true;
+  return true;
+}
+
+bool WiFiManager::reloadIfStale() {
+  if (!_fromCache || !_prefs.begin("tarameteo_wifi", true)) {
+    return false;
+  }
+  uint32_t stored = _prefs.getULong("generation", 0);
+  _prefs.end();
+  if (stored == _generation) {
+    return false;
+  }
 
-  Serial.println("WiFiManager: Cleared WiFi credentials from NVS");
+  LOG_WARN("WiFiManager: RTC cache is stale (generation %lu, NVS %lu)", static_cast<unsigned long>(_generation),
+           static_cast<unsigned long>(stored));
+  _fromCache = false;
+  memset(_cache, 0, sizeof(*_cache));
+  if (!loadFromNVS()) {
+    updateLastError("No WiFi credentials found in NVS");
+    return false;
+  }
+  fillCache();
   return true;
-}
\ No newline at end of file
+}
+
+void WiFiManager::fillCache() {
+  if (!_cache) {
+    return;
+  }
+  memset(_cache, 0, sizeof(*_cache));
+  _cache->magic = CACHE_MAGIC;
+  _cache->generation = _generation;
+  strncpy(_cache->ssid, _ssid, sizeof(_cache->ssid) - 1);
+  strncpy(_cache->password, _password, sizeof(_cache->password) - 1);
+  _cache->crc = cacheCrc(*_cache);
+}
+
+uint32_t WiFiManager::cacheCrc(const WiFiCacheState &state) {
+  size_t start = offsetof(WiFiCacheState, generation);
+  return Crc32::compute(reinterpret_cast<const uint8_t *>(&state) + start, sizeof(state) - start);
+}
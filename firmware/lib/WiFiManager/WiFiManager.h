@@ -2,17 +2,36 @@
 #define WIFI_MANAGER_H
 
 #include <Preferences.h>
+#include <stdint.h>
+
+// In RTC memory across deep sleep (see RtcState.h)
+struct WiFiCacheState {
+    uint32_t magic;
+    uint32_t crc;         // CRC-32 of the fields below
+    uint32_t generation;  // NVS write the credentials were cached from
+    char ssid[32];
+    char password[64];
+};
 
 class WiFiManager {
 public:
     static constexpr int MAX_RECONNECT_ATTEMPTS = 3;
     static constexpr int RECONNECT_DELAY_MS = 1000;  // 1 second between attempts
+    static const uint32_t CACHE_MAGIC = 0x57464331;  // "WFC1"
 
     // Constructor with optional credentials (NULL = load from NVS)
     // This enables "flash once, provision many" for WiFi credentials
     WiFiManager(const char* ssid = nullptr, const char* password = nullptr);
     ~WiFiManager();
 
+    // Warm-wake cache of the stored credentials: begin() takes them from it
+    // without opening NVS. A cold boot fills it from NVS; storing or clearing
+    // credentials bumps the generation and refills or empties it. When cached
+    // credentials fail to connect, connect() compares the cached generation
+    // with the one in NVS and, if NVS was written behind the cache's back,
+    // drops the cache and retries with the stored credentials.
+    void setCache(WiFiCacheState* state) { _cache = state; }
+
     bool begin();
     bool connect();  // Uses stored credentials
     bool reconnect();  // Uses stored credentials
@@ -30,18 +49,27 @@ public:
     bool storeCredentials(const char* ssid, const char* password);
     bool clearCredentials();
     const char* getSSID() const { return _ssid; }
+    uint32_t getGeneration() const { return _generation; }  // NVS writes of the credentials
+    bool isFromCache() const { return _fromCache; }
 
 private:
     char _ssid[32];
     char _password[64];
     char _lastError[128];
     int _reconnectAttempts;
+    uint32_t _generation;
+    bool _fromCache;
     Preferences _prefs;
+    WiFiCacheState* _cache;
 
     void updateLastError(const char* error);
     bool attemptConnection();
     bool loadFromNVS();
     bool saveToNVS();
+    bool loadFromCache();
+    bool reloadIfStale();
+    void fillCache();
+    static uint32_t cacheCrc(const WiFiCacheState& state);
 };
 
 #endif 
@@ -0,0 +1,133 @@
+"""Compare native benchmark results against a committed baseline.
+
+Reads the output of `pio test -e native_bench -v` and collects the lines that
+Bench::run() prints:
+
+    BENCH <id> ns=<n> allocs=<n> heap=<n> stack=<n>
+
+Other BENCH lines (e.g. TLS handshake reports) are informational and ignored.
+Allocations, heap and stack are deterministic for a given build, so any
+growth beyond a small allowance for compiler differences fails. CPU time
+varies between hosts and with their load, so growth beyond a factor of the
+baseline is only reported, unless --gate-time makes it fail too.
+
+Usage:
+    bench_compare.py LOG BASELINE [--output FILE] [--update] [--gate-time]
+"""
+
+import argparse
+import json
+import re
+import sys
+
+METRICS = ("ns", "allocs", "heap", "stack")
+LINE = re.compile(r"^BENCH (\S+) ((?:\w+=\S+ ?)+)$")
+
+# Growth allowed before a result counts as a regression
+TIME_FACTOR = 2.0
+TIME_SLACK_NS = 100
+MEMORY_FACTOR = 1.10
+MEMORY_SLACK_BYTES = 64
+
+
+def parse(lines):
+    """Map each Bench::run() id to its metrics."""
+    results = {}
+    for line in lines:
+        match = LINE.match(line.strip())
+        if not match:
+            continue
+        fields = dict(field.split("=", 1) for field in match.group(2).split())
+        if tuple(sorted(fields)) != tuple(sorted(METRICS)):
+            continue
+        results[match.group(1)] = {key: int(fields[key]) for key in METRICS}
+    return results
+
+
+def regressions(result, baseline, time_factor):
+    """Describe each metric of result that regressed against baseline."""
+    limits = {
+        "ns": baseline["ns"] * time_factor + TIME_SLACK_NS,
+        "allocs": baseline["allocs"],
+        "heap": baseline["heap"] * MEMORY_FACTOR + MEMORY_SLACK_BYTES,
+        "stack": baseline["stack"] * MEMORY_FACTOR + MEMORY_SLACK_BYTES,
+    }
+    return {
+        key: f"{key} {baseline[key]} -> {result[key]}"
+        for key in METRICS
+        if result[key] > limits[key]
+    }
+
+
+def compare(results, baseline, time_factor, gate_time):
+    """Print a diff table and return the number of regressions."""
+    failures = 0
+    for key in sorted(results.keys() | baseline.keys()):
+        if key not in baseline:
+            print(f"  new      {key}: {results[key]}")
+            continue
+        if key not in results:
+            print(f"  missing  {key}")
+            continue
+        problems = regressions(results[key], baseline[key], time_factor)
+        if not gate_time and list(problems) == ["ns"]:
+            print(f"  slower   {key}: {problems['ns']}")
+        elif problems:
+            failures += 1
+            print(f"  REGRESS  {key}: {', '.join(problems.values())}")
+        else:
+            changes = [
+                f"{metric} {baseline[key][metric]} -> {results[key][metric]}"
+                for metric in METRICS
+                if results[key][metric] != baseline[key][metric]
+            ]
+            print(f"  ok       {key}" + (f": {', '.join(changes)}" if changes else ""))
+    return failures
+
+
+def write(path, results):
+    """Write one result per line, so that diffs between commits stay readable."""
+    lines = [f"  {json.dumps(key)}: {json.dumps(results[key], sort_keys=True)}" for key in sorted(results)]
+    with open(path, "w") as f:
+        f.write("{\n" + ",\n".join(lines) + "\n}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", help="output of pio test -e native_bench -v")
+    parser.add_argument("baseline", help="baseline JSON file")
+    parser.add_argument("--output", help="also write the results as JSON")
+    parser.add_argument("--update", action="store_true", help="replace the baseline with the results")
+    parser.add_argument("--time-factor", type=float, default=TIME_FACTOR, help="allowed CPU time growth")
+    parser.add_argument("--gate-time", action="store_true", help="fail on CPU time growth too")
+    args = parser.parse_args()
+
+    with open(args.log) as f:
+        results = parse(f)
+    if not results:
+        print("No benchmark results found", file=sys.stderr)
+        return 1
+
+    if args.output:
+        write(args.output, results)
+
+    if args.update:
+        write(args.baseline, results)
+        print(f"Baseline updated with {len(results)} results")
+        return 0
+
+    try:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    except FileNotFoundError:
+        baseline = {}
+
+    failures = compare(results, baseline, args.time_factor, args.gate_time)
+    if failures:
+        print(f"{failures} benchmark regression(s); run `make bench-baseline` if intended", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
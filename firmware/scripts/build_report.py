@@ -0,0 +1,131 @@
+"""Compare firmware builds between log verbosity levels.
+
+For each PlatformIO environment (by default esp32, the production build, and
+esp32_debug, which logs everything), reports the size of the flashed image
+and of its sections, and optionally the boot time measured on the device.
+
+Boot time is taken from the boot marker every wake records in the event log
+(milliseconds from reset to setup(), see lib/EventLog/EventLog.h). Pass the
+dumps published on <topic>/log by a device running each build, raw or as
+decoded by decode_log.py:
+
+    build_report.py --boot esp32=prod.bin --boot esp32_debug=debug.bin
+
+Usage:
+    build_report.py [ENV ...] [--no-build] [--boot ENV=FILE ...] [--output FILE]
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+from pathlib import Path
+
+from decode_log import MAGIC, decode
+
+ROOT = Path(__file__).resolve().parent.parent
+ENVS = ("esp32", "esp32_debug")
+SECTIONS = (".flash.text", ".flash.rodata", ".iram0.text", ".dram0.data", ".dram0.bss")
+BOOT = re.compile(r"--- boot \d+, (\d+) ms to setup\(\) ---")
+
+
+def size_tool():
+    """Locate the toolchain's size utility."""
+    tool = shutil.which("riscv32-esp-elf-size")
+    if tool:
+        return tool
+    packages = Path(os.environ.get("PLATFORMIO_CORE_DIR", Path.home() / ".platformio")) / "packages"
+    candidate = packages / "toolchain-riscv32-esp" / "bin" / "riscv32-esp-elf-size"
+    return str(candidate) if candidate.exists() else None
+
+
+def sections(elf, tool):
+    """Map the section names of elf to their sizes."""
+    if not tool:
+        return {}
+    output = subprocess.run([tool, "-A", str(elf)], check=True, capture_output=True, text=True).stdout
+    sizes = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[0].startswith(".") and fields[1].isdigit():
+            sizes[fields[0]] = int(fields[1])
+    return sizes
+
+
+def boot_times(path):
+    """Boot times (ms) recorded in a raw or decoded event log dump."""
+    data = Path(path).read_bytes()
+    lines = decode(data, {}) if data[:4] == MAGIC else data.decode(errors="replace").splitlines()
+    return [int(match.group(1)) for match in map(BOOT.search, lines) if match]
+
+
+def report(env, tool, boots):
+    build = ROOT / ".pio" / "build" / env
+    image = build / "firmware.bin"
+    if not image.exists():
+        raise FileNotFoundError(f"{image} not found; build {env} first")
+    result = {"image": image.stat().st_size}
+    result.update(sections(build / "firmware.elf", tool))
+    times = [ms for path in boots for ms in boot_times(path)]
+    if times:
+        result["boot_ms"] = statistics.median_low(times)
+        result["boots"] = len(times)
+    return result
+
+
+def print_table(results):
+    envs = list(results)
+    rows = ["image"] + [name for name in SECTIONS if any(name in results[env] for env in envs)]
+    rows += [name for name in ("boot_ms", "boots") if any(name in results[env] for env in envs)]
+    print(f"{'':<16}" + "".join(f"{env:>14}" for env in envs) + (f"{'delta':>10}" if len(envs) == 2 else ""))
+    for row in rows:
+        values = [results[env].get(row) for env in envs]
+        line = f"{row:<16}" + "".join(f"{'-' if value is None else value:>14}" for value in values)
+        if len(envs) == 2 and None not in values and row != "boots":
+            line += f"{values[1] - values[0]:>+10}"
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n", 1)[0])
+    parser.add_argument("envs", nargs="*", default=list(ENVS), help="environments to compare")
+    parser.add_argument("--no-build", action="store_true", help="report on the existing builds")
+    parser.add_argument("--boot", action="append", default=[], metavar="ENV=FILE", help="event log dump of ENV")
+    parser.add_argument("--output", help="also write the results as JSON")
+    args = parser.parse_args()
+
+    boots = {}
+    for spec in args.boot:
+        env, _, path = spec.partition("=")
+        if env not in args.envs or not path:
+            parser.error(f"--boot {spec}: expected ENV=FILE with ENV one of {', '.join(args.envs)}")
+        boots.setdefault(env, []).append(path)
+
+    tool = size_tool()
+    if not tool:
+        print("riscv32-esp-elf-size not found; reporting image sizes only", file=sys.stderr)
+
+    results = {}
+    for env in args.envs:
+        if not args.no_build:
+            subprocess.run(["pio", "run", "-e", env], cwd=ROOT, check=True)
+        try:
+            results[env] = report(env, tool, boots.get(env, []))
+        except (FileNotFoundError, ValueError) as error:
+            print(f"error: {error}", file=sys.stderr)
+            return 1
+
+    print_table(results)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+            f.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
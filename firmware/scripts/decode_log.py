@@ -0,0 +1,172 @@
+"""Decode an event log dump uploaded by the firmware.
+
+The firmware never stores log format strings: each record carries the FNV-1a
+hash of its format string and the binary-encoded arguments (see
+lib/EventLog/EventLog.h). This tool hashes the format strings of every
+LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG call in the source tree and formats the
+records back into text. Decode with the sources the firmware was built from.
+
+Dumps are published on weather/<sensor>/log, e.g.:
+
+    mosquitto_sub -t weather/station-01/log -C 1 > log.bin
+    decode_log.py log.bin
+
+Usage:
+    decode_log.py DUMP [--source DIR ...]
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = b"TLG1"
+ID_TEXT = 0
+ID_BOOT = 1
+RECORD_HEADER = 10
+LEVELS = {1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG"}
+
+LITERAL = r'"(?:[^"\\]|\\.)*"'
+CALL = re.compile(r"\bLOG_(?:ERROR|WARN|INFO|DEBUG)\(\s*((?:" + LITERAL + r"\s*)+)")
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diouxXcfFeEgGsp%])")
+ESCAPES = {"n": "\n", "t": "\t", '"': '"', "\\": "\\", "'": "'"}
+
+
+def fnv1a(text):
+    """FNV-1a hash of a format string, as EventLog::hash() computes it."""
+    value = 2166136261
+    for byte in text.encode():
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal):
+    return re.sub(r"\\(.)", lambda match: ESCAPES.get(match.group(1), match.group(1)), literal)
+
+
+def scan(sources):
+    """Map format ids to the format strings of the LOG_* calls under sources."""
+    formats = {}
+    for source in sources:
+        for path in sorted(Path(source).rglob("*")):
+            if path.suffix not in (".cpp", ".h") or not path.is_file():
+                continue
+            for literals in CALL.findall(path.read_text(errors="replace")):
+                # Adjacent literals are concatenated by the compiler
+                text = "".join(unescape(literal[1:-1]) for literal in re.findall(LITERAL, literals))
+                formats.setdefault(fnv1a(text), text)
+    return formats
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, size):
+        if self.pos + size > len(self.data):
+            raise ValueError("record truncated")
+        chunk = self.data[self.pos : self.pos + size]
+        self.pos += size
+        return chunk
+
+    def u32(self):
+        return struct.unpack("<I", self.take(4))[0]
+
+    def i32(self):
+        return struct.unpack("<i", self.take(4))[0]
+
+    def string(self):
+        return self.take(self.take(1)[0]).decode(errors="replace")
+
+
+def render(fmt, args):
+    """Format a record's arguments the way printf would have."""
+    out = []
+    last = 0
+    for match in SPEC.finditer(fmt):
+        out.append(fmt[last : match.start()])
+        last = match.end()
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            width = str(args.i32())
+        if precision == "*":
+            precision = str(args.i32())
+        if conversion == "p":
+            flags, conversion = flags + "#", "x"
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+        if conversion == "s":
+            value = args.string()
+        elif conversion in "fFeEgG":
+            value = struct.unpack("<f", args.take(4))[0]
+        elif length in ("ll", "j"):
+            value = struct.unpack("<q" if conversion in "di" else "<Q", args.take(8))[0]
+        else:
+            value = args.i32() if conversion in "di" else args.u32()
+        out.append((spec + ("d" if conversion in "iu" else conversion)) % value)
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def decode(data, formats):
+    """Yield one line of text per record of a dump."""
+    if data[:4] != MAGIC:
+        raise ValueError("not an event log dump")
+    used, dropped = struct.unpack("<HH", data[4:8])
+    if dropped:
+        yield f"({dropped} record(s) dropped before these)"
+
+    ring = Reader(data[8 : 8 + used])
+    boot = 0
+    while ring.pos < len(ring.data):
+        length = ring.take(1)[0]
+        if length < RECORD_HEADER:
+            raise ValueError(f"bad record length {length} at offset {ring.pos - 1}")
+        level = ring.take(1)[0]
+        record_id = ring.u32()
+        ms = ring.u32()
+        args = Reader(ring.take(length - RECORD_HEADER))
+
+        if record_id == ID_BOOT:
+            boot = args.u32()
+            text = f"--- boot {boot}, {args.u32()} ms to setup() ---"
+        elif record_id == ID_TEXT:
+            text = args.string()
+        elif record_id in formats:
+            try:
+                text = render(formats[record_id], args)
+            except (ValueError, TypeError, struct.error) as error:
+                text = f"{formats[record_id]!r} <{error}>"
+        else:
+            text = f"<unknown format {record_id:#010x}> {args.data.hex()}"
+        yield f"{boot:>5} {ms:>9} {LEVELS.get(level, '?'):<5} {text}"
+
+
+def main():
+    root = Path(__file__).resolve().parent.parent
+    parser = argparse.ArgumentParser(description=__doc__.split("\n", 1)[0])
+    parser.add_argument("dump", help="binary dump, as published on <topic>/log ('-' for stdin)")
+    parser.add_argument(
+        "--source",
+        action="append",
+        help="directory to scan for LOG_* format strings (default: src and lib)",
+    )
+    args = parser.parse_args()
+
+    data = sys.stdin.buffer.read() if args.dump == "-" else Path(args.dump).read_bytes()
+    formats = scan(args.source or [root / "src", root / "lib"])
+    try:
+        for line in decode(data, formats):
+            print(line)
+    except ValueError as error:
+        print(f"error: {error}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -9,18 +9,25 @@
  * - Sensor data validation
  * - NTP time synchronization for accurate timestamps
  * - Last Will and Testament for offline detection
+ * - Rain gauge and anemometer pulses counted on GPIO wakes
  */
 
 #include <Arduino.h>
 #include "BME280Sensor.h"
 #include "CertificateManager.h"
+#include "EventLog.h"
 #include "MqttClient.h"
 #include "PowerManager.h"
+#include "IntervalStats.h"
+#include "MemoryMonitor.h"
+#include "PulseCounter.h"
+#include "SensorHub.h"
 #include "TimeManager.h"
 #include "WiFiManager.h"
 #include "config.h"
 #include <Arduino.h>
 #include <Preferences.h>
+#include <esp_log.h>
 #include <esp_sleep.h>
 
 // CertificateManager adapters
@@ -30,6 +37,7 @@
 
 // Global objects
 BME280Sensor sensor(BME280_ADDRESS, BME280_SDA, BME280_SCL, SEA_LEVEL_PRESSURE);
+SensorHub sensors; // Every sensor sampled into the payload; add() more in setup()
 
 // WiFi credentials and sensor name will be loaded from NVS (supports "flash once, provision many")
 WiFiManager wifiManager;
@@ -41,247 +49,365 @@ WiFiAdapter wifiAdapter;
 CertificateManager certManager(certPrefs, &wifiAdapter, &arduinoAdapter);
 
 MqttClient mqttClient(MQTT_SERVER, MQTT_PORT, &certManager);
+RTC_DATA_ATTR MqttSessionState mqttSession; // Unacknowledged QoS 1 readings survive deep sleep
+RTC_DATA_ATTR RetryPolicyState mqttRetry;    // Circuit breaker for a station the broker rejects
+RTC_DATA_ATTR IntervalStatsState intervalStats; // Samples of sensor-only wakes since the last publish
+RTC_DATA_ATTR PulseCounterState pulseState;     // Rain and wind pulses since the last publish
+RTC_DATA_ATTR EventLogState eventLogState;      // Log records since the last upload
+RTC_DATA_ATTR WiFiCacheState wifiCache;         // WiFi credentials, so warm wakes skip reading them from NVS
+PulseCounter pulses(pulseState);
 PowerManager powerManager(SLEEP_DURATION);
 TimeManager timeManager(NTP_TIMEOUT_MS, NTP_SYNC_INTERVAL_MS);
-
-void printStatus(const char *component, bool success, const char *error = nullptr) {
-  Serial.print(component);
-  Serial.print(": ");
-  Serial.println(success ? "OK" : "FAILED");
-  if (!success && error) {
-    Serial.print("  Error: ");
-    Serial.println(error);
+MemoryMonitor memory; // Heap and stack after each phase of the wake
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+void printMeasurement(const Measurement &measurement) {
+  const ChannelInfo *info = Measurements::info(measurement.channel);
+  const char *suffix = Measurements::suffix(measurement.statistic);
+  if (!info || !suffix) {
+    return;
+  }
+  long divisor = 1;
+  for (uint8_t i = 0; i < info->scale; i++) {
+    divisor *= 10;
   }
+  long magnitude = labs(measurement.value);
+  LOG_DEBUG("%s%s: %s%ld.%0*ld", info->key, suffix, measurement.value < 0 ? "-" : "", magnitude / divisor,
+            static_cast<int>(info->scale), magnitude % divisor);
 }
+#endif
 
 void setup() {
+  // Milliseconds since reset: ROM, bootloader, image load and verification,
+  // runtime start-up; the part of every wake that grows with the image
+  uint32_t bootMs = esp_log_timestamp();
+
+  if (PULSE_RAIN_PIN >= 0) {
+    pulses.addInput(PULSE_RAIN_PIN, CHANNEL_RAIN_PULSES, PULSE_ACTIVE_LEVEL, PULSE_RAIN_DEBOUNCE_MS);
+  }
+  if (PULSE_WIND_PIN >= 0) {
+    pulses.addInput(PULSE_WIND_PIN, CHANNEL_WIND_PULSES, PULSE_ACTIVE_LEVEL, PULSE_WIND_DEBOUNCE_MS);
+  }
+  pulses.begin();
+  powerManager.setPulseCounter(&pulses);
+
+  // Pulse wake: count it and sleep out the interval, before anything else
+  // (serial, sensors, WiFi) gets a chance to spend energy
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+    pulses.onWake(esp_sleep_get_gpio_wakeup_status(), pulses.readLevels(), PowerManager::rtcMicros());
+    powerManager.sleepRemaining();
+  }
+
+  // Log into RTC memory; the serial port only starts when it echoes the log
+  EventLog::begin(&eventLogState, bootMs);
+#ifdef LOG_SERIAL
   Serial.begin(115200);
   delay(1000); // Give serial connection time to start
+#endif
+
+  LOG_INFO("=== TaraMeteo Weather Station ===");
+  LOG_DEBUG("Initializing components...");
+  memory.setWarnings(MEMORY_WARN_STACK_FREE, MEMORY_WARN_HEAP_BLOCK);
+
+  // Battery, read before the radio draws on it
+  powerManager.setBattery(BATTERY_PIN, BATTERY_SCALE_PERMILLE, BATTERY_OFFSET_MV);
+  EnergyPolicy energyPolicy = {BATTERY_LOW_MV, BATTERY_LOW_SLEEP_FACTOR, BATTERY_NO_NTP_MV, BATTERY_NO_RETRY_MV,
+                               BATTERY_CRITICAL_MV};
+  powerManager.setEnergyPolicy(energyPolicy);
+  if (powerManager.readBattery() > 0) {
+    LOG_INFO("Battery: %u mV", powerManager.getBatteryMv());
+  }
 
-  Serial.println("\n=== TaraMeteo Weather Station ===");
-  Serial.println("Sensor: (will be determined from certificate CN)");
-  Serial.println("Initializing components...");
-
-  // Initialize sensor
-  if (!sensor.begin()) {
-    printStatus("BME280 Sensor", false, sensor.getLastError());
+  // Initialize sensors
+  sensor.setBus(BME280_I2C_CLOCK, BME280_I2C_TIMEOUT_MS, BME280_I2C_RETRIES);
+  sensor.setAltitudeEnabled(BME280_ALTITUDE);
+  sensor.setOversampling(BME280_OVERSAMPLING_T, BME280_OVERSAMPLING_P, BME280_OVERSAMPLING_H);
+  sensor.setBurst(BME280_BURST, BME280_BURST_FILTER);
+  sensors.add(&sensor);
+  if (!sensors.begin()) {
+    LOG_ERROR("Sensors: FAILED (%s)", sensors.getLastError());
+    if (sensors.activeCount() == 0) {
+      powerManager.sleep();
+    }
+  }
+  LOG_INFO("Sensors: OK");
+  memory.mark("sensors");
+
+  // Sensor-only wake: fold one sample into the interval statistics and go
+  // straight back to sleep. WiFi, TLS and NTP only run on transmit wakes,
+  // and not at all on a critical battery: the samples wait for it to recover.
+  IntervalStats stats(intervalStats);
+  bool transmit =
+      esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER || stats.samples() + 1 >= SAMPLES_PER_TRANSMIT;
+  if (!powerManager.allowRadio()) {
+    LOG_ERROR("Battery: FAILED (%s)", "critical, radio disabled");
+    transmit = false;
+  }
+  // Nor while the broker keeps rejecting this station: the breaker counts
+  // down here, before WiFi, NTP and the certificates cost anything
+  mqttClient.setRetryState(&mqttRetry);
+  if (transmit && !mqttClient.startWake()) {
+    LOG_ERROR("MQTT Connection: FAILED (%s)", mqttClient.getLastError());
+    transmit = false;
+  }
+  if (!transmit) {
+    Measurements sample = {};
+    if (!sensors.sample(sample)) {
+      LOG_ERROR("Sensor Read: FAILED (%s)", sensors.getLastError());
+    }
+    stats.add(sample);
+    LOG_INFO("Sample %u/%u stored", stats.samples(), SAMPLES_PER_TRANSMIT);
+    memory.mark("sample");
+    powerManager.begin();
     powerManager.sleep();
   }
-  printStatus("BME280 Sensor", true);
 
   // Initialize WiFi Manager
-  Serial.println("Initializing WiFi manager...");
+  LOG_DEBUG("Initializing WiFi manager...");
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+  unsigned long settingsStart = micros(); // Time to read the stored settings, cached or not
+#endif
+  wifiManager.setCache(&wifiCache);
   if (!wifiManager.begin()) {
     // WiFi credentials not found in NVS - need provisioning
-    Serial.println("WiFi credentials not found in NVS");
+    LOG_WARN("WiFi credentials not found in NVS");
   }
 
   // Initialize certificate manager
-  Serial.println("Initializing certificate manager...");
+  LOG_DEBUG("Initializing certificate manager...");
   certManager.setWiFiManager(&wifiManager); // Link for unified provisioning
   if (!certManager.begin()) {
-    Serial.println("Certificates not found in NVS");
+    LOG_WARN("Certificates not found in NVS");
   }
-
-  // Check if provisioning is needed (WiFi or Certificates)
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+  LOG_INFO("Stored settings: %lu us, WiFi credentials from %s", micros() - settingsStart,
+           wifiManager.isFromCache() ? "RTC cache" : "NVS");
+#endif
+  memory.mark("nvs");
+
+  // Check if provisioning is needed (WiFi or Certificates). The instructions
+  // only reach a serial console in builds that echo the log (LOG_SERIAL).
   if (wifiManager.needsProvisioning() || certManager.needsProvisioning()) {
-    Serial.println("===========================================");
-    Serial.println("PROVISIONING MODE");
-    Serial.println("===========================================");
-    if (wifiManager.needsProvisioning()) {
-      Serial.println("WiFi credentials not found!");
-    }
-    if (certManager.needsProvisioning()) {
-      Serial.println("mTLS certificates not found!");
-    }
-    Serial.println();
-    Serial.println("Device is in provisioning mode.");
-    Serial.println();
-    Serial.println("To provision (WiFi + Certificates):");
-    Serial.printf("1. Connect to WiFi network: TaraMeteoProv-XXXX\n");
-    Serial.println("2. Open browser to: http://192.168.4.1");
-    Serial.println("3. Enter WiFi credentials and upload certificates");
-    Serial.println();
-    Serial.println("Device will wait up to 5 minutes for provisioning...");
-    Serial.println("===========================================");
+    LOG_WARN("PROVISIONING MODE: WiFi credentials %s, mTLS certificates %s",
+             wifiManager.needsProvisioning() ? "missing" : "found", certManager.needsProvisioning() ? "missing" : "found");
+    LOG_INFO("To provision (WiFi + Certificates): connect to WiFi network TaraMeteoProv-XXXX, open "
+             "http://192.168.4.1, enter WiFi credentials and upload certificates");
+    LOG_INFO("Device will wait up to 5 minutes for provisioning...");
 
     // Start provisioning mode with web server
     WebServerAdapter provisioningServer(80);
     if (!certManager.startProvisioningMode(&provisioningServer)) {
-      Serial.println("Failed to start provisioning mode!");
+      LOG_ERROR("Failed to start provisioning mode!");
       delay(5000);
       ESP.restart();
     }
 
     // Wait for provisioning - must call handleProvisioningLoop() to service HTTP requests
     unsigned long startTime = millis();
-    unsigned long lastDot = millis();
     while ((wifiManager.needsProvisioning() || certManager.needsProvisioning()) && (millis() - startTime) < 300000) {
       certManager.handleProvisioningLoop(); // Service HTTP requests
       delay(10);                            // Small delay to prevent watchdog issues
-
-      // Print progress dot every second
-      if (millis() - lastDot > 1000) {
-        Serial.print(".");
-        lastDot = millis();
-      }
     }
 
     if (wifiManager.needsProvisioning() || certManager.needsProvisioning()) {
-      Serial.println("\nProvisioning timeout. Rebooting...");
+      LOG_ERROR("Provisioning timeout. Rebooting...");
       delay(2000);
       ESP.restart();
     }
 
-    Serial.println("\nProvisioning completed! Rebooting...");
+    LOG_INFO("Provisioning completed! Rebooting...");
     delay(1000);
     ESP.restart();
   }
 
   // Connect to WiFi (credentials now loaded from NVS)
-  Serial.println("Connecting to WiFi...");
+  LOG_DEBUG("Connecting to WiFi...");
   if (!wifiManager.connect()) {
-    printStatus("WiFi Connection", false, wifiManager.getLastError());
-    Serial.println("Failed to connect to WiFi. Please re-provision.");
+    LOG_ERROR("WiFi Connection: FAILED (%s)", wifiManager.getLastError());
+    LOG_ERROR("Failed to connect to WiFi. Please re-provision.");
     delay(5000);
     wifiManager.clearCredentials();
     ESP.restart();
   }
-  printStatus("WiFi Connection", true);
-  Serial.printf("Connected to %s (IP: %s)\n", wifiManager.getSSID(), wifiManager.getIP());
-  Serial.printf("WiFi RSSI: %d dBm\n", wifiManager.getRSSI());
+  LOG_INFO("WiFi Connection: OK");
+  LOG_INFO("Connected to %s (IP: %s)", wifiManager.getSSID(), wifiManager.getIP());
+  LOG_INFO("WiFi RSSI: %d dBm", wifiManager.getRSSI());
+  memory.mark("wifi");
 
   // Validate certificates before proceeding
   if (!certManager.validateCertificates()) {
-    printStatus("Certificate Validation", false, certManager.getLastError());
-    Serial.println("Certificate validation failed. Please re-provision.");
+    LOG_ERROR("Certificate Validation: FAILED (%s)", certManager.getLastError());
+    LOG_ERROR("Certificate validation failed. Please re-provision.");
     delay(5000);
     certManager.clearCertificates();
     ESP.restart();
   }
-  printStatus("Certificate Validation", true);
-  Serial.printf("Certificate CN: %s\n", certManager.getCN());
-  Serial.printf("Sensor Name: %s (from certificate)\n", certManager.getSensorName());
-  Serial.printf("Certificate expires: %lu\n", certManager.getExpirationTime());
-
-  // Initialize time manager
-  if (!timeManager.begin()) {
-    printStatus("Time Manager", false, timeManager.getLastError());
-    powerManager.sleep();
-  }
-  printStatus("Time Manager", true);
-
-  // Sync time with NTP servers
-  Serial.println("Synchronizing time with NTP servers...");
-  if (!timeManager.syncTime()) {
-    printStatus("Time Sync", false, timeManager.getLastError());
-    Serial.println("Warning: Using device uptime for timestamps");
+  LOG_INFO("Certificate Validation: OK");
+  LOG_DEBUG("Certificate CN: %s", certManager.getCN());
+  LOG_INFO("Sensor Name: %s (from certificate)", certManager.getSensorName());
+  LOG_DEBUG("Certificate expires: %lu", certManager.getExpirationTime());
+  memory.mark("certificates");
+
+  // Initialize time manager; on a low battery, keep the RTC time rather
+  // than wait for NTP
+  bool timeSynced;
+  if (!powerManager.allowNtp()) {
+    timeSynced = timeManager.useClock();
   } else {
-    printStatus("Time Sync", true);
-    Serial.printf("Current timestamp: %lu\n", timeManager.getCurrentTimestamp());
-
-    // Display formatted time
-    char timeString[32];
-    if (timeManager.getFormattedTime(timeString, sizeof(timeString))) {
-      Serial.printf("Current time: %s\n", timeString);
+    if (!timeManager.begin()) {
+      LOG_ERROR("Time Manager: FAILED (%s)", timeManager.getLastError());
+      powerManager.sleep();
     }
+    LOG_INFO("Time Manager: OK");
+
+    // Sync time with NTP servers
+    LOG_DEBUG("Synchronizing time with NTP servers...");
+    timeSynced = timeManager.syncTime();
+  }
+  if (!timeSynced) {
+    LOG_WARN("Time Sync: FAILED (%s), using device uptime for timestamps", timeManager.getLastError());
+  } else {
+    LOG_INFO("Time Sync: OK, timestamp %lu%s", timeManager.getCurrentTimestamp(),
+             powerManager.allowNtp() ? "" : " (RTC, battery low)");
   }
+  memory.mark("time");
 
   // Initialize MQTT client (certificates already loaded by CertificateManager)
+  mqttClient.setStatusInPayload(MQTT_STATUS_IN_PAYLOAD);
+  mqttClient.setQos(MQTT_QOS);
+  mqttClient.setSessionState(&mqttSession);
+  mqttClient.setMaxFragmentLength(MQTT_TLS_MAX_FRAGMENT);
+  mqttClient.setRetriesEnabled(powerManager.allowRetries());
   if (!mqttClient.begin()) {
-    printStatus("MQTT Client", false, mqttClient.getLastError());
+    LOG_ERROR("MQTT Client: FAILED (%s)", mqttClient.getLastError());
     powerManager.sleep();
   }
-  printStatus("MQTT Client", true);
+  LOG_INFO("MQTT Client: OK");
 
   // Connect to MQTT broker
-  Serial.println("Connecting to MQTT broker...");
+  LOG_DEBUG("Connecting to MQTT broker...");
   if (!mqttClient.connect()) {
-    printStatus("MQTT Connection", false, mqttClient.getLastError());
+    LOG_ERROR("MQTT Connection: FAILED (%s)", mqttClient.getLastError());
     // Continue anyway - will retry in loop
   } else {
-    printStatus("MQTT Connection", true);
-    Serial.printf("Connected to %s:%d\n", MQTT_SERVER, MQTT_PORT);
+    LOG_INFO("MQTT Connection: OK");
+    LOG_DEBUG("Connected to %s:%d", MQTT_SERVER, MQTT_PORT);
   }
+  memory.mark("tls");
 
   // Initialize power management
   if (!powerManager.begin()) {
-    printStatus("Power Manager", false, powerManager.getLastError());
+    LOG_ERROR("Power Manager: FAILED (%s)", powerManager.getLastError());
     powerManager.sleep();
   }
-  printStatus("Power Manager", true);
+  LOG_INFO("Power Manager: OK");
 
-  Serial.println("All components initialized successfully");
-  Serial.printf("Sleep duration: %d seconds (%.1f minutes)\n", SLEEP_DURATION, SLEEP_DURATION / 60.0);
-  Serial.println("Starting main loop...\n");
+  LOG_INFO("All components initialized successfully");
+  LOG_DEBUG("Sleep duration: %lu seconds (%.1f minutes)", powerManager.getSleepDuration(),
+            powerManager.getSleepDuration() / 60.0);
 }
 
 void loop() {
   // Check sensor availability
-  if (!sensor.isAvailable()) {
-    printStatus("Sensor Check", false, sensor.getLastError());
+  if (sensors.activeCount() == 0) {
+    LOG_ERROR("Sensor Check: FAILED (%s)", sensors.getLastError());
     powerManager.sleep();
   }
 
   // Check WiFi connection
   if (!wifiManager.isConnected()) {
-    Serial.println("WiFi disconnected, attempting to reconnect...");
+    LOG_WARN("WiFi disconnected, attempting to reconnect...");
     if (!wifiManager.reconnect()) {
-      printStatus("WiFi Reconnect", false, wifiManager.getLastError());
-      Serial.printf("Reconnect attempts: %d/%d\n", wifiManager.getReconnectAttempts(),
-                    WiFiManager::MAX_RECONNECT_ATTEMPTS);
+      LOG_ERROR("WiFi Reconnect: FAILED (%s)", wifiManager.getLastError());
+      LOG_WARN("Reconnect attempts: %d/%d", wifiManager.getReconnectAttempts(), WiFiManager::MAX_RECONNECT_ATTEMPTS);
       powerManager.sleep();
     }
-    printStatus("WiFi Reconnect", true);
-    Serial.printf("Reconnected to %s (IP: %s)\n", wifiManager.getSSID(), wifiManager.getIP());
+    LOG_INFO("WiFi Reconnect: OK");
+    LOG_INFO("Reconnected to %s (IP: %s)", wifiManager.getSSID(), wifiManager.getIP());
   }
 
   // Read sensor data
+  unsigned long timestamp = timeManager.getCurrentTimestamp();
   WeatherData data = {
-      sensor.getTemperature(),
-      sensor.getPressure(),
-      sensor.getHumidity(),
-      sensor.getAltitude(),
+      {},
       wifiManager.getRSSI(),
-      timeManager.getCurrentTimestamp(),
-      0 // retryCount will be updated by MQTT client
+      timestamp,
+      0, // retryCount will be updated by MQTT client
+      timeManager.isTimeSynced() ? timestamp + powerManager.getSleepDuration() * SAMPLES_PER_TRANSMIT : 0, // nextWake
+      0, // sequence and epoch are assigned by the MQTT session at QoS 1
+      0
   };
+  if (!sensors.sample(data.measurements)) {
+    LOG_ERROR("Sensor Read: FAILED (%s)", sensors.getLastError());
+    if (data.measurements.count == 0) {
+      powerManager.sleep();
+    }
+  }
 
-  // Print sensor readings
-  Serial.println("Sensor Readings:");
-  Serial.printf("Temperature: %.1f°C\n", data.temperature);
-  Serial.printf("Pressure: %.1f hPa\n", data.pressure);
-  Serial.printf("Humidity: %.1f%%\n", data.humidity);
-  Serial.printf("Altitude: %.1f m\n", data.altitude);
-  Serial.printf("WiFi RSSI: %d dBm\n", data.rssi);
-  Serial.printf("Timestamp: %lu\n", data.timestamp);
-
-  // Display formatted time if available
-  if (timeManager.isTimeSynced()) {
-    char timeString[32];
-    if (timeManager.getFormattedTime(timeString, sizeof(timeString))) {
-      Serial.printf("Time: %s\n", timeString);
+  // Statistics over this sample and those of the sensor-only wakes before it
+  // (including any taken while the battery was critical)
+  IntervalStats stats(intervalStats);
+  if (SAMPLES_PER_TRANSMIT > 1 || stats.samples() > 0) {
+    stats.add(data.measurements);
+    if (!stats.summarize(data.measurements)) {
+      LOG_WARN("interval statistics truncated");
     }
   }
 
+  if (powerManager.getBatteryMv() > 0) {
+    data.measurements.add(CHANNEL_BATTERY, powerManager.getBatteryMv());
+  }
+
+  // Pulses counted by the wakes since the last publish
+  if (!pulses.collect(data.measurements)) {
+    LOG_WARN("pulse counts truncated");
+  }
+
+  // Heap and stack low-water marks up to here, TLS handshake included
+  memory.mark("read");
+  if (MEMORY_IN_PAYLOAD && !memory.report(data.measurements)) {
+    LOG_WARN("memory diagnostics truncated");
+  }
+
+  // Sensor readings, already in the payload: debug builds only
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+  for (uint8_t i = 0; i < data.measurements.count; i++) {
+    printMeasurement(data.measurements.items[i]);
+  }
+#endif
+  LOG_DEBUG("Timestamp: %lu", data.timestamp);
+
   // Publish data to MQTT broker
-  Serial.println("\nPublishing data to MQTT broker...");
-  if (!mqttClient.publishWeatherData(data)) {
-    printStatus("Data Publish", false, mqttClient.getLastError());
-    Serial.printf("Retry count: %d/%d\n", mqttClient.getRetryCount(), MqttClient::MAX_RETRIES);
+  LOG_DEBUG("Publishing data to MQTT broker...");
+  bool published = mqttClient.publishWeatherData(data);
+
+  // A QoS 0 interval that failed to publish is merged into the next one. At
+  // QoS 1 the reading, statistics and pulse counts included, stays queued and
+  // is resent, so the next one starts afresh.
+  if (published || mqttClient.isReadingQueued()) {
+    stats.clear();
+    pulses.clear();
+  }
+  if (!published) {
+    LOG_ERROR("Data Publish: FAILED (%s)", mqttClient.getLastError());
+    LOG_WARN("Retry count: %d/%d", mqttClient.getRetryCount(), MqttClient::MAX_RETRIES);
 
     // Store retry count for next attempt
     data.retryCount = mqttClient.getRetryCount();
   } else {
-    printStatus("Data Publish", true);
-    Serial.printf("Data published successfully to topic: weather/%s\n", certManager.getSensorName());
+    LOG_INFO("Data Publish: OK");
+
+    // Upload the event log while connected, once it holds something worth reading
+    if (EventLog::holds(LOG_UPLOAD_LEVEL) && !mqttClient.publishLog()) {
+      LOG_ERROR("Log Upload: FAILED (%s)", mqttClient.getLastError());
+    }
   }
 
   // Disconnect from MQTT (reduces power consumption during sleep)
   mqttClient.disconnect();
+  memory.mark("publish");
 
   // Enter deep sleep regardless of publish status
-  Serial.printf("Entering deep sleep for %d seconds...\n", SLEEP_DURATION);
-  Serial.println("=====================================\n");
+  LOG_INFO("Entering deep sleep for %lu seconds...", powerManager.getSleepDuration());
   powerManager.sleep();
 }
@@ -0,0 +1,70 @@
+#!/bin/sh
+#
+# Regenerate pki_fixtures.h, the certificates used by native tests and
+# benchmarks. The CA comes from pki/init.sh, exactly as in deployment; the
+# broker and device certificates mirror what certbot and the issuer produce.
+
+set -eu
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+DAYS=7300
+DEVICE_ID="station-01"
+BROKER_HOST="broker.local"
+
+PKI_DIR="$WORK" CA_DAYS="$DAYS" sh "$HERE/../../../pki/init.sh" >/dev/null
+
+sign() {
+  # sign <name> <subject> <extensions>
+  openssl req -new -key "$WORK/$1.key" -subj "$2" -out "$WORK/$1.csr"
+  printf '%b\n' "$3" > "$WORK/$1.ext"
+  openssl x509 -req -in "$WORK/$1.csr" -CA "$WORK/ca.crt" -CAkey "$WORK/ca.key" \
+    -set_serial "0x01$(openssl rand -hex 15)" -days "$DAYS" -sha256 \
+    -extfile "$WORK/$1.ext" -out "$WORK/$1.crt" 2>/dev/null
+}
+
+SERVER_EXT="basicConstraints=critical,CA:FALSE\nextendedKeyUsage=serverAuth\nsubjectAltName=DNS:$BROKER_HOST"
+DEVICE_EXT="basicConstraints=critical,CA:FALSE\nextendedKeyUsage=clientAuth"
+
+openssl ecparam -name prime256v1 -genkey -noout -out "$WORK/server_ec.key"
+sign server_ec "/CN=$BROKER_HOST" "$SERVER_EXT"
+
+openssl genrsa -traditional -out "$WORK/server_rsa.key" 2048 2>/dev/null
+sign server_rsa "/CN=$BROKER_HOST" "$SERVER_EXT"
+
+# Same key formats as backend/tarameteo/issuer.py (TraditionalOpenSSL)
+openssl genrsa -traditional -out "$WORK/device_rsa.key" 2048 2>/dev/null
+sign device_rsa "/CN=$DEVICE_ID" "$DEVICE_EXT\nkeyUsage=critical,digitalSignature,keyEncipherment"
+
+openssl ecparam -name prime256v1 -genkey -noout -out "$WORK/device_ec.key"
+sign device_ec "/CN=$DEVICE_ID" "$DEVICE_EXT\nkeyUsage=critical,digitalSignature"
+
+emit() {
+  # emit <symbol> <file>
+  printf 'static const char %s[] =\n' "$1"
+  sed 's/^\(.*\)$/    "\1\\n"/' "$2"
+  printf '    ;\n\n'
+}
+
+{
+  printf '// Generated by test/fixtures/generate.sh - do not edit\n\n'
+  printf '#ifndef PKI_FIXTURES_H\n#define PKI_FIXTURES_H\n\n'
+  printf '#define FIXTURE_DEVICE_ID "%s"\n' "$DEVICE_ID"
+  printf '#define FIXTURE_BROKER_HOST "%s"\n' "$BROKER_HOST"
+  printf '#define FIXTURE_SERIAL_DEVICE_RSA "%s"\n' "$(openssl x509 -in "$WORK/device_rsa.crt" -noout -serial | cut -d= -f2)"
+  printf '#define FIXTURE_SERIAL_DEVICE_EC "%s"\n' "$(openssl x509 -in "$WORK/device_ec.crt" -noout -serial | cut -d= -f2)"
+  printf '#define FIXTURE_NOT_AFTER_DEVICE_RSA %sUL\n' "$(date -u -d "$(openssl x509 -in "$WORK/device_rsa.crt" -noout -enddate | cut -d= -f2)" +%s)"
+  printf '#define FIXTURE_NOT_AFTER_DEVICE_EC %sUL\n\n' "$(date -u -d "$(openssl x509 -in "$WORK/device_ec.crt" -noout -enddate | cut -d= -f2)" +%s)"
+  emit FIXTURE_CA_CERT "$WORK/ca.crt"
+  emit FIXTURE_SERVER_EC_CERT "$WORK/server_ec.crt"
+  emit FIXTURE_SERVER_EC_KEY "$WORK/server_ec.key"
+  emit FIXTURE_SERVER_RSA_CERT "$WORK/server_rsa.crt"
+  emit FIXTURE_SERVER_RSA_KEY "$WORK/server_rsa.key"
+  emit FIXTURE_DEVICE_RSA_CERT "$WORK/device_rsa.crt"
+  emit FIXTURE_DEVICE_RSA_KEY "$WORK/device_rsa.key"
+  emit FIXTURE_DEVICE_EC_CERT "$WORK/device_ec.crt"
+  emit FIXTURE_DEVICE_EC_KEY "$WORK/device_ec.key"
+  printf '#endif // PKI_FIXTURES_H\n'
+} > "$HERE/pki_fixtures.h"
@@ -0,0 +1,259 @@
+#ifndef ADAFRUIT_BME280_H_MOCK
+#define ADAFRUIT_BME280_H_MOCK
+
+#ifdef UNIT_TEST
+
+#include <math.h>
+#include <stdint.h>
+#include "Wire.h"
+
+// Mock Adafruit_BME280 class
+// Calibration and raw readings are read over the mock Wire bus (see
+// MockBME280) and go through the library's compensation code unchanged.
+class Adafruit_BME280 {
+public:
+    enum sensor_sampling {
+        SAMPLING_NONE = 0b000,
+        SAMPLING_X1 = 0b001,
+        SAMPLING_X2 = 0b010,
+        SAMPLING_X4 = 0b011,
+        SAMPLING_X8 = 0b100,
+        SAMPLING_X16 = 0b101
+    };
+
+    enum sensor_mode { MODE_SLEEP = 0b00, MODE_FORCED = 0b01, MODE_NORMAL = 0b11 };
+
+    enum sensor_filter {
+        FILTER_OFF = 0b000,
+        FILTER_X2 = 0b001,
+        FILTER_X4 = 0b010,
+        FILTER_X8 = 0b011,
+        FILTER_X16 = 0b100
+    };
+
+    enum standby_duration {
+        STANDBY_MS_0_5 = 0b000,
+        STANDBY_MS_10 = 0b110,
+        STANDBY_MS_20 = 0b111,
+        STANDBY_MS_62_5 = 0b001,
+        STANDBY_MS_125 = 0b010,
+        STANDBY_MS_250 = 0b011,
+        STANDBY_MS_500 = 0b100,
+        STANDBY_MS_1000 = 0b101
+    };
+
+    bool begin(uint8_t addr = 0x77, TwoWire* theWire = &Wire) {
+        _i2caddr = addr;
+        _wire = theWire;
+        if (read8(BME280_REGISTER_CHIPID) != 0x60) {
+            return false;
+        }
+        readCoefficients();
+        return true;
+    }
+
+    void setSampling(sensor_mode mode = MODE_NORMAL, sensor_sampling tempSampling = SAMPLING_X16,
+                     sensor_sampling pressSampling = SAMPLING_X16, sensor_sampling humSampling = SAMPLING_X16,
+                     sensor_filter filter = FILTER_OFF, standby_duration duration = STANDBY_MS_0_5) {
+        (void)mode; (void)tempSampling; (void)pressSampling; (void)humSampling; (void)filter; (void)duration;
+    }
+
+    float readTemperature() {
+        int32_t var1, var2;
+        int32_t adc_T = read24(BME280_REGISTER_TEMPDATA);
+        if (adc_T == 0x800000) { // value in case temp measurement was disabled
+            return NAN;
+        }
+        adc_T >>= 4;
+
+        var1 = (int32_t)((adc_T / 8) - ((int32_t)_bme280_calib.dig_T1 * 2));
+        var1 = (var1 * ((int32_t)_bme280_calib.dig_T2)) / 2048;
+        var2 = (int32_t)((adc_T / 16) - ((int32_t)_bme280_calib.dig_T1));
+        var2 = (((var2 * var2) / 4096) * ((int32_t)_bme280_calib.dig_T3)) / 16384;
+
+        t_fine = var1 + var2;
+
+        int32_t T = (t_fine * 5 + 128) / 256;
+        return (float)T / 100;
+    }
+
+    float readPressure() {
+        int64_t var1, var2, var3, var4;
+
+        readTemperature(); // must be done first to get t_fine
+
+        int32_t adc_P = read24(BME280_REGISTER_PRESSUREDATA);
+        if (adc_P == 0x800000) { // value in case pressure measurement was disabled
+            return NAN;
+        }
+        adc_P >>= 4;
+
+        var1 = ((int64_t)t_fine) - 128000;
+        var2 = var1 * var1 * (int64_t)_bme280_calib.dig_P6;
+        var2 = var2 + ((var1 * (int64_t)_bme280_calib.dig_P5) * 131072);
+        var2 = var2 + (((int64_t)_bme280_calib.dig_P4) * 34359738368);
+        var1 = ((var1 * var1 * (int64_t)_bme280_calib.dig_P3) / 256) + ((var1 * ((int64_t)_bme280_calib.dig_P2) * 4096));
+        var3 = ((int64_t)1) * 140737488355328;
+        var1 = (var3 + var1) * ((int64_t)_bme280_calib.dig_P1) / 8589934592;
+
+        if (var1 == 0) {
+            return 0; // avoid exception caused by division by zero
+        }
+
+        var4 = 1048576 - adc_P;
+        var4 = (((var4 * 2147483648) - var2) * 3125) / var1;
+        var1 = (((int64_t)_bme280_calib.dig_P9) * (var4 / 8192) * (var4 / 8192)) / 33554432;
+        var2 = (((int64_t)_bme280_calib.dig_P8) * var4) / 524288;
+        var4 = ((var4 + var1 + var2) / 256) + (((int64_t)_bme280_calib.dig_P7) * 16);
+
+        float P = var4 / 256.0;
+        return P;
+    }
+
+    float readHumidity() {
+        int32_t var1, var2, var3, var4, var5;
+
+        readTemperature(); // must be done first to get t_fine
+
+        int32_t adc_H = read16(BME280_REGISTER_HUMIDDATA);
+        if (adc_H == 0x8000) { // value in case humidity measurement was disabled
+            return NAN;
+        }
+
+        var1 = t_fine - ((int32_t)76800);
+        var2 = (int32_t)(adc_H * 16384);
+        var3 = (int32_t)(((int32_t)_bme280_calib.dig_H4) * 1048576);
+        var4 = ((int32_t)_bme280_calib.dig_H5) * var1;
+        var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
+        var2 = (var1 * ((int32_t)_bme280_calib.dig_H6)) / 1024;
+        var3 = (var1 * ((int32_t)_bme280_calib.dig_H3)) / 2048;
+        var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
+        var2 = ((var4 * ((int32_t)_bme280_calib.dig_H2)) + 8192) / 16384;
+        var3 = var5 * var2;
+        var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
+        var5 = var3 - ((var4 * ((int32_t)_bme280_calib.dig_H1)) / 16);
+        var5 = (var5 < 0 ? 0 : var5);
+        var5 = (var5 > 419430400 ? 419430400 : var5);
+        uint32_t H = (uint32_t)(var5 / 4096);
+
+        return (float)H / 1024.0;
+    }
+
+    float readAltitude(float seaLevel) {
+        float atmospheric = readPressure() / 100.0F;
+        return 44330.0 * (1.0 - pow(atmospheric / seaLevel, 0.1903));
+    }
+
+private:
+    enum {
+        BME280_REGISTER_DIG_T1 = 0x88,
+        BME280_REGISTER_DIG_T2 = 0x8A,
+        BME280_REGISTER_DIG_T3 = 0x8C,
+        BME280_REGISTER_DIG_P1 = 0x8E,
+        BME280_REGISTER_DIG_P2 = 0x90,
+        BME280_REGISTER_DIG_P3 = 0x92,
+        BME280_REGISTER_DIG_P4 = 0x94,
+        BME280_REGISTER_DIG_P5 = 0x96,
+        BME280_REGISTER_DIG_P6 = 0x98,
+        BME280_REGISTER_DIG_P7 = 0x9A,
+        BME280_REGISTER_DIG_P8 = 0x9C,
+        BME280_REGISTER_DIG_P9 = 0x9E,
+        BME280_REGISTER_DIG_H1 = 0xA1,
+        BME280_REGISTER_DIG_H2 = 0xE1,
+        BME280_REGISTER_DIG_H3 = 0xE3,
+        BME280_REGISTER_DIG_H4 = 0xE4,
+        BME280_REGISTER_DIG_H5 = 0xE5,
+        BME280_REGISTER_DIG_H6 = 0xE7,
+        BME280_REGISTER_CHIPID = 0xD0,
+        BME280_REGISTER_PRESSUREDATA = 0xF7,
+        BME280_REGISTER_TEMPDATA = 0xFA,
+        BME280_REGISTER_HUMIDDATA = 0xFD
+    };
+
+    struct bme280_calib_data {
+        uint16_t dig_T1;
+        int16_t dig_T2;
+        int16_t dig_T3;
+        uint16_t dig_P1;
+        int16_t dig_P2;
+        int16_t dig_P3;
+        int16_t dig_P4;
+        int16_t dig_P5;
+        int16_t dig_P6;
+        int16_t dig_P7;
+        int16_t dig_P8;
+        int16_t dig_P9;
+        uint8_t dig_H1;
+        int16_t dig_H2;
+        uint8_t dig_H3;
+        int16_t dig_H4;
+        int16_t dig_H5;
+        int8_t dig_H6;
+    };
+
+    TwoWire* _wire = nullptr;
+    uint8_t _i2caddr = 0x77;
+    int32_t t_fine = 0;
+    bme280_calib_data _bme280_calib = {};
+
+    void readRegisters(uint8_t reg, uint8_t* buffer, size_t length) {
+        _wire->beginTransmission(_i2caddr);
+        _wire->write(reg);
+        _wire->endTransmission();
+        _wire->requestFrom(_i2caddr, length);
+        for (size_t i = 0; i < length; i++) {
+            buffer[i] = static_cast<uint8_t>(_wire->read());
+        }
+    }
+
+    uint8_t read8(uint8_t reg) {
+        uint8_t buffer[1];
+        readRegisters(reg, buffer, 1);
+        return buffer[0];
+    }
+
+    uint16_t read16(uint8_t reg) {
+        uint8_t buffer[2];
+        readRegisters(reg, buffer, 2);
+        return static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+    }
+
+    uint16_t read16_LE(uint8_t reg) {
+        uint16_t temp = read16(reg);
+        return (temp >> 8) | (temp << 8);
+    }
+
+    int16_t readS16_LE(uint8_t reg) { return (int16_t)read16_LE(reg); }
+
+    uint32_t read24(uint8_t reg) {
+        uint8_t buffer[3];
+        readRegisters(reg, buffer, 3);
+        return (static_cast<uint32_t>(buffer[0]) << 16) | (static_cast<uint32_t>(buffer[1]) << 8) | buffer[2];
+    }
+
+    void readCoefficients() {
+        _bme280_calib.dig_T1 = read16_LE(BME280_REGISTER_DIG_T1);
+        _bme280_calib.dig_T2 = readS16_LE(BME280_REGISTER_DIG_T2);
+        _bme280_calib.dig_T3 = readS16_LE(BME280_REGISTER_DIG_T3);
+
+        _bme280_calib.dig_P1 = read16_LE(BME280_REGISTER_DIG_P1);
+        _bme280_calib.dig_P2 = readS16_LE(BME280_REGISTER_DIG_P2);
+        _bme280_calib.dig_P3 = readS16_LE(BME280_REGISTER_DIG_P3);
+        _bme280_calib.dig_P4 = readS16_LE(BME280_REGISTER_DIG_P4);
+        _bme280_calib.dig_P5 = readS16_LE(BME280_REGISTER_DIG_P5);
+        _bme280_calib.dig_P6 = readS16_LE(BME280_REGISTER_DIG_P6);
+        _bme280_calib.dig_P7 = readS16_LE(BME280_REGISTER_DIG_P7);
+        _bme280_calib.dig_P8 = readS16_LE(BME280_REGISTER_DIG_P8);
+        _bme280_calib.dig_P9 = readS16_LE(BME280_REGISTER_DIG_P9);
+
+        _bme280_calib.dig_H1 = read8(BME280_REGISTER_DIG_H1);
+        _bme280_calib.dig_H2 = readS16_LE(BME280_REGISTER_DIG_H2);
+        _bme280_calib.dig_H3 = read8(BME280_REGISTER_DIG_H3);
+        _bme280_calib.dig_H4 = ((int8_t)read8(BME280_REGISTER_DIG_H4) << 4) | (read8(BME280_REGISTER_DIG_H4 + 1) & 0xF);
+        _bme280_calib.dig_H5 = ((int8_t)read8(BME280_REGISTER_DIG_H5 + 1) << 4) | (read8(BME280_REGISTER_DIG_H5) >> 4);
+        _bme280_calib.dig_H6 = (int8_t)read8(BME280_REGISTER_DIG_H6);
+    }
+};
+
+#endif // UNIT_TEST
+#endif // ADAFRUIT_BME280_H_MOCK
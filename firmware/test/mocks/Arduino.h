@@ -10,6 +10,13 @@
 #include <stdarg.h>
 #include <time.h>
 #include <string>
+#ifdef NATIVE_BENCH
+#include "Bench.h"
+#define COUNT_ALLOCATIONS
+#endif
+#ifdef COUNT_ALLOCATIONS
+#include "HeapCounter.h"
+#endif
 
 // Mock Arduino types
 typedef uint8_t byte;
@@ -45,10 +52,18 @@ class __FlashStringHelper;
 
 // Mock Arduino functions (declared but not defined inline to allow override)
 unsigned long millis();
+unsigned long micros();
 void delay(unsigned long ms);
+inline void yield() {}
 inline void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
 inline void digitalWrite(uint8_t pin, uint8_t val) { (void)pin; (void)val; }
 inline int digitalRead(uint8_t pin) { (void)pin; return 0; }
+uint32_t analogReadMilliVolts(uint8_t pin);  // Defined by tests that sample the ADC
+
+// FreeRTOS task stack query (bytes on ESP-IDF)
+typedef void* TaskHandle_t;
+typedef unsigned int UBaseType_t;
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);  // Defined by tests that read the stack
 
 // Mock Print base class
 class Print {
@@ -261,7 +276,17 @@ private:
 class MockESP {
 public:
     void restart() {}
+#ifdef COUNT_ALLOCATIONS
+    // The host allocator's bytes in use, against a HeapCounter::HEAP_SIZE heap
+    // that never fragments
+    uint32_t getFreeHeap() { return static_cast<uint32_t>(HeapCounter::HEAP_SIZE - HeapCounter::heap().current); }
+    uint32_t getMinFreeHeap() { return static_cast<uint32_t>(HeapCounter::HEAP_SIZE - HeapCounter::heap().highest); }
+    uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+#else
     uint32_t getFreeHeap() { return 100000; }
+    uint32_t getMinFreeHeap() { return 100000; }
+    uint32_t getMaxAllocHeap() { return 100000; }
+#endif
     uint32_t getChipId() { return 12345; }
     const char* getSdkVersion() { return "mock"; }
 };
@@ -0,0 +1,98 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#ifdef UNIT_TEST
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "HeapCounter.h"
+#include "StackProbe.h"
+
+// Host-side benchmark helpers.
+//
+// Time is process CPU time rather than wall-clock time, so that results do not
+// depend on what else the host is doing. Results are printed as one line per
+// measurement, "BENCH <name> key=value ...", for scripts to pick up.
+//
+// run() produces the lines that scripts/bench_compare.py gates on: a dotted
+// id and exactly the fields ns, allocs, heap and stack. Time is the best of a
+// few batches; the other three come from a single call and are deterministic.
+//
+// Heap use is counted by HeapCounter, which interposes malloc and friends.
+class Bench {
+public:
+    typedef HeapCounter::Heap Heap;
+    typedef HeapCounter::Pause Pause;
+
+    struct Result {
+        int64_t nanos;      // CPU time per call
+        size_t allocations; // Allocations per call
+        size_t heap;        // Peak heap bytes above the level before the call
+        size_t stack;       // Stack high-water of one call
+    };
+
+    static const int BATCHES = 5;
+
+    static Heap& heap() { return HeapCounter::heap(); }
+    static void resetPeak() { HeapCounter::resetPeak(); }
+
+    static int64_t cpuNanos() {
+        struct timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    __attribute__((format(printf, 2, 3))) static void report(const char* name, const char* format, ...) {
+        char fields[256];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(fields, sizeof(fields), format, args);
+        va_end(args);
+        printf("BENCH %s %s\n", name, fields);
+    }
+
+    // Hides a value from the optimizer, so that calls on constants (e.g.
+    // strstr() on a fixture) are not folded at compile time
+    template <typename T> static T opaque(T value) {
+        asm volatile("" : "+r"(value));
+        return value;
+    }
+
+    template <typename Callable> static Result run(const char* id, int calls, Callable callable) {
+        Result result;
+
+        // Warm up first, so that one-time allocations (e.g. static buffers) are
+        // not charged to the measured call
+        callable();
+        size_t allocationsBefore = heap().allocations;
+        resetPeak();
+        size_t heapBefore = heap().current;
+        callable();
+        result.allocations = heap().allocations - allocationsBefore;
+        result.heap = heap().peak - heapBefore;
+
+        result.nanos = INT64_MAX;
+        for (int batch = 0; batch < BATCHES; batch++) {
+            int64_t start = cpuNanos();
+            for (int n = 0; n < calls; n++) {
+                callable();
+            }
+            int64_t nanos = (cpuNanos() - start) / calls;
+            if (nanos < result.nanos) {
+                result.nanos = nanos;
+            }
+        }
+
+        result.stack = StackProbe::measure(callable);
+
+        report(id, "ns=%lld allocs=%zu heap=%zu stack=%zu", (long long)result.nanos, result.allocations,
+               result.heap, result.stack);
+        return result;
+    }
+};
+
+#endif // UNIT_TEST
+#endif // BENCH_H
@@ -0,0 +1,100 @@
+#ifndef HEAP_COUNTER_H
+#define HEAP_COUNTER_H
+
+#ifdef UNIT_TEST
+
+#include <malloc.h>
+#include <stddef.h>
+
+// Host-side allocation counting (-DCOUNT_ALLOCATIONS; implied by NATIVE_BENCH).
+//
+// malloc and friends are interposed (glibc), so that allocations inside
+// host libraries such as libmbedtls are seen too: every allocation of the
+// binary goes through these counters. MockESP reports them against a heap
+// of HEAP_SIZE bytes, the way the device's free heap queries would.
+class HeapCounter {
+public:
+    static const size_t HEAP_SIZE = 320 * 1024;
+
+    struct Heap {
+        size_t allocations; // Number of malloc/calloc/realloc calls
+        size_t frees;       // Number of free calls (and reallocs that moved)
+        size_t current;     // Bytes in use
+        size_t peak;        // High-water mark of current since resetPeak()
+        size_t highest;     // High-water mark of current since start
+        int paused;         // Allocations in paused sections aren't counted
+    };
+
+    // Excludes allocations of a stand-in (e.g. the TLS server) from the counts
+    class Pause {
+    public:
+        Pause() { heap().paused++; }
+        ~Pause() { heap().paused--; }
+    };
+
+    static Heap& heap() {
+        static Heap state = {0, 0, 0, 0, 0, 0};
+        return state;
+    }
+
+    static void resetPeak() { heap().peak = heap().current; }
+
+    static void trackAlloc(void* ptr) {
+        Heap& h = heap();
+        if (!ptr || h.paused) {
+            return;
+        }
+        h.allocations++;
+        h.current += malloc_usable_size(ptr);
+        if (h.current > h.peak) {
+            h.peak = h.current;
+        }
+        if (h.current > h.highest) {
+            h.highest = h.current;
+        }
+    }
+
+    static void trackFree(void* ptr) {
+        Heap& h = heap();
+        if (!ptr || h.paused) {
+            return;
+        }
+        h.frees++;
+        size_t size = malloc_usable_size(ptr);
+        h.current = size < h.current ? h.current - size : 0;
+    }
+};
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) noexcept {
+    void* ptr = __libc_malloc(size);
+    HeapCounter::trackAlloc(ptr);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    void* ptr = __libc_calloc(count, size);
+    HeapCounter::trackAlloc(ptr);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+    HeapCounter::trackFree(ptr);
+    void* moved = __libc_realloc(ptr, size);
+    HeapCounter::trackAlloc(moved);
+    return moved;
+}
+
+void free(void* ptr) noexcept {
+    HeapCounter::trackFree(ptr);
+    __libc_free(ptr);
+}
+}
+
+#endif // UNIT_TEST
+#endif // HEAP_COUNTER_H
@@ -0,0 +1,144 @@
+#ifndef MOCK_BME280_H
+#define MOCK_BME280_H
+
+#ifdef UNIT_TEST
+
+#include <stdint.h>
+#include <deque>
+#include "Wire.h"
+
+// BME280 register image on the mock I2C bus.
+//
+// Writes the chip ID, the calibration words and raw ADC values where the
+// chip keeps them, so that both Adafruit_BME280 and BME280Sensor read them
+// over Wire exactly as they would on the device.
+class MockBME280 {
+public:
+    static const uint8_t CHIP_ID = 0x60;
+    static const uint8_t REG_CALIB_TP = 0x88;
+    static const uint8_t REG_CALIB_H1 = 0xA1;
+    static const uint8_t REG_CHIP_ID = 0xD0;
+    static const uint8_t REG_CALIB_H2 = 0xE1;
+    static const uint8_t REG_CTRL_MEAS = 0xF4;
+    static const uint8_t REG_DATA = 0xF7;
+    static const uint8_t MODE_MASK = 0x03;
+    static const uint8_t MODE_FORCED = 0x01;
+
+    // Raw value reported for a skipped (disabled) measurement
+    static const int32_t SKIPPED_20BIT = 0x80000;
+    static const int32_t SKIPPED_16BIT = 0x8000;
+
+    struct Calibration {
+        uint16_t t1;
+        int16_t t2, t3;
+        uint16_t p1;
+        int16_t p2, p3, p4, p5, p6, p7, p8, p9;
+        uint8_t h1;
+        int16_t h2;
+        uint8_t h3;
+        int16_t h4, h5;  // 12-bit, packed across 0xE4..0xE6
+        int8_t h6;
+    };
+
+    // BMP280 datasheet worked example for temperature and pressure
+    // (adc_T 519888 -> 25.08 degC, adc_P 415148 -> 100653.27 Pa), plus
+    // humidity trimming values typical of production parts
+    static Calibration datasheet() {
+        Calibration c = {27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+                         75, 362, 0, 313, 50, 30};
+        return c;
+    }
+
+    static const int32_t DATASHEET_ADC_T = 519888;
+    static const int32_t DATASHEET_ADC_P = 415148;
+    static const int32_t TYPICAL_ADC_H = 30000;
+
+    explicit MockBME280(TwoWire& wire, uint8_t address = 0x77) : _wire(wire), _address(address) {}
+
+    void attach(const Calibration& calibration = datasheet()) {
+        uint8_t* r = _wire.attach(_address);
+        r[REG_CHIP_ID] = CHIP_ID;
+        setCalibration(calibration);
+        setRaw(DATASHEET_ADC_T, DATASHEET_ADC_P, TYPICAL_ADC_H);
+        _queue.clear();
+        _conversions = 0;
+        _wire.onWrite(_address, [this](uint8_t reg, uint8_t value) {
+            if (reg == REG_CTRL_MEAS && (value & MODE_MASK) == MODE_FORCED) {
+                convert();
+            }
+        });
+    }
+
+    void detach() { _wire.detach(_address); }
+
+    void setCalibration(const Calibration& c) {
+        uint8_t* r = _wire.registers(_address);
+        const uint16_t words[12] = {c.t1,
+                                    static_cast<uint16_t>(c.t2),
+                                    static_cast<uint16_t>(c.t3),
+                                    c.p1,
+                                    static_cast<uint16_t>(c.p2),
+                                    static_cast<uint16_t>(c.p3),
+                                    static_cast<uint16_t>(c.p4),
+                                    static_cast<uint16_t>(c.p5),
+                                    static_cast<uint16_t>(c.p6),
+                                    static_cast<uint16_t>(c.p7),
+                                    static_cast<uint16_t>(c.p8),
+                                    static_cast<uint16_t>(c.p9)};
+        for (int i = 0; i < 12; i++) {
+            r[REG_CALIB_TP + 2 * i] = words[i] & 0xFF;
+            r[REG_CALIB_TP + 2 * i + 1] = words[i] >> 8;
+        }
+        r[REG_CALIB_H1] = c.h1;
+        r[REG_CALIB_H2] = static_cast<uint16_t>(c.h2) & 0xFF;
+        r[REG_CALIB_H2 + 1] = static_cast<uint16_t>(c.h2) >> 8;
+        r[REG_CALIB_H2 + 2] = c.h3;
+        r[REG_CALIB_H2 + 3] = (static_cast<uint16_t>(c.h4) >> 4) & 0xFF;
+        r[REG_CALIB_H2 + 4] = (static_cast<uint16_t>(c.h4) & 0x0F) | ((static_cast<uint16_t>(c.h5) & 0x0F) << 4);
+        r[REG_CALIB_H2 + 5] = (static_cast<uint16_t>(c.h5) >> 4) & 0xFF;
+        r[REG_CALIB_H2 + 6] = static_cast<uint8_t>(c.h6);
+    }
+
+    // 20-bit temperature and pressure, 16-bit humidity
+    void setRaw(int32_t adcT, int32_t adcP, int32_t adcH) {
+        uint8_t* r = _wire.registers(_address);
+        r[REG_DATA + 0] = (adcP >> 12) & 0xFF;
+        r[REG_DATA + 1] = (adcP >> 4) & 0xFF;
+        r[REG_DATA + 2] = (adcP << 4) & 0xF0;
+        r[REG_DATA + 3] = (adcT >> 12) & 0xFF;
+        r[REG_DATA + 4] = (adcT >> 4) & 0xFF;
+        r[REG_DATA + 5] = (adcT << 4) & 0xF0;
+        r[REG_DATA + 6] = (adcH >> 8) & 0xFF;
+        r[REG_DATA + 7] = adcH & 0xFF;
+    }
+
+    // Raw values for the next forced conversions, one per conversion; once
+    // the queue is empty the data registers keep their last values
+    void queueRaw(int32_t adcT, int32_t adcP, int32_t adcH) { _queue.push_back(Raw{adcT, adcP, adcH}); }
+    size_t conversions() const { return _conversions; }
+    uint8_t ctrlMeas() { return _wire.registers(_address)[REG_CTRL_MEAS]; }
+    uint8_t ctrlHum() { return _wire.registers(_address)[0xF2]; }
+
+private:
+    struct Raw {
+        int32_t t, p, h;
+    };
+
+    TwoWire& _wire;
+    uint8_t _address;
+    std::deque<Raw> _queue;
+    size_t _conversions = 0;
+
+    // Forced mode: one conversion, then back to sleep
+    void convert() {
+        _conversions++;
+        if (!_queue.empty()) {
+            setRaw(_queue.front().t, _queue.front().p, _queue.front().h);
+            _queue.pop_front();
+        }
+        _wire.registers(_address)[REG_CTRL_MEAS] &= ~MODE_MASK;
+    }
+};
+
+#endif // UNIT_TEST
+#endif // MOCK_BME280_H
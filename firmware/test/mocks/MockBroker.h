@@ -0,0 +1,313 @@
+#ifndef MOCK_BROKER_H
+#define MOCK_BROKER_H
+
+#ifdef UNIT_TEST
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <initializer_list>
+
+// In-process MQTT 3.1.1 broker stand-in.
+//
+// When a broker is attached with MockBroker::attach(), every mock WiFiClient
+// (and therefore WiFiClientSecure) routes its socket calls to it: bytes written
+// by the client are parsed as MQTT packets and the broker queues responses that
+// the client reads back. Tests script the broker's behaviour and inspect what
+// it received.
+//
+// Without a tunnel, the mock SecureClient stands in for the TLS handshake with
+// a hello of two bytes, HELLO and the HELLO_* flags of the extensions it asks
+// for, which the broker answers with the handshake's mbedTLS error as a 16-bit
+// big-endian magnitude (0 = established) and the description of the fatal
+// alert it sent, if any.
+class MockBroker {
+public:
+    struct Message {
+        std::string topic;
+        std::string payload;
+        uint8_t qos;
+        bool retained;
+        bool dup;
+        uint16_t packetId;
+    };
+
+    // Optional transport layer between the socket and the MQTT parser, e.g. a
+    // TLS server endpoint for benchmarks. Wire bytes from the client go in,
+    // decrypted application data and wire bytes for the client come out.
+    class Tunnel {
+    public:
+        virtual ~Tunnel() {}
+        virtual void reset() = 0;
+        virtual void fromClient(const uint8_t* buf, size_t size, std::vector<uint8_t>& plain,
+                                std::deque<uint8_t>& wire) = 0;
+        virtual void toClient(const uint8_t* buf, size_t size, std::deque<uint8_t>& wire) = 0;
+    };
+
+    static const uint8_t HELLO = 0x16;
+    static const uint8_t HELLO_MAX_FRAGMENT_LENGTH = 0x01;
+    static const int ERR_FEATURE_UNAVAILABLE = -0x7080;  // MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE
+    static const int ERR_FATAL_ALERT = -0x7780;          // MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE
+
+    // Script
+    bool acceptConnections = true;   // TCP/TLS connect succeeds
+    uint8_t connackCode = 0;         // CONNACK return code (0 = accepted)
+    std::deque<uint8_t> connackScript;  // Return codes for the next CONNECTs, then connackCode
+    bool sessionPresent = false;     // CONNACK session-present flag
+    int dropConnectionAfterPublishes = -1;  // Close the socket after N publishes (-1 = never)
+    int dropPubacks = 0;             // Swallow the next N PUBACKs for QoS 1 publishes
+    std::deque<std::vector<uint8_t>> rawPubacks;  // Sent as they are instead of the next PUBACKs
+    bool refuseMaxFragmentLength = false;  // TLS handshake fails when the client asks for max_fragment_length
+    uint8_t rejectCertificate = 0;   // TLS handshake fails with this alert, e.g. 44 (certificate_revoked)
+    Tunnel* tunnel = nullptr;        // Terminate TLS (or another layer) before parsing
+
+    // Observations
+    int tcpConnects = 0;
+    int mqttConnects = 0;
+    int disconnects = 0;
+    int clientWrites = 0;            // Number of write() calls, i.e. TLS records on a real socket
+    size_t bytesReceived = 0;
+    std::string clientId;
+    std::string willTopic;
+    std::string willMessage;
+    bool willRetain = false;
+    bool cleanSession = true;
+    std::vector<Message> published;
+
+    static MockBroker*& active() {
+        static MockBroker* broker = nullptr;
+        return broker;
+    }
+
+    void attach() { active() = this; }
+    static void detach() { active() = nullptr; }
+
+    const Message* lastOn(const std::string& topic) const {
+        for (auto it = published.rbegin(); it != published.rend(); ++it) {
+            if (it->topic == topic) {
+                return &*it;
+            }
+        }
+        return nullptr;
+    }
+
+    int countOn(const std::string& topic) const {
+        int count = 0;
+        for (const auto& msg : published) {
+            if (msg.topic == topic) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // Transport side, called by the mock WiFiClient
+    int socketConnect() {
+        if (!acceptConnections) {
+            return 0;
+        }
+        tcpConnects++;
+        _open = true;
+        _handshaking = !tunnel;
+        _rx.clear();
+        _tx.clear();
+        if (tunnel) {
+            tunnel->reset();
+        }
+        return 1;
+    }
+
+    bool socketConnected() const { return _open || !_tx.empty(); }
+
+    void socketStop() {
+        _open = false;
+        _rx.clear();
+    }
+
+    size_t socketWrite(const uint8_t* buf, size_t size) {
+        if (!_open) {
+            return 0;
+        }
+        clientWrites++;
+        bytesReceived += size;
+        if (tunnel) {
+            tunnel->fromClient(buf, size, _rx, _tx);
+        } else {
+            _rx.insert(_rx.end(), buf, buf + size);
+        }
+        if (_handshaking && !hello()) {
+            return size;
+        }
+        parse();
+        return size;
+    }
+
+    int socketAvailable() const { return static_cast<int>(_tx.size()); }
+
+    int socketRead() {
+        if (_tx.empty()) {
+            return -1;
+        }
+        uint8_t byte = _tx.front();
+        _tx.pop_front();
+        return byte;
+    }
+
+    int socketRead(uint8_t* buf, size_t size) {
+        size_t n = 0;
+        while (n < size && !_tx.empty()) {
+            buf[n++] = _tx.front();
+            _tx.pop_front();
+        }
+        return n > 0 ? static_cast<int>(n) : -1;
+    }
+
+private:
+    bool _open = false;
+    bool _handshaking = false;
+    std::vector<uint8_t> _rx;
+    std::deque<uint8_t> _tx;
+
+    static std::string readString(const uint8_t* p, size_t& pos) {
+        size_t len = (p[pos] << 8) | p[pos + 1];
+        pos += 2;
+        std::string s(reinterpret_cast<const char*>(p + pos), len);
+        pos += len;
+        return s;
+    }
+
+    void send(const uint8_t* bytes, size_t size) {
+        if (tunnel) {
+            tunnel->toClient(bytes, size, _tx);
+        } else {
+            _tx.insert(_tx.end(), bytes, bytes + size);
+        }
+    }
+
+    void send(std::initializer_list<uint8_t> bytes) { send(bytes.begin(), bytes.size()); }
+    void send(const std::vector<uint8_t>& bytes) { send(bytes.data(), bytes.size()); }
+
+    // True once the handshake is over and MQTT bytes may follow
+    bool hello() {
+        if (_rx.size() < 2) {
+            return false;
+        }
+        uint8_t flags = _rx[0] == HELLO ? _rx[1] : 0;
+        _rx.erase(_rx.begin(), _rx.begin() + 2);
+        _handshaking = false;
+        int error = 0;
+        uint8_t alert = 0;
+        if (refuseMaxFragmentLength && (flags & HELLO_MAX_FRAGMENT_LENGTH)) {
+            error = ERR_FEATURE_UNAVAILABLE;
+        } else if (rejectCertificate) {
+            error = ERR_FATAL_ALERT;
+            alert = rejectCertificate;
+        }
+        send({static_cast<uint8_t>((-error) >> 8), static_cast<uint8_t>((-error) & 0xFF), alert});
+        if (error != 0) {
+            _open = false;
+        }
+        return error == 0;
+    }
+
+    void parse() {
+        while (true) {
+            // Decode fixed header and remaining length
+            if (_rx.size() < 2) {
+                return;
+            }
+            size_t remaining = 0;
+            size_t multiplier = 1;
+            size_t pos = 1;
+            uint8_t digit;
+            do {
+                if (pos >= _rx.size()) {
+                    return;
+                }
+                digit = _rx[pos++];
+                remaining += (digit & 0x7F) * multiplier;
+                multiplier <<= 7;
+            } while (digit & 0x80);
+            if (_rx.size() < pos + remaining) {
+                return;
+            }
+
+            std::vector<uint8_t> packet(_rx.begin(), _rx.begin() + pos + remaining);
+            _rx.erase(_rx.begin(), _rx.begin() + pos + remaining);
+            handle(packet[0], packet.data() + pos, remaining);
+        }
+    }
+
+    void handle(uint8_t header, const uint8_t* body, size_t len) {
+        switch (header & 0xF0) {
+        case 0x10: { // CONNECT
+            size_t pos = 0;
+            readString(body, pos);  // Protocol name
+            pos++;                  // Protocol level
+            uint8_t flags = body[pos++];
+            pos += 2;               // Keep alive
+            clientId = readString(body, pos);
+            cleanSession = (flags & 0x02) != 0;
+            if (flags & 0x04) {
+                willTopic = readString(body, pos);
+                willMessage = readString(body, pos);
+                willRetain = (flags & 0x20) != 0;
+            }
+            mqttConnects++;
+            uint8_t code = connackCode;
+            if (!connackScript.empty()) {
+                code = connackScript.front();
+                connackScript.pop_front();
+            }
+            send({0x20, 0x02, static_cast<uint8_t>(sessionPresent ? 1 : 0), code});
+            if (code != 0) {
+                _open = false;
+            }
+            break;
+        }
+        case 0x30: { // PUBLISH
+            size_t pos = 0;
+            Message msg;
+            msg.retained = (header & 0x01) != 0;
+            msg.qos = (header >> 1) & 0x03;
+            msg.dup = (header & 0x08) != 0;
+            msg.topic = readString(body, pos);
+            msg.packetId = 0;
+            if (msg.qos > 0) {
+                msg.packetId = (body[pos] << 8) | body[pos + 1];
+                pos += 2;
+            }
+            msg.payload.assign(reinterpret_cast<const char*>(body + pos), len - pos);
+            published.push_back(msg);
+            if (msg.qos > 0) {
+                if (dropPubacks > 0) {
+                    dropPubacks--;
+                } else if (!rawPubacks.empty()) {
+                    send(rawPubacks.front());
+                    rawPubacks.pop_front();
+                } else {
+                    send({0x40, 0x02, static_cast<uint8_t>(msg.packetId >> 8), static_cast<uint8_t>(msg.packetId & 0xFF)});
+                }
+            }
+            if (dropConnectionAfterPublishes > 0 && --dropConnectionAfterPublishes == 0) {
+                _open = false;
+            }
+            break;
+        }
+        case 0xC0: // PINGREQ
+            send({0xD0, 0x00});
+            break;
+        case 0xE0: // DISCONNECT
+            disconnects++;
+            _open = false;
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+#endif // UNIT_TEST
+#endif // MOCK_BROKER_H
@@ -0,0 +1,230 @@
+#ifndef MOCK_TLS_SERVER_H
+#define MOCK_TLS_SERVER_H
+
+#if defined(UNIT_TEST) && defined(NATIVE_TLS)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/pk.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/x509_crt.h>
+
+#include "Bench.h"
+#include "MockBroker.h"
+
+// TLS server endpoint for MockBroker, backed by host mbedTLS.
+//
+// Attach it as the broker's tunnel to make the in-process broker behave like
+// Mosquitto on port 8883: client certificates are required and verified
+// against the CA, the server picks an EC or RSA certificate to match the
+// negotiated suite, and sessions are cached for resumption. The CPU time spent
+// on the server side is accumulated, and its allocations are left out of the
+// Bench heap counts, so benchmarks can report the client's share alone.
+class MockTlsServer : public MockBroker::Tunnel {
+public:
+    static const size_t MAX_CERTIFICATES = 2;
+
+    MockTlsServer() : _certCount(0), _handshakeDone(false), _lastError(0), _cpuNanos(0) {
+        Bench::Pause pause;
+        mbedtls_ssl_init(&_ssl);
+        mbedtls_ssl_config_init(&_conf);
+        mbedtls_entropy_init(&_entropy);
+        mbedtls_ctr_drbg_init(&_drbg);
+        mbedtls_x509_crt_init(&_ca);
+        mbedtls_ssl_cache_init(&_cache);
+        for (size_t i = 0; i < MAX_CERTIFICATES; i++) {
+            mbedtls_x509_crt_init(&_certs[i]);
+            mbedtls_pk_init(&_keys[i]);
+        }
+        _outbox.reserve(32 * 1024);
+        _plain.reserve(4 * 1024);
+    }
+
+    ~MockTlsServer() {
+        Bench::Pause pause;
+        mbedtls_ssl_free(&_ssl);
+        mbedtls_ssl_config_free(&_conf);
+        for (size_t i = 0; i < MAX_CERTIFICATES; i++) {
+            mbedtls_x509_crt_free(&_certs[i]);
+            mbedtls_pk_free(&_keys[i]);
+        }
+        mbedtls_x509_crt_free(&_ca);
+        mbedtls_ssl_cache_free(&_cache);
+        mbedtls_ctr_drbg_free(&_drbg);
+        mbedtls_entropy_free(&_entropy);
+    }
+
+    bool addCertificate(const char* certPem, const char* keyPem) {
+        if (_certCount >= MAX_CERTIFICATES) {
+            return false;
+        }
+        Bench::Pause pause;
+        mbedtls_x509_crt* cert = &_certs[_certCount];
+        mbedtls_pk_context* key = &_keys[_certCount];
+        _lastError = mbedtls_x509_crt_parse(cert, (const unsigned char*)certPem, strlen(certPem) + 1);
+        if (_lastError == 0) {
+            _lastError = mbedtls_pk_parse_key(key, (const unsigned char*)keyPem, strlen(keyPem) + 1, NULL, 0);
+        }
+        if (_lastError != 0) {
+            return false;
+        }
+        _certCount++;
+        return true;
+    }
+
+    // Configure the server; client certificates must chain to caPem
+    bool begin(const char* caPem) {
+        static const char* personalization = "mock-tls-server";
+        Bench::Pause pause;
+        _lastError = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                                           (const unsigned char*)personalization, strlen(personalization));
+        if (_lastError == 0) {
+            _lastError = mbedtls_x509_crt_parse(&_ca, (const unsigned char*)caPem, strlen(caPem) + 1);
+        }
+        if (_lastError == 0) {
+            _lastError = mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                                     MBEDTLS_SSL_PRESET_DEFAULT);
+        }
+        if (_lastError != 0) {
+            return false;
+        }
+
+        mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+        mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+        mbedtls_ssl_conf_ca_chain(&_conf, &_ca, NULL);
+        mbedtls_ssl_conf_session_cache(&_conf, &_cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+        for (size_t i = 0; i < _certCount; i++) {
+            _lastError = mbedtls_ssl_conf_own_cert(&_conf, &_certs[i], &_keys[i]);
+            if (_lastError != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isHandshakeDone() const { return _handshakeDone; }
+    int getLastError() const { return _lastError; }
+    const char* getCiphersuite() const { return _handshakeDone ? mbedtls_ssl_get_ciphersuite(&_ssl) : nullptr; }
+
+    // Server CPU time since the last call
+    int64_t takeCpuNanos() {
+        int64_t nanos = _cpuNanos;
+        _cpuNanos = 0;
+        return nanos;
+    }
+
+    // Tunnel, called by MockBroker
+    void reset() override {
+        Bench::Pause pause;
+        mbedtls_ssl_free(&_ssl);
+        mbedtls_ssl_init(&_ssl);
+        _inbox.clear();
+        _handshakeDone = false;
+        _lastError = mbedtls_ssl_setup(&_ssl, &_conf);
+        mbedtls_ssl_set_bio(&_ssl, this, sendCallback, recvCallback, NULL);
+    }
+
+    void fromClient(const uint8_t* buf, size_t size, std::vector<uint8_t>& plain, std::deque<uint8_t>& wire) override {
+        int64_t start = Bench::cpuNanos();
+        {
+            Bench::Pause pause;
+            _inbox.insert(_inbox.end(), buf, buf + size);
+
+            if (!_handshakeDone) {
+                int ret = mbedtls_ssl_handshake(&_ssl);
+                if (ret == 0) {
+                    _handshakeDone = true;
+                } else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+                    _lastError = ret;
+                }
+            }
+
+            if (_handshakeDone) {
+                uint8_t chunk[256];
+                int n;
+                while ((n = mbedtls_ssl_read(&_ssl, chunk, sizeof(chunk))) > 0) {
+                    _plain.insert(_plain.end(), chunk, chunk + n);
+                }
+            }
+        }
+        _cpuNanos += Bench::cpuNanos() - start;
+
+        // Hand over outside the pause: the broker owns these buffers
+        plain.insert(plain.end(), _plain.begin(), _plain.end());
+        wire.insert(wire.end(), _outbox.begin(), _outbox.end());
+        _plain.clear();
+        _outbox.clear();
+    }
+
+    void toClient(const uint8_t* buf, size_t size, std::deque<uint8_t>& wire) override {
+        if (!_handshakeDone) {
+            return;
+        }
+        int64_t start = Bench::cpuNanos();
+        {
+            Bench::Pause pause;
+            size_t written = 0;
+            while (written < size) {
+                int ret = mbedtls_ssl_write(&_ssl, buf + written, size - written);
+                if (ret <= 0) {
+                    _lastError = ret;
+                    break;
+                }
+                written += ret;
+            }
+        }
+        _cpuNanos += Bench::cpuNanos() - start;
+
+        wire.insert(wire.end(), _outbox.begin(), _outbox.end());
+        _outbox.clear();
+    }
+
+private:
+    mbedtls_ssl_context _ssl;
+    mbedtls_ssl_config _conf;
+    mbedtls_entropy_context _entropy;
+    mbedtls_ctr_drbg_context _drbg;
+    mbedtls_x509_crt _ca;
+    mbedtls_ssl_cache_context _cache;
+    mbedtls_x509_crt _certs[MAX_CERTIFICATES];
+    mbedtls_pk_context _keys[MAX_CERTIFICATES];
+    size_t _certCount;
+    bool _handshakeDone;
+    int _lastError;
+    int64_t _cpuNanos;
+    std::deque<uint8_t> _inbox;
+    std::vector<uint8_t> _outbox;
+    std::vector<uint8_t> _plain;
+
+    static int sendCallback(void* ctx, const unsigned char* buf, size_t len) {
+        MockTlsServer* self = static_cast<MockTlsServer*>(ctx);
+        self->_outbox.insert(self->_outbox.end(), buf, buf + len);
+        return static_cast<int>(len);
+    }
+
+    static int recvCallback(void* ctx, unsigned char* buf, size_t len) {
+        MockTlsServer* self = static_cast<MockTlsServer*>(ctx);
+        if (self->_inbox.empty()) {
+            return MBEDTLS_ERR_SSL_WANT_READ;
+        }
+        size_t n = 0;
+        while (n < len && !self->_inbox.empty()) {
+            buf[n++] = self->_inbox.front();
+            self->_inbox.pop_front();
+        }
+        return static_cast<int>(n);
+    }
+
+    MockTlsServer(const MockTlsServer&);
+    MockTlsServer& operator=(const MockTlsServer&);
+};
+
+#endif // UNIT_TEST && NATIVE_TLS
+#endif // MOCK_TLS_SERVER_H
@@ -21,57 +21,98 @@ public:
     }
 
     size_t putString(const char* key, const char* value) {
+        _calls++;
         if (_readOnly) return 0;
         _storage[std::string(key)] = std::string(value);
         return strlen(value);
     }
 
+    // Like the ESP32: nothing is read when the value and its NUL do not fit,
+    // and the size returned includes the NUL
     size_t getString(const char* key, char* buffer, size_t maxLen) {
+        _calls++;
         auto it = _storage.find(std::string(key));
         if (it == _storage.end()) {
             buffer[0] = '\0';
             return 0;
         }
-        strncpy(buffer, it->second.c_str(), maxLen - 1);
-        buffer[maxLen - 1] = '\0';
-        return it->second.length();
+        if (it->second.length() + 1 > maxLen) {
+            return 0;
+        }
+        memcpy(buffer, it->second.c_str(), it->second.length() + 1);
+        return it->second.length() + 1;
     }
 
     size_t putULong(const char* key, unsigned long value) {
+        _calls++;
         if (_readOnly) return 0;
         _ulongs[std::string(key)] = value;
         return sizeof(unsigned long);
     }
 
     unsigned long getULong(const char* key, unsigned long defaultValue) {
+        _calls++;
         auto it = _ulongs.find(std::string(key));
         if (it == _ulongs.end()) return defaultValue;
         return it->second;
     }
 
     size_t putInt(const char* key, int value) {
+        _calls++;
         if (_readOnly) return 0;
         _ints[std::string(key)] = value;
         return sizeof(int);
     }
 
     int getInt(const char* key, int defaultValue) {
+        _calls++;
         auto it = _ints.find(std::string(key));
         if (it == _ints.end()) return defaultValue;
         return it->second;
     }
 
     bool isKey(const char* key) {
-        return _storage.find(std::string(key)) != _storage.end();
+        _calls++;
+        std::string name(key);
+        return _storage.count(name) || _bytes.count(name) || _ulongs.count(name) || _ints.count(name);
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        _calls++;
+        if (_readOnly || !value || len == 0) return 0;
+        _bytes[std::string(key)] = std::string(static_cast<const char*>(value), len);
+        return len;
+    }
+
+    // Like the ESP32 library: nothing is read when the blob exceeds maxLen
+    size_t getBytes(const char* key, void* buffer, size_t maxLen) {
+        _calls++;
+        auto it = _bytes.find(std::string(key));
+        if (it == _bytes.end() || it->second.length() > maxLen) return 0;
+        memcpy(buffer, it->second.data(), it->second.length());
+        return it->second.length();
+    }
+
+    bool remove(const char* key) {
+        _calls++;
+        if (_readOnly) return false;
+        std::string name(key);
+        return _storage.erase(name) + _bytes.erase(name) + _ulongs.erase(name) + _ints.erase(name) > 0;
     }
 
     bool clear() {
+        _calls++;
         _storage.clear();
+        _bytes.clear();
         _ulongs.clear();
         _ints.clear();
         return true;
     }
 
+    // NVS accesses (every get, put, isKey, remove and clear) since the last reset
+    size_t _mockCalls() const { return _calls; }
+    void _mockResetCalls() { _calls = 0; }
+
     // Helper for tests to inject data
     void _mockSetString(const char* key, const char* value) {
         _storage[std::string(key)] = std::string(value);
@@ -80,7 +121,9 @@ public:
 private:
     std::string _namespace;
     bool _readOnly = false;
+    size_t _calls = 0;
     std::map<std::string, std::string> _storage;
+    std::map<std::string, std::string> _bytes;
     std::map<std::string, unsigned long> _ulongs;
     std::map<std::string, int> _ints;
 };
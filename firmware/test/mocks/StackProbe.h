@@ -0,0 +1,68 @@
+#ifndef STACK_PROBE_H
+#define STACK_PROBE_H
+
+#ifdef UNIT_TEST
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Host-side stack high-water measurement.
+//
+// The region below the caller's frame is painted with a sentinel from a
+// throw-away frame, the function under test is called from the same depth,
+// and the deepest byte that no longer holds the sentinel gives its peak stack
+// usage. The call overhead of the probe itself is measured with an empty
+// function and subtracted.
+class StackProbe {
+public:
+    static const size_t REGION_SIZE = 32 * 1024;
+    static const uint8_t SENTINEL = 0xA5;
+
+    typedef void (*Function)(void* context);
+
+    static size_t measure(Function fn, void* context) {
+        size_t baseline = raw(&empty, nullptr);
+        size_t used = raw(fn, context);
+        return used > baseline ? used - baseline : 0;
+    }
+
+    template <typename Callable>
+    static size_t measure(Callable& callable) {
+        return measure(&invoke<Callable>, &callable);
+    }
+
+private:
+    template <typename Callable>
+    static void invoke(void* context) {
+        (*static_cast<Callable*>(context))();
+    }
+
+    static void empty(void* context) { (void)context; }
+
+    __attribute__((noinline)) static uintptr_t paint() {
+        volatile uint8_t region[REGION_SIZE];
+        for (size_t i = 0; i < REGION_SIZE; i++) {
+            region[i] = SENTINEL;
+        }
+        return reinterpret_cast<uintptr_t>(&region[0]);
+    }
+
+    __attribute__((noinline)) static void call(Function fn, void* context) { fn(context); }
+
+    __attribute__((noinline)) static size_t raw(Function fn, void* context) {
+        uintptr_t bottom = paint();
+        call(fn, context);
+
+        // The stack grows down: scan up from the bottom of the painted region
+        const volatile uint8_t* p = reinterpret_cast<const volatile uint8_t*>(bottom);
+        size_t untouched = 0;
+        while (untouched < REGION_SIZE && p[untouched] == SENTINEL) {
+            untouched++;
+        }
+        return REGION_SIZE - untouched;
+    }
+};
+
+#endif // UNIT_TEST
+#endif // STACK_PROBE_H
@@ -28,13 +28,12 @@ typedef enum {
 // Mock WiFi class
 class MockWiFiClass {
 public:
-    MockWiFiClass() : _status(WL_DISCONNECTED), _rssi(-70) {}
+    MockWiFiClass() : _status(WL_DISCONNECTED), _rssi(-70), _network(nullptr) {}
 
     // Connection management
     wl_status_t begin(const char* ssid, const char* password = nullptr) {
-        (void)ssid;
         (void)password;
-        _status = WL_CONNECTED;
+        _status = !_network || strcmp(ssid, _network) == 0 ? WL_CONNECTED : WL_NO_SSID_AVAIL;
         return _status;
     }
 
@@ -168,10 +167,16 @@ public:
         _rssi = rssi;
     }
 
+    // Only this SSID is in range (nullptr = any)
+    void setNetwork(const char* ssid) {
+        _network = ssid;
+    }
+
 private:
     wl_status_t _status;
     wifi_mode_t _mode;
     int32_t _rssi;
+    const char* _network;
 };
 
 extern MockWiFiClass WiFi;
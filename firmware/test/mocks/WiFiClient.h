@@ -4,40 +4,58 @@
 #ifdef UNIT_TEST
 
 #include "Client.h"
+#include "MockBroker.h"
 #include <stdint.h>
 
 // Mock WiFiClient class
+// Socket calls are routed to the attached MockBroker, if any
 class WiFiClient : public Client {
 public:
     WiFiClient() {}
 
     int connect(const char* host, uint16_t port) {
         (void)host; (void)port;
-        return 1;
+        MockBroker* broker = MockBroker::active();
+        return broker ? broker->socketConnect() : 1;
     }
     int connect(IPAddress ip, uint16_t port) {
         (void)ip; (void)port;
-        return 1;
+        MockBroker* broker = MockBroker::active();
+        return broker ? broker->socketConnect() : 1;
     }
 
-    size_t write(uint8_t byte) override { (void)byte; return 1; }
+    size_t write(uint8_t byte) override { return write(&byte, 1); }
     size_t write(const uint8_t* buf, size_t size) override {
-        (void)buf; (void)size;
-        return size;
+        MockBroker* broker = MockBroker::active();
+        return broker ? broker->socketWrite(buf, size) : size;
     }
 
-    int available() override { return 0; }
-    int read() override { return -1; }
+    int available() override {
+        MockBroker* broker = MockBroker::active();
+        return broker ? broker->socketAvailable() : 0;
+    }
+    int read() override {
+        MockBroker* broker = MockBroker::active();
+        return broker ? broker->socketRead() : -1;
+    }
     int read(uint8_t* buf, size_t size) {
-        (void)buf; (void)size;
-        return -1;
+        MockBroker* broker = MockBroker::active();
+        return broker ? broker->socketRead(buf, size) : -1;
     }
     int peek() override { return -1; }
     void flush() override {}
 
-    void stop() {}
-    uint8_t connected() { return 0; }
-    operator bool() { return false; }
+    void stop() {
+        MockBroker* broker = MockBroker::active();
+        if (broker) {
+            broker->socketStop();
+        }
+    }
+    uint8_t connected() {
+        MockBroker* broker = MockBroker::active();
+        return broker ? broker->socketConnected() : 0;
+    }
+    operator bool() { return connected(); }
 
     IPAddress remoteIP() { return IPAddress(0, 0, 0, 0); }
     uint16_t remotePort() { return 0; }
@@ -5,22 +5,182 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
+#include <functional>
+#include <map>
+#include <vector>
 
 // Mock TwoWire class for I2C communication
+// Attached devices are emulated as a 256-byte register file with the usual
+// auto-incrementing register pointer: a write sets the pointer (and stores
+// any further bytes), a read returns bytes from the pointer on. Transfers to
+// an address with no device attached are NACKed.
+//
+// The bus is instrumented: every transfer is counted in bytes on the wire
+// (address byte included) and in simulated bus time at the configured
+// clock, 9 SCL cycles per byte plus start and stop. A stuck bus (or the
+// next few transfers, with failNext) fails after the configured timeout.
 class TwoWire {
 public:
-    void begin() {}
-    void begin(int sda, int scl) { (void)sda; (void)scl; }
-    void beginTransmission(uint8_t address) { (void)address; }
-    uint8_t endTransmission() { return 0; }
-    uint8_t requestFrom(uint8_t address, size_t quantity) {
-        (void)address; (void)quantity;
+    static const uint8_t ERROR_NACK_ADDRESS = 2;
+    static const uint8_t ERROR_TIMEOUT = 5;
+
+    bool begin() { return true; }
+    bool begin(int sda, int scl) { (void)sda; (void)scl; return true; }
+    bool setClock(uint32_t frequency) {
+        _clock = frequency;
+        return true;
+    }
+    uint32_t getClock() const { return _clock; }
+    void setTimeOut(uint16_t timeOutMillis) { _timeout = timeOutMillis; }
+    uint16_t getTimeOut() const { return _timeout; }
+
+    void beginTransmission(uint8_t address) {
+        _address = address;
+        _tx.clear();
+    }
+    size_t write(uint8_t data) {
+        _tx.push_back(data);
+        return 1;
+    }
+    uint8_t endTransmission(bool sendStop = true) {
+        (void)sendStop;
+        if (stalls()) {
+            timeOut();
+            return ERROR_TIMEOUT;
+        }
+        Device* device = find(_address);
+        if (!device) {
+            transfer(0);
+            return ERROR_NACK_ADDRESS;
+        }
+        transfer(_tx.size());
+        for (size_t i = 0; i < _tx.size(); i++) {
+            if (i == 0) {
+                device->pointer = _tx[0];
+            } else {
+                uint8_t reg = device->pointer++;
+                device->registers[reg] = _tx[i];
+                if (device->onWrite) {
+                    device->onWrite(reg, _tx[i]);
+                }
+            }
+        }
         return 0;
     }
-    size_t write(uint8_t data) { (void)data; return 1; }
-    int read() { return -1; }
-    int available() { return 0; }
-    void setClock(uint32_t frequency) { (void)frequency; }
+
+    size_t requestFrom(uint16_t address, size_t quantity, bool sendStop = true) {
+        (void)sendStop;
+        _rx.clear();
+        _rxPos = 0;
+        if (stalls()) {
+            timeOut();
+            return 0;
+        }
+        Device* device = find(static_cast<uint8_t>(address));
+        if (!device) {
+            transfer(0);
+            return 0;
+        }
+        transfer(quantity);
+        for (size_t i = 0; i < quantity; i++) {
+            _rx.push_back(device->registers[device->pointer++]);
+        }
+        return quantity;
+    }
+    int read() { return _rxPos < _rx.size() ? _rx[_rxPos++] : -1; }
+    int available() { return static_cast<int>(_rx.size() - _rxPos); }
+
+    // Test control
+    uint8_t* attach(uint8_t address) {
+        Device& device = _devices[address];
+        memset(device.registers, 0, sizeof(device.registers));
+        device.pointer = 0;
+        device.onWrite = nullptr;
+        return device.registers;
+    }
+    void detach(uint8_t address) { _devices.erase(address); }
+    // Called after each register write, e.g. to emulate a conversion
+    void onWrite(uint8_t address, std::function<void(uint8_t reg, uint8_t value)> hook) {
+        Device* device = find(address);
+        if (device) {
+            device->onWrite = hook;
+        }
+    }
+    uint8_t* registers(uint8_t address) {
+        Device* device = find(address);
+        return device ? device->registers : nullptr;
+    }
+    void setStuck(bool stuck) { _stuck = stuck; }
+    void failNext(size_t transfers) { _failures = transfers; }
+
+    size_t transfers() const { return _transfers; }
+    size_t bytesTransferred() const { return _bytes; }
+    uint64_t busTimeMicros() const { return _busTimeNanos / 1000; }
+    void resetStats() {
+        _transfers = 0;
+        _bytes = 0;
+        _busTimeNanos = 0;
+    }
+
+    void reset() {
+        resetStats();
+        _clock = 100000;
+        _timeout = 50;
+        _stuck = false;
+        _failures = 0;
+        _devices.clear();
+        _tx.clear();
+        _rx.clear();
+        _rxPos = 0;
+    }
+
+private:
+    struct Device {
+        uint8_t registers[256];
+        uint8_t pointer;
+        std::function<void(uint8_t, uint8_t)> onWrite;
+    };
+
+    std::map<uint8_t, Device> _devices;
+    uint8_t _address = 0;
+    std::vector<uint8_t> _tx;
+    std::vector<uint8_t> _rx;
+    size_t _rxPos = 0;
+
+    uint32_t _clock = 100000;
+    uint16_t _timeout = 50;
+    bool _stuck = false;
+    size_t _failures = 0;
+    size_t _transfers = 0;
+    size_t _bytes = 0;
+    uint64_t _busTimeNanos = 0;
+
+    // Address byte plus payload, each 8 bits and an ACK, then start and stop
+    void transfer(size_t payload) {
+        size_t bytes = 1 + payload;
+        _transfers++;
+        _bytes += bytes;
+        _busTimeNanos += (static_cast<uint64_t>(bytes) * 9 + 2) * 1000000000ULL / _clock;
+    }
+
+    bool stalls() {
+        if (_failures > 0) {
+            _failures--;
+            return true;
+        }
+        return _stuck;
+    }
+
+    void timeOut() {
+        _transfers++;
+        _busTimeNanos += static_cast<uint64_t>(_timeout) * 1000000ULL;
+    }
+
+    Device* find(uint8_t address) {
+        std::map<uint8_t, Device>::iterator it = _devices.find(address);
+        return it == _devices.end() ? nullptr : &it->second;
+    }
 };
 
 extern TwoWire Wire;
@@ -36,11 +36,31 @@ typedef enum {
     ESP_PD_OPTION_AUTO
 } esp_sleep_pd_option_t;
 
+typedef enum {
+    ESP_GPIO_WAKEUP_GPIO_LOW = 0,
+    ESP_GPIO_WAKEUP_GPIO_HIGH = 1
+} esp_deepsleep_gpio_wake_up_mode_t;
+
+typedef int esp_err_t;
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+
 // Mock functions
 inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void) {
     return ESP_SLEEP_WAKEUP_UNDEFINED;
 }
 
+inline uint64_t esp_sleep_get_gpio_wakeup_status(void) {
+    return 0;
+}
+
+inline esp_err_t esp_deep_sleep_enable_gpio_wakeup(uint64_t gpio_pin_mask, esp_deepsleep_gpio_wake_up_mode_t mode) {
+    (void)gpio_pin_mask;
+    (void)mode;
+    return ESP_OK;
+}
+
 inline void esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
     (void)time_in_us;
 }
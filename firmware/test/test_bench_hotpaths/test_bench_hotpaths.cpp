@@ -0,0 +1,266 @@
+#include <string.h>
+#include <unity.h>
+
+#if !defined(NATIVE_BENCH) || !defined(NATIVE_MBEDTLS)
+#error "Hot path benchmarks need host mbedTLS: run them with pio test -e native_bench"
+#endif
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+#include "Bench.h"
+#include "MockBME280.h"
+#include "Preferences.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../fixtures/pki_fixtures.h"
+#include "../../lib/BME280Sensor/BME280Sensor.h"
+#include "../../lib/CertificateManager/include/ArduinoAdapter.h"
+#include "../../lib/CertificateManager/include/CertificateManager.h"
+#include "../../lib/CertificateManager/include/WiFiAdapter.h"
+#include "../../lib/EventLog/EventLog.h"
+#include "../../lib/MqttClient/JsonWriter.h"
+#include "../../lib/MqttClient/MqttClient.h"
+#include "../../lib/PulseCounter/PulseCounter.h"
+#include "../../lib/SensorHub/IntervalStats.h"
+
+// Include implementation files for linking
+#include "../../lib/BME280Sensor/AltitudeTable.cpp"
+#include "../../lib/BME280Sensor/BME280Compensation.cpp"
+#include "../../lib/BME280Sensor/BME280Sensor.cpp"
+#include "../../lib/CertificateManager/src/CertificateManager.cpp"
+#include "../../lib/CertificateManager/src/TlsCredentials.cpp"
+#include "../../lib/CertificateManager/src/X509Parser.cpp"
+#include "../../lib/Crc32/Crc32.cpp"
+#include "../../lib/EventLog/EventLog.cpp"
+#include "../../lib/MqttClient/JsonWriter.cpp"
+#include "../../lib/MqttClient/MqttClient.cpp"
+#include "../../lib/MqttClient/MqttSession.cpp"
+#include "../../lib/MqttClient/RetryPolicy.cpp"
+#include "../../lib/MqttClient/SecureClient.cpp"
+#include "../../lib/PulseCounter/PulseCounter.cpp"
+#include "../../lib/SensorHub/IntervalStats.cpp"
+#include "../../lib/SensorHub/Measurements.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+// Calls per timed batch, by cost of the call
+static const int CHEAP_CALLS = 10000;
+static const int PARSE_CALLS = 50;
+
+Preferences testPrefs;
+ArduinoAdapter arduinoAdapter;
+WiFiAdapter wifiAdapter;
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  testPrefs.clear();
+}
+
+void tearDown(void) {}
+
+// ========================================
+// Benchmarks - Payload
+// ========================================
+
+void test_bench_payload(void) {
+  WeatherData minimal = {{}, 0, 1700000000UL, 0, 0, 0, 0};
+  minimal.measurements.add(CHANNEL_TEMPERATURE, 2000);
+  minimal.measurements.add(CHANNEL_HUMIDITY, 50000);
+  minimal.measurements.add(CHANNEL_PRESSURE, 100000);
+  WeatherData full = {{}, -67, 1700000000UL, 2, 1700003600UL, 42, 3};
+  full.measurements = minimal.measurements;
+  full.measurements.add(CHANNEL_ALTITUDE, 12340);
+
+  Bench::run("payload.minimal", CHEAP_CALLS, [&]() {
+    CountingPrint counter;
+    MqttClient::writePayload(minimal, counter);
+    TEST_ASSERT_GREATER_THAN(0, counter.count());
+  });
+  Bench::run("payload.full", CHEAP_CALLS, [&]() {
+    CountingPrint counter;
+    MqttClient::writePayload(full, counter);
+    TEST_ASSERT_GREATER_THAN(0, counter.count());
+  });
+}
+
+// ========================================
+// Benchmarks - Certificates
+// ========================================
+
+void test_bench_pem_format_checks(void) {
+  Bench::run("pem.certificate", CHEAP_CALLS, []() {
+    const char *pem = Bench::opaque<const char *>(FIXTURE_DEVICE_RSA_CERT);
+    TEST_ASSERT_TRUE(CertificateManager::validateCertificateFormat(pem));
+  });
+  // RSA keys are matched against the last of the accepted BEGIN markers
+  Bench::run("pem.rsa_key", CHEAP_CALLS, []() {
+    const char *pem = Bench::opaque<const char *>(FIXTURE_DEVICE_RSA_KEY);
+    TEST_ASSERT_TRUE(CertificateManager::validatePrivateKeyFormat(pem));
+  });
+  Bench::run("pem.ec_key", CHEAP_CALLS, []() {
+    const char *pem = Bench::opaque<const char *>(FIXTURE_DEVICE_EC_KEY);
+    TEST_ASSERT_TRUE(CertificateManager::validatePrivateKeyFormat(pem));
+  });
+}
+
+// Reads into the manager's arena: no allocation ahead of the TLS handshake
+void test_bench_load_certificates(void) {
+  testPrefs.putString("cli_cert", FIXTURE_DEVICE_RSA_CERT);
+  testPrefs.putString("cli_key", FIXTURE_DEVICE_RSA_KEY);
+  testPrefs.putString("ca_cert", FIXTURE_CA_CERT);
+  CertificateManager certManager(testPrefs, &wifiAdapter, &arduinoAdapter);
+  // The first load moves the keys into the record every later boot reads
+  TEST_ASSERT_TRUE(certManager.loadFromNVS());
+
+  Bench::run("certificates.load", CHEAP_CALLS, [&]() { TEST_ASSERT_TRUE(certManager.loadFromNVS()); });
+}
+
+void test_bench_validate_certificates_per_device_key(void) {
+  struct {
+    const char *id;
+    const char *cert;
+    const char *key;
+  } keys[] = {{"certificates.validate.device_ec", FIXTURE_DEVICE_EC_CERT, FIXTURE_DEVICE_EC_KEY},
+              {"certificates.validate.device_rsa", FIXTURE_DEVICE_RSA_CERT, FIXTURE_DEVICE_RSA_KEY}};
+
+  for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+    testPrefs.clear();
+    testPrefs.putString("cli_cert", keys[i].cert);
+    testPrefs.putString("cli_key", keys[i].key);
+    CertificateManager certManager(testPrefs, &wifiAdapter, &arduinoAdapter);
+    TEST_ASSERT_TRUE(certManager.begin());
+
+    Bench::run(keys[i].id, PARSE_CALLS, [&]() { TEST_ASSERT_TRUE(certManager.validateCertificates()); });
+  }
+}
+
+// ========================================
+// Benchmarks - Sensor
+// ========================================
+
+void test_bench_bme280_compensation(void) {
+  MockBME280 chip(Wire);
+  chip.attach();
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+
+  // Float path: one bus transfer per getter, temperature repeated for t_fine
+  Bench::run("bme280.temperature", CHEAP_CALLS, [&]() { TEST_ASSERT_NOT_EQUAL(0, (int)sensor.getTemperature()); });
+  Bench::run("bme280.pressure", CHEAP_CALLS, [&]() { TEST_ASSERT_NOT_EQUAL(0, (int)sensor.getPressure()); });
+  Bench::run("bme280.humidity", CHEAP_CALLS, [&]() { TEST_ASSERT_NOT_EQUAL(0, (int)sensor.getHumidity()); });
+  Bench::run("bme280.altitude", CHEAP_CALLS, [&]() { TEST_ASSERT_NOT_EQUAL(0, (int)sensor.getAltitude()); });
+
+  // Fixed-point path: one burst for all three readings
+  Bench::run("bme280.read", CHEAP_CALLS, [&]() {
+    BME280Reading reading;
+    TEST_ASSERT_TRUE(sensor.read(reading));
+  });
+
+  // Forced-mode burst: five conversions, median and spread per channel
+  sensor.setBurst(5, BME280Sensor::BURST_MEDIAN);
+  Bench::run("bme280.collect_burst", CHEAP_CALLS / 10, [&]() {
+    Measurements m = {};
+    TEST_ASSERT_TRUE(sensor.collect(m));
+  });
+
+  uint8_t data[BME280Compensation::DATA_LENGTH];
+  memcpy(data, Wire.registers(BME280Sensor::DEFAULT_ADDRESS) + BME280Compensation::REG_DATA, sizeof(data));
+  BME280Compensation compensation(BME280Compensation::parseCalibration(
+      Wire.registers(BME280Sensor::DEFAULT_ADDRESS) + BME280Compensation::REG_CALIB_TP,
+      Wire.registers(BME280Sensor::DEFAULT_ADDRESS) + BME280Compensation::REG_CALIB_H));
+  Bench::run("bme280.compensate", CHEAP_CALLS, [&]() {
+    BME280Reading reading;
+    TEST_ASSERT_TRUE(compensation.compensate(Bench::opaque<const uint8_t *>(data), reading));
+  });
+  // Altitude from the pressure already read, against bme280.altitude above
+  Bench::run("bme280.altitude_table", CHEAP_CALLS,
+             [&]() { TEST_ASSERT_NOT_EQUAL(0, sensor.altitude(Bench::opaque<uint32_t>(100653))); });
+}
+
+void test_bench_interval_stats(void) {
+  Measurements sample = {};
+  sample.add(CHANNEL_TEMPERATURE, 2153);
+  sample.add(CHANNEL_HUMIDITY, 45100);
+  sample.add(CHANNEL_PRESSURE, 101325);
+  sample.add(CHANNEL_ALTITUDE, 12340);
+  IntervalStatsState state = {};
+  IntervalStats stats(state);
+
+  // One sensor-only wake's worth of accumulation
+  Bench::run("stats.add", CHEAP_CALLS, [&]() {
+    stats.add(*Bench::opaque<const Measurements *>(&sample));
+    if (stats.samples() == UINT16_MAX) {
+      stats.clear();
+    }
+  });
+  Bench::run("stats.summarize", CHEAP_CALLS, [&]() {
+    Measurements out = {};
+    TEST_ASSERT_TRUE(stats.summarize(out));
+  });
+}
+
+void test_bench_pulse_wake(void) {
+  PulseCounterState state = {};
+  PulseCounter pulses(state);
+  pulses.addInput(3, CHANNEL_RAIN_PULSES, LOW, 50);
+  pulses.addInput(4, CHANNEL_WIND_PULSES, LOW, 5);
+  uint64_t now = 0;
+
+  // Wake handler fast path: count, then arm for the next edge
+  Bench::run("pulses.on_wake", CHEAP_CALLS, [&]() {
+    uint64_t low, high;
+    now += 10000;
+    pulses.onWake(Bench::opaque<uint64_t>(1ULL << 4), 1ULL << 3, now);
+    pulses.arm(1ULL << 3, low, high);
+    TEST_ASSERT_NOT_EQUAL(0, low | high);
+  });
+}
+
+void test_bench_event_log(void) {
+  EventLogState state = {};
+  EventLog::begin(&state);
+
+  // One record with a string and two integers, the typical per-wake line
+  Bench::run("log.record", CHEAP_CALLS, [&]() {
+    LOG_INFO("Connecting to MQTT broker at %s:%d using mTLS...", Bench::opaque("broker.local"), 8883);
+    TEST_ASSERT_NOT_EQUAL(0, EventLog::size());
+  });
+  EventLog::begin(nullptr);
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Payload benchmarks
+  RUN_TEST(test_bench_payload);
+
+  // Certificate benchmarks
+  RUN_TEST(test_bench_pem_format_checks);
+  RUN_TEST(test_bench_load_certificates);
+  RUN_TEST(test_bench_validate_certificates_per_device_key);
+
+  // Sensor benchmarks
+  RUN_TEST(test_bench_bme280_compensation);
+  RUN_TEST(test_bench_interval_stats);
+  RUN_TEST(test_bench_pulse_wake);
+
+  // Logging benchmarks
+  RUN_TEST(test_bench_event_log);
+
+  return UNITY_END();
+}
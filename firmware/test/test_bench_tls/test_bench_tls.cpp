@@ -0,0 +1,324 @@
+#include <string.h>
+#include <unity.h>
+
+#ifndef NATIVE_TLS
+#error "TLS benchmarks need host mbedTLS: run them with pio test -e native_bench"
+#endif
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+#include "Bench.h"
+#include "MockBroker.h"
+#include "MockTlsServer.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../fixtures/pki_fixtures.h"
+#include "../../lib/CertificateManager/include/TlsCredentials.h"
+#include "../../lib/MqttClient/SecureClient.h"
+
+// Include implementation files for linking
+#include "../../lib/EventLog/EventLog.cpp"
+#include "../../lib/CertificateManager/src/TlsCredentials.cpp"
+#include "../../lib/MqttClient/SecureClient.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+#include <mbedtls/ssl_ciphersuites.h>
+
+// Handshakes per measurement; results are averaged
+static const int HANDSHAKES = 5;
+static const int PARSES = 20;
+
+MockBroker broker;
+MockTlsServer *server = nullptr;
+TlsCredentials ecCredentials;
+TlsCredentials rsaCredentials;
+
+// Client configuration; the defaults are what MqttClient::begin() applies
+struct Profile {
+  const TlsCredentials *credentials = &ecCredentials;
+  const int *ciphersuites = nullptr;
+  const uint16_t *curves = nullptr;
+  uint16_t maxFragmentLength = SecureClient::DEFAULT_MAX_FRAGMENT_LENGTH;
+  bool resume = false;
+};
+
+struct HandshakeResult {
+  bool ok;
+  int64_t clientNanos;
+  int64_t serverNanos;
+  size_t bytesSent;
+  size_t bytesReceived;
+  size_t allocations;
+  size_t heapPeak;
+  int resumed;
+  uint16_t recordLimit;
+  bool fragmentRefused;
+  const char *ciphersuite;
+};
+
+// Average of HANDSHAKES handshakes. With resume, a first unmeasured handshake
+// establishes the session that the measured ones resume, as on a reconnect
+// within a wake.
+HandshakeResult measureHandshake(const Profile &profile) {
+  HandshakeResult result = {true, 0, 0, 0, 0, 0, 0, 0, 0, false, nullptr};
+  SecureClient client;
+  client.setCredentials(profile.credentials);
+  client.setCiphersuites(profile.ciphersuites);
+  client.setCurves(profile.curves);
+  client.setMaxFragmentLength(profile.maxFragmentLength);
+  client.setSessionReuse(profile.resume);
+
+  if (profile.resume) {
+    result.ok = client.connect(FIXTURE_BROKER_HOST, 8883) == 1;
+    client.stop();
+  }
+
+  for (int i = 0; i < HANDSHAKES && result.ok; i++) {
+    size_t sentBefore = client.getBytesSent();
+    size_t receivedBefore = client.getBytesReceived();
+    size_t allocationsBefore = Bench::heap().allocations;
+    size_t heapBefore = Bench::heap().current;
+    Bench::resetPeak();
+    server->takeCpuNanos();
+
+    int64_t start = Bench::cpuNanos();
+    result.ok = client.connect(FIXTURE_BROKER_HOST, 8883) == 1;
+    int64_t total = Bench::cpuNanos() - start;
+    int64_t serverNanos = server->takeCpuNanos();
+
+    result.serverNanos += serverNanos;
+    result.clientNanos += total - serverNanos;
+    result.bytesSent += client.getBytesSent() - sentBefore;
+    result.bytesReceived += client.getBytesReceived() - receivedBefore;
+    result.allocations += Bench::heap().allocations - allocationsBefore;
+    if (Bench::heap().peak - heapBefore > result.heapPeak) {
+      result.heapPeak = Bench::heap().peak - heapBefore;
+    }
+    result.resumed += client.isResumed() ? 1 : 0;
+    result.ciphersuite = client.getCiphersuite();
+    result.recordLimit = client.getRecordLimit();
+    client.stop();
+  }
+
+  result.clientNanos /= HANDSHAKES;
+  result.serverNanos /= HANDSHAKES;
+  result.bytesSent /= HANDSHAKES;
+  result.bytesReceived /= HANDSHAKES;
+  result.allocations /= HANDSHAKES;
+  result.fragmentRefused = client.isMaxFragmentLengthRefused();
+  return result;
+}
+
+void reportHandshake(const char *name, const char *label, const HandshakeResult &result) {
+  Bench::report(name, "%s client_us=%lld server_us=%lld bytes_out=%zu bytes_in=%zu allocs=%zu heap_peak=%zu", label,
+                (long long)(result.clientNanos / 1000), (long long)(result.serverNanos / 1000), result.bytesSent,
+                result.bytesReceived, result.allocations, result.heapPeak);
+}
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  broker = MockBroker();
+  server = new MockTlsServer();
+  TEST_ASSERT_TRUE(server->addCertificate(FIXTURE_SERVER_EC_CERT, FIXTURE_SERVER_EC_KEY));
+  TEST_ASSERT_TRUE(server->addCertificate(FIXTURE_SERVER_RSA_CERT, FIXTURE_SERVER_RSA_KEY));
+  TEST_ASSERT_TRUE(server->begin(FIXTURE_CA_CERT));
+  broker.tunnel = server;
+  broker.attach();
+  TEST_ASSERT_TRUE(ecCredentials.load(FIXTURE_DEVICE_EC_CERT, FIXTURE_DEVICE_EC_KEY, FIXTURE_CA_CERT));
+  TEST_ASSERT_TRUE(rsaCredentials.load(FIXTURE_DEVICE_RSA_CERT, FIXTURE_DEVICE_RSA_KEY, FIXTURE_CA_CERT));
+}
+
+void tearDown(void) {
+  MockBroker::detach();
+  delete server;
+  server = nullptr;
+}
+
+// ========================================
+// Benchmarks - Cipher suites
+// ========================================
+
+void test_bench_handshake_per_ciphersuite(void) {
+  // The default allowlist, then the AES-256 suites it leaves out for comparison
+  static const int suites[] = {0xC02B, 0xCCA9, 0xC02F, 0xCCA8, 0xC02C, 0xC030};
+
+  for (size_t i = 0; i < sizeof(suites) / sizeof(suites[0]); i++) {
+    const int allowlist[] = {suites[i], 0};
+    const char *name = mbedtls_ssl_get_ciphersuite_name(suites[i]);
+    Profile profile;
+    profile.ciphersuites = allowlist;
+
+    HandshakeResult result = measureHandshake(profile);
+
+    TEST_ASSERT_TRUE_MESSAGE(result.ok, name);
+    TEST_ASSERT_EQUAL_STRING(name, result.ciphersuite);
+    char label[96];
+    snprintf(label, sizeof(label), "suite=%s", name);
+    reportHandshake("tls_handshake", label, result);
+  }
+}
+
+void test_bench_default_profile_prefers_ecdsa(void) {
+  HandshakeResult result = measureHandshake(Profile());
+
+  TEST_ASSERT_TRUE(result.ok);
+  TEST_ASSERT_EQUAL_STRING(mbedtls_ssl_get_ciphersuite_name(SecureClient::DEFAULT_CIPHERSUITES[0]),
+                           result.ciphersuite);
+  reportHandshake("tls_handshake", "suite=default", result);
+}
+
+// ========================================
+// Benchmarks - Key exchange curves
+// ========================================
+
+void test_bench_handshake_per_curve(void) {
+  static const int suite[] = {0xC02B, 0};
+  // The server certificate is on P-256, so it must stay in every list
+  static const uint16_t x25519[] = {SecureClient::TLS_GROUP_X25519, SecureClient::TLS_GROUP_SECP256R1, 0};
+  static const uint16_t p256[] = {SecureClient::TLS_GROUP_SECP256R1, 0};
+  static const uint16_t p384[] = {SecureClient::TLS_GROUP_SECP384R1, SecureClient::TLS_GROUP_SECP256R1, 0};
+  Profile profile;
+  profile.ciphersuites = suite;
+
+  profile.curves = x25519;
+  HandshakeResult result = measureHandshake(profile);
+  TEST_ASSERT_TRUE(result.ok);
+  reportHandshake("tls_curve", "curve=x25519", result);
+
+  profile.curves = p256;
+  result = measureHandshake(profile);
+  TEST_ASSERT_TRUE(result.ok);
+  reportHandshake("tls_curve", "curve=secp256r1", result);
+
+  profile.curves = p384;
+  result = measureHandshake(profile);
+  TEST_ASSERT_TRUE(result.ok);
+  reportHandshake("tls_curve", "curve=secp384r1", result);
+}
+
+// ========================================
+// Benchmarks - Record size
+// ========================================
+
+void test_bench_handshake_per_max_fragment_length(void) {
+  static const uint16_t lengths[] = {0, 512, 1024, 2048, 4096};
+
+  for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    Profile profile;
+    profile.maxFragmentLength = lengths[i];
+
+    HandshakeResult result = measureHandshake(profile);
+
+    // Refusal must fall back to a working handshake, never fail it
+    TEST_ASSERT_TRUE(result.ok);
+    char label[96];
+    snprintf(label, sizeof(label), "requested=%u record_limit=%u refused=%d", lengths[i], result.recordLimit,
+             result.fragmentRefused);
+    reportHandshake("tls_max_fragment", label, result);
+  }
+}
+
+// ========================================
+// Benchmarks - Device keys and resumption
+// ========================================
+
+void test_bench_full_vs_resumed_per_device_key(void) {
+  struct {
+    const char *key;
+    const TlsCredentials *credentials;
+  } keys[] = {{"ec", &ecCredentials}, {"rsa", &rsaCredentials}};
+
+  for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+    Profile profile;
+    profile.credentials = keys[i].credentials;
+
+    profile.resume = false;
+    HandshakeResult full = measureHandshake(profile);
+    TEST_ASSERT_TRUE(full.ok);
+    TEST_ASSERT_EQUAL(0, full.resumed);
+
+    profile.resume = true;
+    HandshakeResult resumed = measureHandshake(profile);
+    TEST_ASSERT_TRUE(resumed.ok);
+    TEST_ASSERT_EQUAL(HANDSHAKES, resumed.resumed);
+    // No certificates, key exchange or signatures: it must be cheaper
+    TEST_ASSERT_LESS_THAN(full.bytesReceived, resumed.bytesReceived);
+
+    char label[64];
+    snprintf(label, sizeof(label), "key=%s mode=full", keys[i].key);
+    reportHandshake("tls_resumption", label, full);
+    snprintf(label, sizeof(label), "key=%s mode=resumed", keys[i].key);
+    reportHandshake("tls_resumption", label, resumed);
+  }
+}
+
+// ========================================
+// Benchmarks - Credential parsing
+// ========================================
+
+// What parsing once per wake saves on every reconnect
+void test_bench_credentials_parse_per_device_key(void) {
+  struct {
+    const char *key;
+    const char *cert;
+    const char *privateKey;
+  } keys[] = {{"ec", FIXTURE_DEVICE_EC_CERT, FIXTURE_DEVICE_EC_KEY},
+              {"rsa", FIXTURE_DEVICE_RSA_CERT, FIXTURE_DEVICE_RSA_KEY}};
+
+  for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+    TlsCredentials credentials;
+    size_t allocationsBefore = Bench::heap().allocations;
+
+    int64_t start = Bench::cpuNanos();
+    for (int n = 0; n < PARSES; n++) {
+      TEST_ASSERT_TRUE(credentials.load(keys[i].cert, keys[i].privateKey, FIXTURE_CA_CERT));
+    }
+    int64_t nanos = (Bench::cpuNanos() - start) / PARSES;
+    size_t allocations = (Bench::heap().allocations - allocationsBefore) / PARSES;
+
+    size_t heapBefore = Bench::heap().current;
+    credentials.clear();
+    size_t retained = heapBefore - Bench::heap().current;
+
+    Bench::report("tls_credentials", "key=%s parse_us=%lld allocs=%zu retained=%zu", keys[i].key,
+                  (long long)(nanos / 1000), allocations, retained);
+  }
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Cipher suite benchmarks
+  RUN_TEST(test_bench_handshake_per_ciphersuite);
+  RUN_TEST(test_bench_default_profile_prefers_ecdsa);
+
+  // Curve benchmarks
+  RUN_TEST(test_bench_handshake_per_curve);
+
+  // Record size benchmarks
+  RUN_TEST(test_bench_handshake_per_max_fragment_length);
+
+  // Device key and resumption benchmarks
+  RUN_TEST(test_bench_full_vs_resumed_per_device_key);
+
+  // Credential parsing benchmarks
+  RUN_TEST(test_bench_credentials_parse_per_device_key);
+
+  return UNITY_END();
+}
@@ -0,0 +1,122 @@
+#include <string.h>
+#include <unity.h>
+
+#if !defined(NATIVE_BENCH) || !defined(NATIVE_MBEDTLS)
+#error "X.509 benchmarks need host mbedTLS: run them with pio test -e native_bench"
+#endif
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+#include "Bench.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../fixtures/pki_fixtures.h"
+#include "../../lib/CertificateManager/include/X509Parser.h"
+
+// Include implementation files for linking
+#include "../../lib/CertificateManager/src/X509Parser.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+// Calls per timed batch
+static const int CALLS = 50;
+
+struct Certificate {
+  const char *name;
+  const char *cert;
+  const char *key; // nullptr when the fixture has no key for it
+};
+
+static const Certificate CERTIFICATES[] = {
+    {"device_ec", FIXTURE_DEVICE_EC_CERT, FIXTURE_DEVICE_EC_KEY},
+    {"device_rsa", FIXTURE_DEVICE_RSA_CERT, FIXTURE_DEVICE_RSA_KEY},
+    {"ca_rsa4096", FIXTURE_CA_CERT, nullptr},
+};
+
+// Every X509Parser call parses the PEM from scratch, so the cost of one call
+// is mostly the cost of one certificate parse
+template <typename Callable> void measure(const Certificate &certificate, const char *op, Callable callable) {
+  char id[64];
+  snprintf(id, sizeof(id), "x509.%s.%s", certificate.name, op);
+  Bench::run(id, CALLS, callable);
+}
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// ========================================
+// Benchmarks
+// ========================================
+
+void test_bench_x509_extract_per_certificate(void) {
+  for (const Certificate &certificate : CERTIFICATES) {
+    measure(certificate, "extract_cn", [&]() {
+      char cn[64];
+      TEST_ASSERT_TRUE(X509Parser::extractCN(certificate.cert, cn, sizeof(cn)));
+    });
+    measure(certificate, "extract_expiration", [&]() {
+      unsigned long expiresAt;
+      TEST_ASSERT_TRUE(X509Parser::extractExpiration(certificate.cert, &expiresAt));
+    });
+    measure(certificate, "extract_serial", [&]() {
+      char serial[128];
+      TEST_ASSERT_TRUE(X509Parser::extractSerial(certificate.cert, serial, sizeof(serial)));
+    });
+  }
+}
+
+void test_bench_x509_validate_per_device_key(void) {
+  for (const Certificate &certificate : CERTIFICATES) {
+    if (!certificate.key) {
+      continue;
+    }
+    measure(certificate, "validate_key_pair",
+            [&]() { TEST_ASSERT_TRUE(X509Parser::validateKeyPair(certificate.cert, certificate.key)); });
+  }
+}
+
+// What CertificateManager::storeCertificates() does with a new certificate;
+// every boot repeats the last two
+void test_bench_x509_store_per_device_key(void) {
+  for (const Certificate &certificate : CERTIFICATES) {
+    if (!certificate.key) {
+      continue;
+    }
+    measure(certificate, "store", [&]() {
+      char cn[64];
+      unsigned long expiresAt;
+      TEST_ASSERT_TRUE(X509Parser::validateKeyPair(certificate.cert, certificate.key));
+      TEST_ASSERT_TRUE(X509Parser::extractCN(certificate.cert, cn, sizeof(cn)));
+      TEST_ASSERT_TRUE(X509Parser::extractExpiration(certificate.cert, &expiresAt));
+    });
+  }
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Extraction benchmarks
+  RUN_TEST(test_bench_x509_extract_per_certificate);
+
+  // Validation benchmarks
+  RUN_TEST(test_bench_x509_validate_per_device_key);
+  RUN_TEST(test_bench_x509_store_per_device_key);
+
+  return UNITY_END();
+}
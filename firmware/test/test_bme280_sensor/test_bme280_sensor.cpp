@@ -0,0 +1,455 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+#include "MockBME280.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../../lib/BME280Sensor/AltitudeTable.h"
+#include "../../lib/BME280Sensor/BME280Compensation.h"
+#include "../../lib/BME280Sensor/BME280Sensor.h"
+
+// Include implementation files for linking
+#include "../../lib/BME280Sensor/AltitudeTable.cpp"
+#include "../../lib/BME280Sensor/BME280Compensation.cpp"
+#include "../../lib/BME280Sensor/BME280Sensor.cpp"
+#include "../../lib/SensorHub/Measurements.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+MockBME280 chip(Wire);
+
+BME280Calibration datasheetCalibration() {
+  MockBME280::Calibration c = MockBME280::datasheet();
+  BME280Calibration calibration = {c.t1, c.t2, c.t3, c.p1, c.p2, c.p3, c.p4, c.p5, c.p6,
+                                   c.p7, c.p8, c.p9, c.h1, c.h2, c.h3, c.h4, c.h5, c.h6};
+  return calibration;
+}
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  Wire.reset();
+  chip.attach();
+}
+
+void tearDown(void) {}
+
+// ========================================
+// Test Cases - Compensation
+// ========================================
+
+void test_temperature_matches_datasheet_example(void) {
+  BME280Compensation compensation(datasheetCalibration());
+
+  TEST_ASSERT_EQUAL_INT32(2508, compensation.temperature(MockBME280::DATASHEET_ADC_T));
+  TEST_ASSERT_EQUAL_INT32(128422, compensation.tFine());
+}
+
+void test_pressure_matches_datasheet_example(void) {
+  BME280Compensation compensation(datasheetCalibration());
+  compensation.temperature(MockBME280::DATASHEET_ADC_T);
+
+  // 64-bit integer formula: 25767233 / 256 = 100653.25 Pa (floating point: 100653.27)
+  TEST_ASSERT_EQUAL_UINT32(25767233, compensation.pressureQ24_8(MockBME280::DATASHEET_ADC_P));
+}
+
+void test_pressure_without_p1_is_zero(void) {
+  BME280Calibration calibration = datasheetCalibration();
+  calibration.p1 = 0;
+  BME280Compensation compensation(calibration);
+  compensation.temperature(MockBME280::DATASHEET_ADC_T);
+
+  TEST_ASSERT_EQUAL_UINT32(0, compensation.pressureQ24_8(MockBME280::DATASHEET_ADC_P));
+}
+
+void test_humidity_is_clamped(void) {
+  BME280Compensation compensation(datasheetCalibration());
+  compensation.temperature(MockBME280::DATASHEET_ADC_T);
+
+  TEST_ASSERT_EQUAL_UINT32(0, compensation.humidityQ22_10(0));
+  TEST_ASSERT_EQUAL_UINT32(100 * 1024, compensation.humidityQ22_10(0xFFFF));
+}
+
+void test_parse_calibration_unpacks_registers(void) {
+  MockBME280::Calibration c = MockBME280::datasheet();
+  c.h4 = -1234; // Negative 12-bit values exercise the shared 0xE5 nibbles
+  c.h5 = -567;
+  c.h6 = -30;
+  chip.setCalibration(c);
+  const uint8_t *r = Wire.registers(0x77);
+
+  BME280Calibration parsed = BME280Compensation::parseCalibration(r + BME280Compensation::REG_CALIB_TP,
+                                                                  r + BME280Compensation::REG_CALIB_H);
+
+  TEST_ASSERT_EQUAL_UINT16(27504, parsed.t1);
+  TEST_ASSERT_EQUAL_INT16(-1000, parsed.t3);
+  TEST_ASSERT_EQUAL_UINT16(36477, parsed.p1);
+  TEST_ASSERT_EQUAL_INT16(-14600, parsed.p8);
+  TEST_ASSERT_EQUAL_INT16(6000, parsed.p9);
+  TEST_ASSERT_EQUAL_UINT8(75, parsed.h1);
+  TEST_ASSERT_EQUAL_INT16(362, parsed.h2);
+  TEST_ASSERT_EQUAL_INT16(-1234, parsed.h4);
+  TEST_ASSERT_EQUAL_INT16(-567, parsed.h5);
+  TEST_ASSERT_EQUAL_INT8(-30, parsed.h6);
+}
+
+// The Adafruit driver uses '/' where the datasheet shifts, which rounds
+// negative intermediates the other way, then converts to float. Temperature
+// and pressure may differ in the last digit; humidity, where the rounding
+// compounds below 15 degC, by a few Q22.10 steps (about 0.001 %RH each).
+void test_fixed_point_tracks_float_driver(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+
+  for (int32_t adcT = 400000; adcT <= 600000; adcT += 25000) {
+    for (int32_t adcP = 250000; adcP <= 450000; adcP += 50000) {
+      for (int32_t adcH = 20000; adcH <= 40000; adcH += 5000) {
+        chip.setRaw(adcT, adcP, adcH);
+        BME280Reading reading;
+        TEST_ASSERT_TRUE(sensor.read(reading));
+
+        TEST_ASSERT_INT32_WITHIN(1, lroundf(sensor.getTemperature() * 100), reading.temperature);
+        TEST_ASSERT_INT32_WITHIN(1, lroundf(sensor.getPressure() * 100), reading.pressure);
+        TEST_ASSERT_INT32_WITHIN(3, lroundf(sensor.getHumidity() * 1000), reading.humidity);
+      }
+    }
+  }
+}
+
+// ========================================
+// Test Cases - Sensor
+// ========================================
+
+void test_read_compensates_burst(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+
+  BME280Reading reading;
+  TEST_ASSERT_TRUE(sensor.read(reading));
+
+  TEST_ASSERT_EQUAL_INT32(2508, reading.temperature);
+  TEST_ASSERT_EQUAL_UINT32(100653, reading.pressure);
+  TEST_ASSERT_EQUAL_INT32(lroundf(sensor.getHumidity() * 1000), reading.humidity);
+}
+
+void test_begin_fails_without_sensor(void) {
+  chip.detach();
+  BME280Sensor sensor;
+
+  TEST_ASSERT_FALSE(sensor.begin());
+  TEST_ASSERT_FALSE(sensor.isAvailable());
+  TEST_ASSERT_NOT_NULL(strstr(sensor.getLastError(), "0x77"));
+}
+
+void test_read_fails_when_sensor_unavailable(void) {
+  BME280Sensor sensor;
+  BME280Reading reading;
+
+  TEST_ASSERT_FALSE(sensor.read(reading));
+  TEST_ASSERT_EQUAL_STRING("Sensor not available", sensor.getLastError());
+}
+
+void test_read_fails_on_bus_error(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+  chip.detach();
+
+  BME280Reading reading;
+  TEST_ASSERT_FALSE(sensor.read(reading));
+  TEST_ASSERT_EQUAL_STRING("I2C read failed", sensor.getLastError());
+}
+
+void test_read_fails_on_skipped_measurement(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+  chip.setRaw(MockBME280::DATASHEET_ADC_T, MockBME280::DATASHEET_ADC_P, MockBME280::SKIPPED_16BIT);
+
+  BME280Reading reading;
+  TEST_ASSERT_FALSE(sensor.read(reading));
+  TEST_ASSERT_EQUAL_STRING("Measurement skipped", sensor.getLastError());
+}
+
+void test_altitude_at_sea_level_is_zero(void) {
+  BME280Sensor sensor;
+
+  TEST_ASSERT_EQUAL_INT32(0, sensor.altitude(101325));
+  TEST_ASSERT_INT32_WITHIN(20, 11092, sensor.altitude(100000));
+}
+
+// ========================================
+// Test Cases - Bus
+// ========================================
+
+void test_begin_applies_bus_timing(void) {
+  BME280Sensor sensor;
+  sensor.setBus(400000, 10, 2);
+
+  TEST_ASSERT_TRUE(sensor.begin());
+  TEST_ASSERT_EQUAL_UINT32(400000, Wire.getClock());
+  TEST_ASSERT_EQUAL_UINT16(10, Wire.getTimeOut());
+}
+
+void test_read_is_one_burst(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+  BME280Reading reading;
+
+  // Register pointer write (address + 0xF7), then address + 8 data bytes
+  Wire.resetStats();
+  TEST_ASSERT_TRUE(sensor.read(reading));
+  TEST_ASSERT_EQUAL(2, Wire.transfers());
+  TEST_ASSERT_EQUAL(11, Wire.bytesTransferred());
+  size_t burstBytes = Wire.bytesTransferred();
+
+  Wire.resetStats();
+  sensor.getTemperature();
+  sensor.getPressure();
+  sensor.getHumidity();
+  TEST_ASSERT_GREATER_THAN(burstBytes * 2, Wire.bytesTransferred());
+}
+
+void test_fast_mode_shortens_bus_time(void) {
+  BME280Sensor sensor;
+  BME280Reading reading;
+
+  sensor.setBus(100000, 50, 0);
+  TEST_ASSERT_TRUE(sensor.begin());
+  Wire.resetStats();
+  TEST_ASSERT_TRUE(sensor.read(reading));
+  TEST_ASSERT_EQUAL_UINT64(1030, Wire.busTimeMicros()); // 103 SCL cycles
+
+  sensor.setBus(400000, 50, 0);
+  TEST_ASSERT_TRUE(sensor.begin());
+  Wire.resetStats();
+  TEST_ASSERT_TRUE(sensor.read(reading));
+  TEST_ASSERT_EQUAL_UINT64(257, Wire.busTimeMicros());
+}
+
+void test_read_retries_failed_transfer(void) {
+  BME280Sensor sensor;
+  sensor.setBus(400000, 10, 2);
+  TEST_ASSERT_TRUE(sensor.begin());
+  BME280Reading reading;
+
+  Wire.failNext(2);
+  TEST_ASSERT_TRUE(sensor.read(reading));
+  TEST_ASSERT_EQUAL_INT32(2508, reading.temperature);
+}
+
+void test_stuck_bus_fails_after_retries(void) {
+  BME280Sensor sensor;
+  sensor.setBus(400000, 10, 2);
+  TEST_ASSERT_TRUE(sensor.begin());
+  BME280Reading reading;
+
+  Wire.setStuck(true);
+  Wire.resetStats();
+  TEST_ASSERT_FALSE(sensor.read(reading));
+  TEST_ASSERT_EQUAL_STRING("I2C read failed", sensor.getLastError());
+  TEST_ASSERT_EQUAL(3, Wire.transfers());
+  TEST_ASSERT_EQUAL_UINT64(30000, Wire.busTimeMicros());
+}
+
+// ========================================
+// Test Cases - Forced Mode
+// ========================================
+
+int32_t temperatureFor(int32_t adcT) {
+  BME280Compensation compensation(datasheetCalibration());
+  return compensation.temperature(adcT);
+}
+
+void test_trigger_starts_forced_conversion(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+
+  // Temperature x2, pressure x16, humidity x1: 1.25 + 4.6 + 37.375 + 2.875 ms
+  TEST_ASSERT_EQUAL_UINT32(47, sensor.trigger());
+  TEST_ASSERT_EQUAL(1, chip.conversions());
+  TEST_ASSERT_EQUAL_HEX8(0x01, chip.ctrlHum());
+  TEST_ASSERT_EQUAL_HEX8(0x54, chip.ctrlMeas()); // osrs_t 2, osrs_p 5, back to sleep
+}
+
+void test_oversampling_sets_conversion_time(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+
+  sensor.setOversampling(1, 1, 1);
+  TEST_ASSERT_EQUAL_UINT32(10, sensor.conversionTimeMs());
+  sensor.setOversampling(16, 16, 16);
+  TEST_ASSERT_EQUAL_UINT32(113, sensor.conversionTimeMs());
+
+  // Unsupported factors round down: 3 -> 2, 0 -> 1, 200 -> 16
+  sensor.setOversampling(3, 0, 200);
+  TEST_ASSERT_EQUAL_UINT32(47, sensor.trigger());
+  TEST_ASSERT_EQUAL_HEX8(0x05, chip.ctrlHum());
+  TEST_ASSERT_EQUAL_HEX8(0x44, chip.ctrlMeas());
+}
+
+void test_collect_without_trigger_converts_once(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+  Measurements m = {};
+
+  TEST_ASSERT_TRUE(sensor.collect(m));
+  TEST_ASSERT_EQUAL(1, chip.conversions());
+  TEST_ASSERT_EQUAL_UINT32(47, _mock_millis);
+
+  int32_t value;
+  TEST_ASSERT_TRUE(m.get(CHANNEL_TEMPERATURE, value));
+  TEST_ASSERT_EQUAL_INT32(2508, value);
+  TEST_ASSERT_FALSE(m.get(CHANNEL_TEMPERATURE, value, STAT_SPREAD));
+}
+
+void test_burst_median_rejects_outlier(void) {
+  const int32_t adcT = MockBME280::DATASHEET_ADC_T;
+  const int32_t adcP = MockBME280::DATASHEET_ADC_P;
+  BME280Sensor sensor;
+  sensor.setBurst(5, BME280Sensor::BURST_MEDIAN);
+  TEST_ASSERT_TRUE(sensor.begin());
+  chip.queueRaw(adcT + 160, adcP, 30000);
+  chip.queueRaw(adcT, adcP, 30100);
+  chip.queueRaw(adcT + 9000, adcP, 39000); // Outlier
+  chip.queueRaw(adcT - 160, adcP, 29900);
+  chip.queueRaw(adcT, adcP, 30000);
+
+  // First conversion overlaps other sensors, the rest run in collect()
+  TEST_ASSERT_EQUAL_UINT32(47, sensor.trigger());
+  delay(47);
+  Measurements m = {};
+  TEST_ASSERT_TRUE(sensor.collect(m));
+  TEST_ASSERT_EQUAL(5, chip.conversions());
+  TEST_ASSERT_EQUAL_UINT32(5 * 47, _mock_millis);
+
+  int32_t value;
+  TEST_ASSERT_TRUE(m.get(CHANNEL_TEMPERATURE, value));
+  TEST_ASSERT_EQUAL_INT32(2508, value);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_TEMPERATURE, value, STAT_SPREAD));
+  TEST_ASSERT_EQUAL_INT32(temperatureFor(adcT + 9000) - temperatureFor(adcT - 160), value);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_HUMIDITY, value, STAT_SPREAD));
+  TEST_ASSERT_GREATER_THAN(0, value);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_PRESSURE, value, STAT_SPREAD));
+  TEST_ASSERT_TRUE(m.get(CHANNEL_ALTITUDE, value));
+  TEST_ASSERT_FALSE(m.get(CHANNEL_ALTITUDE, value, STAT_SPREAD));
+}
+
+void test_burst_trimmed_mean_drops_extremes(void) {
+  const int32_t adcT = MockBME280::DATASHEET_ADC_T;
+  const int32_t adcP = MockBME280::DATASHEET_ADC_P;
+  BME280Sensor sensor;
+  sensor.setBurst(4, BME280Sensor::BURST_TRIMMED_MEAN);
+  TEST_ASSERT_TRUE(sensor.begin());
+  chip.queueRaw(adcT - 5000, adcP, 30000);
+  chip.queueRaw(adcT + 80, adcP, 30000);
+  chip.queueRaw(adcT + 5000, adcP, 30000);
+  chip.queueRaw(adcT + 240, adcP, 30000);
+
+  Measurements m = {};
+  TEST_ASSERT_TRUE(sensor.collect(m));
+
+  int32_t value;
+  TEST_ASSERT_TRUE(m.get(CHANNEL_TEMPERATURE, value));
+  TEST_ASSERT_INT32_WITHIN(1, (temperatureFor(adcT + 80) + temperatureFor(adcT + 240)) / 2, value);
+}
+
+void test_burst_is_clamped(void) {
+  BME280Sensor sensor;
+
+  sensor.setBurst(0, BME280Sensor::BURST_MEDIAN);
+  TEST_ASSERT_EQUAL_UINT8(1, sensor.getBurst());
+  sensor.setBurst(50, BME280Sensor::BURST_MEDIAN);
+  TEST_ASSERT_EQUAL_UINT8(BME280Sensor::MAX_BURST, sensor.getBurst());
+}
+
+void test_failed_trigger_is_reported(void) {
+  BME280Sensor sensor;
+  TEST_ASSERT_TRUE(sensor.begin());
+  chip.detach();
+
+  TEST_ASSERT_EQUAL_UINT32(0, sensor.trigger());
+  TEST_ASSERT_EQUAL_STRING("I2C write failed", sensor.getLastError());
+  Measurements m = {};
+  TEST_ASSERT_FALSE(sensor.collect(m));
+}
+
+// ========================================
+// Test Cases - Altitude Table
+// ========================================
+
+void test_altitude_table_tracks_formula(void) {
+  const uint32_t seaLevels[] = {95000, 101325, 104000};
+  for (size_t s = 0; s < sizeof(seaLevels) / sizeof(seaLevels[0]); s++) {
+    uint32_t p0 = seaLevels[s];
+    for (uint32_t p = p0 / 2; p <= p0 * 11 / 10; p += 37) {
+      double expected = 4433000.0 * (1.0 - pow(static_cast<double>(p) / p0, 0.1903));
+      TEST_ASSERT_INT32_WITHIN(20, lround(expected), AltitudeTable::centimetres(p, p0));
+    }
+  }
+}
+
+void test_altitude_table_clamps_out_of_range(void) {
+  // Table ends: p / p0 = 0.5 and 0.5 + 77 / 128
+  TEST_ASSERT_EQUAL_INT32(AltitudeTable::centimetres(50000, 100000), AltitudeTable::centimetres(30000, 100000));
+  TEST_ASSERT_EQUAL_INT32(AltitudeTable::centimetres(141000, 128000), AltitudeTable::centimetres(150000, 128000));
+  TEST_ASSERT_EQUAL_INT32(0, AltitudeTable::centimetres(101325, 0));
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Compensation tests
+  RUN_TEST(test_temperature_matches_datasheet_example);
+  RUN_TEST(test_pressure_matches_datasheet_example);
+  RUN_TEST(test_pressure_without_p1_is_zero);
+  RUN_TEST(test_humidity_is_clamped);
+  RUN_TEST(test_parse_calibration_unpacks_registers);
+  RUN_TEST(test_fixed_point_tracks_float_driver);
+
+  // Sensor tests
+  RUN_TEST(test_read_compensates_burst);
+  RUN_TEST(test_begin_fails_without_sensor);
+  RUN_TEST(test_read_fails_when_sensor_unavailable);
+  RUN_TEST(test_read_fails_on_bus_error);
+  RUN_TEST(test_read_fails_on_skipped_measurement);
+  RUN_TEST(test_altitude_at_sea_level_is_zero);
+
+  // Bus tests
+  RUN_TEST(test_begin_applies_bus_timing);
+  RUN_TEST(test_read_is_one_burst);
+  RUN_TEST(test_fast_mode_shortens_bus_time);
+  RUN_TEST(test_read_retries_failed_transfer);
+  RUN_TEST(test_stuck_bus_fails_after_retries);
+
+  // Forced mode tests
+  RUN_TEST(test_trigger_starts_forced_conversion);
+  RUN_TEST(test_oversampling_sets_conversion_time);
+  RUN_TEST(test_collect_without_trigger_converts_once);
+  RUN_TEST(test_burst_median_rejects_outlier);
+  RUN_TEST(test_burst_trimmed_mean_drops_extremes);
+  RUN_TEST(test_burst_is_clamped);
+  RUN_TEST(test_failed_trigger_is_reported);
+
+  // Altitude table tests
+  RUN_TEST(test_altitude_table_tracks_formula);
+  RUN_TEST(test_altitude_table_clamps_out_of_range);
+
+  return UNITY_END();
+}
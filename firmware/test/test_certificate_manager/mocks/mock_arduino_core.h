@@ -20,19 +20,21 @@ public:
         _millis += ms;
     }
 
-    void log(const char* message) override {
+    void log(uint8_t level, const char* message) override {
         if (message) {
             logMessages.push_back(std::string(message));
+            logLevels.push_back(level);
         }
     }
 
-    void logf(const char* format, ...) override {
+    void logf(uint8_t level, const char* format, ...) override {
         va_list args;
         va_start(args, format);
         char buffer[512];
         vsnprintf(buffer, sizeof(buffer), format, args);
         va_end(args);
         logMessages.push_back(std::string(buffer));
+        logLevels.push_back(level);
     }
 
     void restart() override {
@@ -50,6 +52,7 @@ public:
 
     void clearLogs() {
         logMessages.clear();
+        logLevels.clear();
     }
 
     bool hasLogContaining(const char* substring) const {
@@ -61,15 +64,27 @@ public:
         return false;
     }
 
+    // Level of the first message containing substring (0 = none)
+    uint8_t levelOfLogContaining(const char* substring) const {
+        for (size_t i = 0; i < logMessages.size(); i++) {
+            if (logMessages[i].find(substring) != std::string::npos) {
+                return logLevels[i];
+            }
+        }
+        return 0;
+    }
+
     void reset() {
         _millis = 0;
         restartCalled = false;
         logMessages.clear();
+        logLevels.clear();
     }
 
     unsigned long _millis;
     bool restartCalled;
     std::vector<std::string> logMessages;
+    std::vector<uint8_t> logLevels;
 };
 
 #endif // MOCK_ARDUINO_CORE_H
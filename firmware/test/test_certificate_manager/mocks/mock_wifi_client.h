@@ -6,7 +6,9 @@
 
 class MockWiFiClient : public IWiFiClient {
 public:
-    MockWiFiClient() : caCertSet(false), certificateSet(false), privateKeySet(false) {
+    MockWiFiClient()
+        : caCertSet(false), certificateSet(false), privateKeySet(false), credentialsSupported(false),
+          credentials(nullptr) {
         caCert[0] = '\0';
         certificate[0] = '\0';
         privateKey[0] = '\0';
@@ -36,10 +38,16 @@ public:
         }
     }
 
+    bool supportsCredentials() const override { return credentialsSupported; }
+
+    void setCredentials(const TlsCredentials& creds) override { credentials = &creds; }
+
     // Test helpers
     bool caCertSet;
     bool certificateSet;
     bool privateKeySet;
+    bool credentialsSupported;
+    const TlsCredentials* credentials;
     char caCert[2048];
     char certificate[2048];
     char privateKey[2048];
@@ -48,6 +56,7 @@ public:
         caCertSet = false;
         certificateSet = false;
         privateKeySet = false;
+        credentials = nullptr;
         caCert[0] = '\0';
         certificate[0] = '\0';
         privateKey[0] = '\0';
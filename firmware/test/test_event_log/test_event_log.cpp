@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <unity.h>
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../../lib/EventLog/EventLog.h"
+
+// Include implementation files for linking
+#include "../../lib/EventLog/EventLog.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+// Print sink that captures everything written to it
+class CapturePrint : public Print {
+public:
+  size_t write(uint8_t byte) override {
+    bytes += static_cast<char>(byte);
+    return 1;
+  }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    bytes.append(reinterpret_cast<const char *>(buffer), size);
+    return size;
+  }
+  std::string bytes;
+};
+
+EventLogState state;
+
+// Boot marker: boot count and boot time
+static const size_t BOOT_RECORD = EventLog::RECORD_HEADER + 8;
+
+uint32_t read32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+         static_cast<uint32_t>(p[3]) << 24;
+}
+
+// Records held after the boot marker, as dumped
+std::string records() {
+  CapturePrint out;
+  EventLog::dump(out);
+  return out.bytes.substr(8 + BOOT_RECORD);
+}
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  memset(&state, 0, sizeof(state));
+  EventLog::begin(&state, 250);
+}
+
+void tearDown(void) { EventLog::begin(nullptr); }
+
+// ========================================
+// Test Cases - Records
+// ========================================
+
+void test_hash_is_fnv1a(void) {
+  TEST_ASSERT_EQUAL_HEX32(0x811C9DC5, EventLog::hash(""));
+  TEST_ASSERT_EQUAL_HEX32(0xE40C292C, EventLog::hash("a"));
+  TEST_ASSERT_EQUAL_HEX32(0xBF9CF968, EventLog::hash("foobar"));
+}
+
+void test_begin_records_boot_marker(void) {
+  const uint8_t *r = state.ring;
+
+  TEST_ASSERT_EQUAL_HEX32(EventLog::MAGIC, state.magic);
+  TEST_ASSERT_EQUAL_UINT8(BOOT_RECORD, r[0]);
+  TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL_INFO, r[1]);
+  TEST_ASSERT_EQUAL_HEX32(EventLog::ID_BOOT, read32(r + 2));
+  TEST_ASSERT_EQUAL_UINT32(1, read32(r + 10));
+  TEST_ASSERT_EQUAL_UINT32(250, read32(r + 14));
+}
+
+void test_record_stores_id_time_and_arguments(void) {
+  _mock_millis = 1234;
+  LOG_WARN("Retry attempt %d/%d", -1, 3);
+
+  std::string r = records();
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(r.data());
+  TEST_ASSERT_EQUAL(EventLog::RECORD_HEADER + 8, r.size());
+  TEST_ASSERT_EQUAL_UINT8(r.size(), p[0]);
+  TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL_WARN, p[1]);
+  TEST_ASSERT_EQUAL_HEX32(EventLog::hash("Retry attempt %d/%d"), read32(p + 2));
+  TEST_ASSERT_EQUAL_UINT32(1234, read32(p + 6));
+  TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, read32(p + 10));
+  TEST_ASSERT_EQUAL_UINT32(3, read32(p + 14));
+}
+
+void test_arguments_are_encoded_by_type(void) {
+  const char *ssid = "home";
+  LOG_INFO("%s %f %llu", ssid, 1.5, 0x100000002ULL);
+
+  std::string r = records();
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(r.data()) + EventLog::RECORD_HEADER;
+  TEST_ASSERT_EQUAL_UINT8(4, p[0]);
+  TEST_ASSERT_EQUAL_STRING_LEN("home", reinterpret_cast<const char *>(p + 1), 4);
+  float value;
+  uint32_t bits = read32(p + 5);
+  memcpy(&value, &bits, sizeof(value));
+  TEST_ASSERT_EQUAL_FLOAT(1.5f, value);
+  TEST_ASSERT_EQUAL_UINT32(2, read32(p + 9));
+  TEST_ASSERT_EQUAL_UINT32(1, read32(p + 13));
+  TEST_ASSERT_EQUAL(EventLog::RECORD_HEADER + 17, r.size());
+}
+
+void test_long_strings_are_truncated(void) {
+  std::string name(100, 'x');
+  LOG_INFO("%s", name.c_str());
+  EventLog::text(LOG_LEVEL_INFO, name.c_str());
+
+  std::string r = records();
+  size_t first = EventLog::RECORD_HEADER + 1 + EventLog::MAX_STRING;
+  TEST_ASSERT_EQUAL_UINT8(EventLog::MAX_STRING, r[EventLog::RECORD_HEADER]);
+  TEST_ASSERT_EQUAL_HEX32(EventLog::ID_TEXT, read32(reinterpret_cast<const uint8_t *>(r.data()) + first + 2));
+  TEST_ASSERT_EQUAL_UINT8(100, r[first + EventLog::RECORD_HEADER]);
+}
+
+void test_level_above_log_level_is_compiled_out(void) {
+  uint16_t used = EventLog::size();
+
+  LOG_DEBUG("Preparing for deep sleep...");
+
+  TEST_ASSERT_EQUAL_UINT16(used, EventLog::size());
+}
+
+void test_records_are_discarded_before_begin(void) {
+  EventLog::begin(nullptr);
+
+  LOG_ERROR("%s: FAILED (%s)", "Sensors", "timeout");
+  EventLog::text(LOG_LEVEL_ERROR, "lost");
+
+  TEST_ASSERT_EQUAL_UINT16(0, EventLog::size());
+  TEST_ASSERT_FALSE(EventLog::holds(LOG_LEVEL_ERROR));
+}
+
+// ========================================
+// Test Cases - Ring
+// ========================================
+
+void test_full_ring_evicts_oldest_records(void) {
+  for (uint32_t i = 0; i < 200; i++) {
+    LOG_INFO("Sample %u/%u stored", i, 200u);
+  }
+
+  // 18-byte records: the newest 56 fit in 1024 bytes
+  TEST_ASSERT_EQUAL_UINT16(56 * 18, EventLog::size());
+  TEST_ASSERT_EQUAL_UINT16(200 - 56 + 1, EventLog::dropped());
+
+  CapturePrint out;
+  EventLog::dump(out);
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(out.bytes.data()) + 8;
+  TEST_ASSERT_EQUAL_UINT32(200 - 56, read32(p + EventLog::RECORD_HEADER));
+  TEST_ASSERT_EQUAL_UINT32(199, read32(p + 55 * 18 + EventLog::RECORD_HEADER));
+}
+
+void test_oversized_record_is_dropped(void) {
+  uint16_t used = EventLog::size();
+  std::string part(EventLog::MAX_STRING, 'x');
+
+  LOG_INFO("%s%s%s%s%s%s", part.c_str(), part.c_str(), part.c_str(), part.c_str(), part.c_str(), part.c_str());
+
+  TEST_ASSERT_EQUAL_UINT16(used, EventLog::size());
+  TEST_ASSERT_EQUAL_UINT16(1, EventLog::dropped());
+}
+
+void test_dump_writes_header_and_records(void) {
+  LOG_INFO("Battery: %u mV", 3700u);
+  CapturePrint out;
+
+  size_t written = EventLog::dump(out);
+
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(out.bytes.data());
+  TEST_ASSERT_EQUAL(EventLog::dumpSize(), written);
+  TEST_ASSERT_EQUAL(written, out.bytes.size());
+  TEST_ASSERT_EQUAL_STRING_LEN("TLG1", out.bytes.c_str(), 4);
+  TEST_ASSERT_EQUAL_UINT16(EventLog::size(), p[4] | p[5] << 8);
+  TEST_ASSERT_EQUAL_UINT16(0, p[6] | p[7] << 8);
+}
+
+void test_worst_level_decides_upload(void) {
+  TEST_ASSERT_FALSE(EventLog::holds(LOG_LEVEL_WARN));
+
+  LOG_WARN("Connection lost, attempting to reconnect...");
+  TEST_ASSERT_TRUE(EventLog::holds(LOG_LEVEL_WARN));
+  TEST_ASSERT_FALSE(EventLog::holds(LOG_LEVEL_ERROR));
+  TEST_ASSERT_FALSE(EventLog::holds(LOG_LEVEL_NONE));
+
+  LOG_INFO("Published to topic: %s", "weather/station-01");
+  TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL_WARN, EventLog::worst());
+}
+
+void test_clear_keeps_boot_count(void) {
+  LOG_ERROR("%s: FAILED (%s)", "Sensors", "timeout");
+
+  EventLog::clear();
+
+  TEST_ASSERT_EQUAL_UINT16(0, EventLog::size());
+  TEST_ASSERT_FALSE(EventLog::holds(LOG_LEVEL_ERROR));
+  EventLog::begin(&state);
+  TEST_ASSERT_EQUAL_UINT32(2, read32(state.ring + 10));
+}
+
+void test_dump_decodes_with_decode_log(void) {
+  LOG_INFO("Connected to %s in %u ms", "station-net", 1234u);
+  LOG_WARN("Clock drift: %ld s", -42L);
+  LOG_INFO("Battery: %.1f V", 3.7f);
+  LOG_INFO("temperature: %s%ld.%0*ld", "-", 3L, 2, 5L);
+  LOG_INFO("Uptime: %llu us", 12345678901ULL);
+  LOG_INFO("Buffer at %12p", reinterpret_cast<void *>(0x3FC80000));
+  const char *expected[] = {
+      "INFO  Connected to station-net in 1234 ms",
+      "WARN  Clock drift: -42 s",
+      "INFO  Battery: 3.7 V",
+      "INFO  temperature: -3.05",
+      "INFO  Uptime: 12345678901 us",
+      "INFO  Buffer at   0x3fc80000",
+  };
+
+  // Decode with the format strings of this file, as from the firmware sources
+  char path[] = "/tmp/event_log_XXXXXX";
+  int fd = mkstemp(path);
+  TEST_ASSERT_TRUE(fd >= 0);
+  CapturePrint out;
+  EventLog::dump(out);
+  TEST_ASSERT_EQUAL(out.bytes.size(), write(fd, out.bytes.data(), out.bytes.size()));
+  close(fd);
+
+  std::string dir = __FILE__;
+  dir = dir.substr(0, dir.rfind('/'));
+  std::string command = "python3 " + dir + "/../../scripts/decode_log.py " + path + " --source " + dir + " 2>&1";
+  FILE *pipe = popen(command.c_str(), "r");
+  TEST_ASSERT_NOT_NULL(pipe);
+  std::string text;
+  char buffer[256];
+  while (fgets(buffer, sizeof(buffer), pipe)) {
+    text += buffer;
+  }
+  int status = pclose(pipe);
+  unlink(path);
+  if (WEXITSTATUS(status) == 127) {
+    TEST_IGNORE_MESSAGE("python3 not found");
+  }
+  TEST_ASSERT_EQUAL_MESSAGE(0, status, text.c_str());
+
+  // One line per record, the boot marker first
+  size_t line = text.find('\n');
+  for (const char *record : expected) {
+    size_t end = text.find('\n', line + 1);
+    TEST_ASSERT_TRUE_MESSAGE(end != std::string::npos, text.c_str());
+    std::string decoded = text.substr(line + 1, end - line - 1);
+    TEST_ASSERT_TRUE_MESSAGE(decoded.size() >= strlen(record), decoded.c_str());
+    TEST_ASSERT_EQUAL_STRING(record, decoded.c_str() + decoded.size() - strlen(record));
+    line = end;
+  }
+  TEST_ASSERT_EQUAL(text.size() - 1, line);
+}
+
+void test_invalid_state_is_reset(void) {
+  state.magic = 0xDEADBEEF;
+  state.used = 500;
+
+  EventLog::begin(&state);
+
+  TEST_ASSERT_EQUAL_HEX32(EventLog::MAGIC, state.magic);
+  TEST_ASSERT_EQUAL_UINT16(BOOT_RECORD, state.used);
+  TEST_ASSERT_EQUAL_UINT16(1, state.boot);
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Record tests
+  RUN_TEST(test_hash_is_fnv1a);
+  RUN_TEST(test_begin_records_boot_marker);
+  RUN_TEST(test_record_stores_id_time_and_arguments);
+  RUN_TEST(test_arguments_are_encoded_by_type);
+  RUN_TEST(test_long_strings_are_truncated);
+  RUN_TEST(test_level_above_log_level_is_compiled_out);
+  RUN_TEST(test_records_are_discarded_before_begin);
+
+  // Ring tests
+  RUN_TEST(test_full_ring_evicts_oldest_records);
+  RUN_TEST(test_oversized_record_is_dropped);
+  RUN_TEST(test_dump_writes_header_and_records);
+  RUN_TEST(test_worst_level_decides_upload);
+  RUN_TEST(test_clear_keeps_boot_count);
+  RUN_TEST(test_dump_decodes_with_decode_log);
+  RUN_TEST(test_invalid_state_is_reset);
+
+  return UNITY_END();
+}
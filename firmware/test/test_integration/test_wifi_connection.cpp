@@ -4,6 +4,7 @@
  * This test runs on actual ESP32 hardware and verifies:
  * - WiFi connection works
  * - NVS storage/retrieval works
+ * - NVS read time of the certificate record against the per-field keys
  * - Real hardware APIs function correctly
  *
  * To run: pio test -e esp32 -f test_integration
@@ -81,6 +82,51 @@ void test_nvs_can_store_and_retrieve(void) {
   prefs.end();
 }
 
+// Reads what CertificateManager loads at boot, laid out as before (a key per
+// field) and as now (one blob), with PEMs of a typical RSA station's sizes
+void test_nvs_certificate_record_read_time(void) {
+  Serial.println("\n=== Testing NVS Certificate Read Time ===");
+
+  static char cert[1300], key[1700], ca[1300];
+  static char blob[sizeof(cert) + sizeof(key) + sizeof(ca) + 96];
+  memset(cert, 'C', sizeof(cert) - 1);
+  memset(key, 'K', sizeof(key) - 1);
+  memset(ca, 'A', sizeof(ca) - 1);
+  memset(blob, 'B', sizeof(blob));
+  cert[sizeof(cert) - 1] = key[sizeof(key) - 1] = ca[sizeof(ca) - 1] = '\0';
+
+  TEST_ASSERT_TRUE(prefs.begin("test_nvs_certs", false));
+  prefs.putString("cli_cert", cert);
+  prefs.putString("cli_key", key);
+  prefs.putString("ca_cert", ca);
+  prefs.putString("cert_cn", "station-01");
+  prefs.putULong("cert_expires", 1767225600UL);
+  prefs.putInt("cert_version", 1);
+  TEST_ASSERT_EQUAL(sizeof(blob), prefs.putBytes("cert_record", blob, sizeof(blob)));
+
+  char cn[64];
+  unsigned long start = micros();
+  bool found = prefs.isKey("cli_cert") && prefs.isKey("cli_key") && prefs.isKey("ca_cert");
+  size_t keysRead = prefs.getString("cli_cert", cert, sizeof(cert)) + prefs.getString("cli_key", key, sizeof(key)) +
+                    prefs.getString("ca_cert", ca, sizeof(ca)) + prefs.getString("cert_cn", cn, sizeof(cn));
+  prefs.getULong("cert_expires", 0);
+  prefs.getInt("cert_version", 0);
+  unsigned long keysUs = micros() - start;
+
+  start = micros();
+  size_t blobRead = prefs.getBytes("cert_record", blob, sizeof(blob));
+  unsigned long blobUs = micros() - start;
+
+  Serial.printf("BENCH nvs.certificates keys_us=%lu blob_us=%lu\n", keysUs, blobUs);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL(sizeof(cert) + sizeof(key) + sizeof(ca) - 3 + strlen("station-01"), keysRead);
+  TEST_ASSERT_EQUAL(sizeof(blob), blobRead);
+
+  // Clean up
+  prefs.clear();
+  prefs.end();
+}
+
 void test_wifi_rssi_reading(void) {
   Serial.println("\n=== Testing WiFi RSSI ===");
 
@@ -125,6 +171,7 @@ void setup() {
 
   RUN_TEST(test_free_heap_sufficient);
   RUN_TEST(test_nvs_can_store_and_retrieve);
+  RUN_TEST(test_nvs_certificate_record_read_time);
   RUN_TEST(test_wifi_can_connect);
   RUN_TEST(test_wifi_rssi_reading);
 
@@ -0,0 +1,200 @@
+#include <string.h>
+#include <unity.h>
+
+// Free heap comes from the host allocator's counters
+#ifndef COUNT_ALLOCATIONS
+#define COUNT_ALLOCATIONS
+#endif
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+
+// Mock loop task stack: bytes never used
+UBaseType_t stackHighWaterMark = 4096;
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  (void)task;
+  return stackHighWaterMark;
+}
+#endif
+
+#include "../../lib/MemoryMonitor/MemoryMonitor.h"
+
+// Include implementation files for linking
+#include "../../lib/EventLog/EventLog.cpp"
+#include "../../lib/MemoryMonitor/MemoryMonitor.cpp"
+#include "../../lib/SensorHub/Measurements.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+EventLogState logState;
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  stackHighWaterMark = 4096;
+  memset(&logState, 0, sizeof(logState));
+  EventLog::begin(&logState);
+}
+
+void tearDown(void) { EventLog::begin(nullptr); }
+
+// ========================================
+// Test Cases - Sampling
+// ========================================
+
+void test_sample_reads_heap_and_stack(void) {
+  MemorySample sample = MemoryMonitor::sample();
+
+  TEST_ASSERT_EQUAL_UINT32(ESP.getFreeHeap(), sample.freeHeap);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(sample.freeHeap, sample.minFreeHeap);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(sample.freeHeap, sample.largestBlock);
+  TEST_ASSERT_EQUAL_UINT32(4096, sample.stackFree);
+}
+
+void test_allocations_are_counted(void) {
+  HeapCounter::Heap before = HeapCounter::heap();
+  uint32_t freeBefore = ESP.getFreeHeap();
+
+  void *buffer = malloc(8192);
+  TEST_ASSERT_NOT_NULL(buffer);
+  TEST_ASSERT_EQUAL(before.allocations + 1, HeapCounter::heap().allocations);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(freeBefore - 8192, ESP.getFreeHeap());
+  uint32_t minFree = ESP.getMinFreeHeap();
+  free(buffer);
+
+  TEST_ASSERT_EQUAL(before.frees + 1, HeapCounter::heap().frees);
+  TEST_ASSERT_EQUAL_UINT32(freeBefore, ESP.getFreeHeap());
+  // The low-water mark remembers the allocation
+  TEST_ASSERT_EQUAL_UINT32(minFree, ESP.getMinFreeHeap());
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(freeBefore - 8192, ESP.getMinFreeHeap());
+}
+
+// ========================================
+// Test Cases - Phases
+// ========================================
+
+void test_mark_keeps_lowest_of_each_field(void) {
+  MemoryMonitor memory;
+
+  memory.mark("sensors");
+  void *buffer = malloc(4096);
+  stackHighWaterMark = 3000;
+  memory.mark("tls");
+  uint32_t heapDuringTls = memory.lowest().freeHeap;
+  free(buffer);
+  stackHighWaterMark = 2500;
+  const MemorySample &last = memory.mark("publish");
+
+  TEST_ASSERT_EQUAL_UINT8(3, memory.getPhaseCount());
+  TEST_ASSERT_EQUAL_UINT32(2500, last.stackFree);
+  TEST_ASSERT_EQUAL_UINT32(2500, memory.lowest().stackFree);
+  TEST_ASSERT_GREATER_THAN_UINT32(heapDuringTls, last.freeHeap);
+  TEST_ASSERT_EQUAL_UINT32(heapDuringTls, memory.lowest().freeHeap);
+  TEST_ASSERT_EQUAL_UINT32(heapDuringTls, memory.lowest().largestBlock);
+}
+
+void test_mark_below_limit_logs_warning(void) {
+  MemoryMonitor memory;
+  memory.setWarnings(1024, 0);
+
+  memory.mark("sensors");
+  TEST_ASSERT_FALSE(EventLog::holds(LOG_LEVEL_WARN));
+
+  stackHighWaterMark = 900;
+  memory.mark("publish");
+  TEST_ASSERT_TRUE(EventLog::holds(LOG_LEVEL_WARN));
+}
+
+void test_fragmented_heap_logs_warning(void) {
+  MemoryMonitor memory;
+  memory.setWarnings(0, HeapCounter::HEAP_SIZE + 1);
+
+  memory.mark("tls");
+
+  TEST_ASSERT_TRUE(EventLog::holds(LOG_LEVEL_WARN));
+}
+
+void test_no_limits_never_warn(void) {
+  MemoryMonitor memory;
+  stackHighWaterMark = 0;
+
+  memory.mark("publish");
+
+  TEST_ASSERT_FALSE(EventLog::holds(LOG_LEVEL_WARN));
+}
+
+// ========================================
+// Test Cases - Report
+// ========================================
+
+void test_report_adds_lowest_values(void) {
+  MemoryMonitor memory;
+  Measurements m = {};
+  stackHighWaterMark = 1800;
+  memory.mark("tls");
+
+  TEST_ASSERT_TRUE(memory.report(m));
+
+  int32_t value;
+  TEST_ASSERT_EQUAL_UINT8(3, m.count);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_HEAP_MIN, value));
+  TEST_ASSERT_EQUAL_INT32(memory.lowest().minFreeHeap, value);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_HEAP_BLOCK, value));
+  TEST_ASSERT_EQUAL_INT32(memory.lowest().largestBlock, value);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_STACK_FREE, value));
+  TEST_ASSERT_EQUAL_INT32(1800, value);
+  TEST_ASSERT_EQUAL_STRING("stack_free", Measurements::info(CHANNEL_STACK_FREE)->key);
+}
+
+void test_report_without_marks_adds_nothing(void) {
+  MemoryMonitor memory;
+  Measurements m = {};
+
+  TEST_ASSERT_FALSE(memory.report(m));
+  TEST_ASSERT_EQUAL_UINT8(0, m.count);
+}
+
+void test_report_into_full_reading_fails(void) {
+  MemoryMonitor memory;
+  Measurements m = {};
+  m.count = Measurements::MAX_MEASUREMENTS - 1;
+  memory.mark("tls");
+
+  TEST_ASSERT_FALSE(memory.report(m));
+  TEST_ASSERT_EQUAL_UINT8(Measurements::MAX_MEASUREMENTS, m.count);
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Sampling tests
+  RUN_TEST(test_sample_reads_heap_and_stack);
+  RUN_TEST(test_allocations_are_counted);
+
+  // Phase tests
+  RUN_TEST(test_mark_keeps_lowest_of_each_field);
+  RUN_TEST(test_mark_below_limit_logs_warning);
+  RUN_TEST(test_fragmented_heap_logs_warning);
+  RUN_TEST(test_no_limits_never_warn);
+
+  // Report tests
+  RUN_TEST(test_report_adds_lowest_values);
+  RUN_TEST(test_report_without_marks_adds_nothing);
+  RUN_TEST(test_report_into_full_reading_fails);
+
+  return UNITY_END();
+}
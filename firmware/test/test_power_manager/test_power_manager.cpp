@@ -0,0 +1,209 @@
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+
+// Mock ADC: readings in mV at the pin, repeated from the start once used up
+std::vector<uint32_t> adcReadings;
+size_t adcReads = 0;
+uint8_t adcPin = 0xFF;
+uint32_t analogReadMilliVolts(uint8_t pin) {
+  adcPin = pin;
+  return adcReadings.empty() ? 0 : adcReadings[adcReads++ % adcReadings.size()];
+}
+#endif
+
+#include "../../lib/PowerManager/PowerManager.h"
+
+// Include implementation files for linking
+#include "../../lib/EventLog/EventLog.cpp"
+#include "../../lib/PowerManager/PowerManager.cpp"
+#include "../../lib/PulseCounter/PulseCounter.cpp"
+#include "../../lib/SensorHub/Measurements.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+static const int8_t BATTERY_PIN = 2;
+
+// Li-ion cell through a 1:1 divider
+EnergyPolicy liIonPolicy() {
+  EnergyPolicy policy = {3600, 4, 3500, 3450, 3300};
+  return policy;
+}
+
+// Manager with the battery reading mv (1:1 divider, no offset)
+void readAt(PowerManager &power, uint16_t mv) {
+  adcReadings = {static_cast<uint32_t>(mv / 2)};
+  power.setBattery(BATTERY_PIN, 2000, 0);
+  power.setEnergyPolicy(liIonPolicy());
+  power.readBattery();
+}
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  adcReadings.clear();
+  adcReads = 0;
+  adcPin = 0xFF;
+}
+
+void tearDown(void) {}
+
+// ========================================
+// Test Cases - Battery
+// ========================================
+
+void test_battery_without_pin_is_not_read(void) {
+  PowerManager power(3600);
+
+  TEST_ASSERT_EQUAL_UINT16(0, power.readBattery());
+  TEST_ASSERT_EQUAL(0, adcReads);
+}
+
+void test_battery_averages_samples(void) {
+  PowerManager power(3600);
+  adcReadings = {1990, 2010, 1995, 2005};
+  power.setBattery(BATTERY_PIN, 1000, 0, 8);
+
+  TEST_ASSERT_EQUAL_UINT16(2000, power.readBattery());
+  TEST_ASSERT_EQUAL(8, adcReads);
+  TEST_ASSERT_EQUAL_UINT8(BATTERY_PIN, adcPin);
+  TEST_ASSERT_EQUAL_UINT16(2000, power.getBatteryMv());
+}
+
+void test_battery_applies_divider_and_offset(void) {
+  PowerManager power(3600);
+  adcReadings = {1850};
+  power.setBattery(BATTERY_PIN, 2000, -12);
+
+  TEST_ASSERT_EQUAL_UINT16(3688, power.readBattery());
+}
+
+void test_battery_scale_rounds(void) {
+  PowerManager power(3600);
+  adcReadings = {1001};
+  power.setBattery(BATTERY_PIN, 1500, 0); // 1501.5 mV
+
+  TEST_ASSERT_EQUAL_UINT16(1502, power.readBattery());
+}
+
+void test_battery_samples_are_clamped(void) {
+  PowerManager power(3600);
+  adcReadings = {1000};
+
+  power.setBattery(BATTERY_PIN, 1000, 0, 0);
+  power.readBattery();
+  TEST_ASSERT_EQUAL(1, adcReads);
+
+  adcReads = 0;
+  power.setBattery(BATTERY_PIN, 1000, 0, 255);
+  power.readBattery();
+  TEST_ASSERT_EQUAL(PowerManager::MAX_BATTERY_SAMPLES, adcReads);
+}
+
+// ========================================
+// Test Cases - Energy Policy
+// ========================================
+
+void test_policy_allows_everything_without_reading(void) {
+  PowerManager power(3600);
+  power.setEnergyPolicy(liIonPolicy());
+
+  TEST_ASSERT_EQUAL_UINT32(3600, power.getSleepDuration());
+  TEST_ASSERT_TRUE(power.allowNtp());
+  TEST_ASSERT_TRUE(power.allowRetries());
+  TEST_ASSERT_TRUE(power.allowRadio());
+}
+
+void test_policy_on_full_battery(void) {
+  PowerManager power(3600);
+  readAt(power, 4100);
+
+  TEST_ASSERT_EQUAL_UINT32(3600, power.getSleepDuration());
+  TEST_ASSERT_TRUE(power.allowNtp());
+  TEST_ASSERT_TRUE(power.allowRetries());
+  TEST_ASSERT_TRUE(power.allowRadio());
+}
+
+void test_policy_lengthens_sleep_when_low(void) {
+  PowerManager power(900);
+  readAt(power, 3550);
+
+  TEST_ASSERT_EQUAL_UINT32(3600, power.getSleepDuration());
+  TEST_ASSERT_TRUE(power.allowNtp());
+  TEST_ASSERT_TRUE(power.allowRadio());
+}
+
+void test_policy_steps_down_with_voltage(void) {
+  PowerManager power(3600);
+
+  readAt(power, 3480);
+  TEST_ASSERT_FALSE(power.allowNtp());
+  TEST_ASSERT_TRUE(power.allowRetries());
+
+  readAt(power, 3400);
+  TEST_ASSERT_FALSE(power.allowRetries());
+  TEST_ASSERT_TRUE(power.allowRadio());
+
+  readAt(power, 3200);
+  TEST_ASSERT_FALSE(power.allowRadio());
+  TEST_ASSERT_EQUAL_UINT32(4 * 3600, power.getSleepDuration());
+}
+
+void test_policy_threshold_is_exclusive(void) {
+  PowerManager power(3600);
+
+  readAt(power, 3300);
+  TEST_ASSERT_TRUE(power.allowRadio());
+}
+
+void test_policy_zero_disables_threshold(void) {
+  PowerManager power(3600);
+  adcReadings = {1000};
+  power.setBattery(BATTERY_PIN, 1000, 0);
+  EnergyPolicy policy = {0, 4, 0, 0, 0};
+  power.setEnergyPolicy(policy);
+  power.readBattery();
+
+  TEST_ASSERT_EQUAL_UINT32(3600, power.getSleepDuration());
+  TEST_ASSERT_TRUE(power.allowNtp());
+  TEST_ASSERT_TRUE(power.allowRetries());
+  TEST_ASSERT_TRUE(power.allowRadio());
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Battery tests
+  RUN_TEST(test_battery_without_pin_is_not_read);
+  RUN_TEST(test_battery_averages_samples);
+  RUN_TEST(test_battery_applies_divider_and_offset);
+  RUN_TEST(test_battery_scale_rounds);
+  RUN_TEST(test_battery_samples_are_clamped);
+
+  // Energy policy tests
+  RUN_TEST(test_policy_allows_everything_without_reading);
+  RUN_TEST(test_policy_on_full_battery);
+  RUN_TEST(test_policy_lengthens_sleep_when_low);
+  RUN_TEST(test_policy_steps_down_with_voltage);
+  RUN_TEST(test_policy_threshold_is_exclusive);
+  RUN_TEST(test_policy_zero_disables_threshold);
+
+  return UNITY_END();
+}
@@ -0,0 +1,263 @@
+#include <string.h>
+#include <unity.h>
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../../lib/PulseCounter/PulseCounter.h"
+#include "../../lib/SensorHub/Measurements.h"
+
+// Include implementation files for linking
+#include "../../lib/PulseCounter/PulseCounter.cpp"
+#include "../../lib/SensorHub/Measurements.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+// Reed contacts to ground with pull-ups: idle high, active low
+static const uint8_t RAIN_PIN = 3;
+static const uint8_t WIND_PIN = 4;
+static const uint64_t RAIN = 1ULL << RAIN_PIN;
+static const uint64_t WIND = 1ULL << WIND_PIN;
+static const uint64_t IDLE = RAIN | WIND;
+static const uint64_t MS = 1000;
+
+PulseCounterState state;
+
+// Counter as set up on every boot, armed with both contacts open
+PulseCounter makeCounter() {
+  PulseCounter counter(state);
+  counter.addInput(RAIN_PIN, CHANNEL_RAIN_PULSES, LOW, 50);
+  counter.addInput(WIND_PIN, CHANNEL_WIND_PULSES, LOW, 5);
+  uint64_t low, high;
+  counter.arm(IDLE, low, high);
+  return counter;
+}
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  memset(&state, 0, sizeof(state));
+}
+
+void tearDown(void) {}
+
+// ========================================
+// Test Cases - Wake Handler
+// ========================================
+
+void test_wake_on_active_level_counts_pulse(void) {
+  PulseCounter counter = makeCounter();
+
+  counter.onWake(RAIN, IDLE & ~RAIN, 1000 * MS);
+
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(0));
+  TEST_ASSERT_EQUAL_UINT32(0, counter.pulses(1));
+}
+
+void test_short_pulse_counts_after_contact_opened(void) {
+  PulseCounter counter = makeCounter();
+
+  // Contact already open again by the time the pin is read
+  counter.onWake(WIND, IDLE, 1000 * MS);
+
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(1));
+}
+
+void test_release_wake_rearms_without_counting(void) {
+  PulseCounter counter = makeCounter();
+  uint64_t low, high;
+
+  counter.onWake(RAIN, IDLE & ~RAIN, 1000 * MS);
+  counter.arm(IDLE & ~RAIN, low, high);
+  TEST_ASSERT_EQUAL_HEX64(WIND, low);
+  TEST_ASSERT_EQUAL_HEX64(RAIN, high);
+
+  // Contact opens: wake on the idle level
+  counter.onWake(RAIN, IDLE, 1200 * MS);
+  counter.arm(IDLE, low, high);
+
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(0));
+  TEST_ASSERT_EQUAL_HEX64(IDLE, low);
+  TEST_ASSERT_EQUAL_HEX64(0, high);
+}
+
+void test_release_and_new_pulse_counts(void) {
+  PulseCounter counter = makeCounter();
+  uint64_t low, high;
+
+  counter.onWake(RAIN, IDLE & ~RAIN, 1000 * MS);
+  counter.arm(IDLE & ~RAIN, low, high);
+  // Woken by the contact opening, closed again by the time it is read
+  counter.onWake(RAIN, IDLE & ~RAIN, 2000 * MS);
+
+  TEST_ASSERT_EQUAL_UINT32(2, counter.pulses(0));
+}
+
+void test_bounce_is_not_counted(void) {
+  PulseCounter counter = makeCounter();
+  uint64_t low, high;
+
+  counter.onWake(RAIN, IDLE & ~RAIN, 1000 * MS);
+  counter.arm(IDLE & ~RAIN, low, high);
+  counter.onWake(RAIN, IDLE & ~RAIN, 1020 * MS); // 20 ms < 50 ms debounce
+  counter.arm(IDLE, low, high);
+  counter.onWake(RAIN, IDLE & ~RAIN, 1049 * MS);
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(0));
+
+  counter.arm(IDLE, low, high);
+  counter.onWake(RAIN, IDLE & ~RAIN, 1050 * MS);
+  TEST_ASSERT_EQUAL_UINT32(2, counter.pulses(0));
+}
+
+void test_other_pin_wake_catches_closed_contact(void) {
+  PulseCounter counter = makeCounter();
+
+  // Both contacts closed, only the rain gauge reported as the wake source
+  counter.onWake(RAIN, 0, 1000 * MS);
+
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(0));
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(1));
+}
+
+void test_held_contact_is_counted_once(void) {
+  PulseCounter counter = makeCounter();
+  uint64_t low, high;
+
+  counter.onWake(WIND, IDLE & ~WIND, 1000 * MS);
+  counter.arm(IDLE & ~WIND, low, high);
+  // Rain wake while the anemometer contact is still held closed
+  counter.onWake(RAIN, IDLE & ~RAIN & ~WIND, 3000 * MS);
+
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(1));
+}
+
+void test_counts_survive_reboot(void) {
+  {
+    PulseCounter counter = makeCounter();
+    counter.onWake(RAIN, IDLE & ~RAIN, 1000 * MS);
+  }
+  PulseCounter counter = makeCounter();
+  counter.onWake(RAIN, IDLE & ~RAIN, 2000 * MS);
+
+  TEST_ASSERT_EQUAL_UINT32(2, counter.pulses(0));
+}
+
+void test_invalid_magic_resets_state(void) {
+  state.magic = 0xDEADBEEF;
+  state.inputs[0].count = 99;
+
+  PulseCounter counter(state);
+
+  TEST_ASSERT_EQUAL_HEX32(PulseCounter::MAGIC, state.magic);
+  TEST_ASSERT_EQUAL_UINT32(0, state.inputs[0].count);
+}
+
+// ========================================
+// Test Cases - Configuration
+// ========================================
+
+void test_only_rtc_pins_can_wake(void) {
+  PulseCounter counter(state);
+
+  TEST_ASSERT_FALSE(counter.addInput(6, CHANNEL_RAIN_PULSES, LOW, 50));
+  for (uint8_t pin = 0; pin < PulseCounterState::MAX_INPUTS; pin++) {
+    TEST_ASSERT_TRUE(counter.addInput(pin, CHANNEL_WIND_PULSES, LOW, 5));
+  }
+  TEST_ASSERT_FALSE(counter.addInput(5, CHANNEL_WIND_PULSES, LOW, 5));
+  TEST_ASSERT_EQUAL_UINT8(PulseCounterState::MAX_INPUTS, counter.count());
+}
+
+void test_arm_follows_active_level(void) {
+  PulseCounter counter(state);
+  counter.addInput(RAIN_PIN, CHANNEL_RAIN_PULSES, HIGH, 50);
+  uint64_t low, high;
+
+  // Active high, idle low: wake when the pin goes high
+  counter.arm(0, low, high);
+  TEST_ASSERT_EQUAL_HEX64(0, low);
+  TEST_ASSERT_EQUAL_HEX64(RAIN, high);
+
+  counter.onWake(RAIN, RAIN, 1000 * MS);
+  TEST_ASSERT_EQUAL_UINT32(1, counter.pulses(0));
+}
+
+void test_remaining_interval(void) {
+  PulseCounter counter = makeCounter();
+
+  counter.startInterval(1000 * MS, 3600000 * MS);
+
+  TEST_ASSERT_EQUAL_UINT64(3599000 * MS, counter.remainingUs(2000 * MS));
+  TEST_ASSERT_EQUAL_UINT64(0, counter.remainingUs(3601000 * MS));
+}
+
+// ========================================
+// Test Cases - Publishing
+// ========================================
+
+void test_collect_adds_counts(void) {
+  PulseCounter counter = makeCounter();
+  counter.onWake(RAIN, IDLE & ~RAIN, 1000 * MS);
+  Measurements m = {};
+
+  TEST_ASSERT_TRUE(counter.collect(m));
+
+  int32_t value;
+  TEST_ASSERT_TRUE(m.get(CHANNEL_RAIN_PULSES, value));
+  TEST_ASSERT_EQUAL_INT32(1, value);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_WIND_PULSES, value));
+  TEST_ASSERT_EQUAL_INT32(0, value);
+  TEST_ASSERT_EQUAL_STRING("rain_pulses", Measurements::info(CHANNEL_RAIN_PULSES)->key);
+}
+
+void test_clear_keeps_debounce(void) {
+  PulseCounter counter = makeCounter();
+  uint64_t low, high;
+  counter.onWake(RAIN, IDLE & ~RAIN, 1000 * MS);
+
+  counter.clear();
+  counter.arm(IDLE, low, high);
+  counter.onWake(RAIN, IDLE & ~RAIN, 1010 * MS);
+
+  TEST_ASSERT_EQUAL_UINT32(0, counter.pulses(0));
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Wake handler tests
+  RUN_TEST(test_wake_on_active_level_counts_pulse);
+  RUN_TEST(test_short_pulse_counts_after_contact_opened);
+  RUN_TEST(test_release_wake_rearms_without_counting);
+  RUN_TEST(test_release_and_new_pulse_counts);
+  RUN_TEST(test_bounce_is_not_counted);
+  RUN_TEST(test_other_pin_wake_catches_closed_contact);
+  RUN_TEST(test_held_contact_is_counted_once);
+  RUN_TEST(test_counts_survive_reboot);
+  RUN_TEST(test_invalid_magic_resets_state);
+
+  // Configuration tests
+  RUN_TEST(test_only_rtc_pins_can_wake);
+  RUN_TEST(test_arm_follows_active_level);
+  RUN_TEST(test_remaining_interval);
+
+  // Publishing tests
+  RUN_TEST(test_collect_adds_counts);
+  RUN_TEST(test_clear_keeps_debounce);
+
+  return UNITY_END();
+}
@@ -0,0 +1,406 @@
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <unity.h>
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+#include "MockBME280.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../../lib/BME280Sensor/BME280Sensor.h"
+#include "../../lib/SensorHub/ISensor.h"
+#include "../../lib/SensorHub/IntervalStats.h"
+#include "../../lib/SensorHub/Measurements.h"
+#include "../../lib/SensorHub/SensorHub.h"
+
+// Include implementation files for linking
+#include "../../lib/BME280Sensor/AltitudeTable.cpp"
+#include "../../lib/BME280Sensor/BME280Compensation.cpp"
+#include "../../lib/BME280Sensor/BME280Sensor.cpp"
+#include "../../lib/SensorHub/IntervalStats.cpp"
+#include "../../lib/SensorHub/Measurements.cpp"
+#include "../../lib/SensorHub/SensorHub.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+// Every trigger and collect, in call order, e.g. "T:a T:b C:a C:b "
+std::string calls;
+
+// Sensor with a fixed conversion time that reports one channel
+class FakeSensor : public ISensor {
+public:
+  FakeSensor(const char *name, uint32_t conversionMs, Channel channel, int32_t value)
+      : name(name), conversionMs(conversionMs), channel(channel), value(value) {}
+
+  const char *getName() const override { return name; }
+  bool begin() override { return beginOk; }
+
+  uint32_t trigger() override {
+    calls += std::string("T:") + name + " ";
+    triggeredAt = _mock_millis;
+    return conversionMs;
+  }
+
+  bool collect(Measurements &out) override {
+    calls += std::string("C:") + name + " ";
+    // A real sensor would return stale data if read too early
+    if (!collectOk || _mock_millis - triggeredAt < conversionMs) {
+      return false;
+    }
+    return out.add(channel, value);
+  }
+
+  const char *getLastError() const override { return "fake failure"; }
+
+  const char *name;
+  uint32_t conversionMs;
+  Channel channel;
+  int32_t value;
+  bool beginOk = true;
+  bool collectOk = true;
+  unsigned long triggeredAt = 0;
+};
+
+MockBME280 chip(Wire);
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  calls.clear();
+  Wire.reset();
+  chip.attach();
+}
+
+void tearDown(void) {}
+
+// ========================================
+// Test Cases - Measurements
+// ========================================
+
+void test_measurements_add_and_get(void) {
+  Measurements m = {};
+
+  TEST_ASSERT_TRUE(m.add(CHANNEL_PRESSURE, 101325));
+  TEST_ASSERT_TRUE(m.add(CHANNEL_TEMPERATURE, -150));
+
+  int32_t value = 0;
+  TEST_ASSERT_TRUE(m.get(CHANNEL_TEMPERATURE, value));
+  TEST_ASSERT_EQUAL_INT32(-150, value);
+  TEST_ASSERT_FALSE(m.get(CHANNEL_HUMIDITY, value));
+}
+
+void test_measurements_reject_overflow(void) {
+  Measurements m = {};
+
+  for (uint8_t i = 0; i < Measurements::MAX_MEASUREMENTS; i++) {
+    TEST_ASSERT_TRUE(m.add(CHANNEL_TEMPERATURE, i));
+  }
+  TEST_ASSERT_FALSE(m.add(CHANNEL_TEMPERATURE, 99));
+  TEST_ASSERT_EQUAL(Measurements::MAX_MEASUREMENTS, m.count);
+}
+
+void test_channel_info(void) {
+  const ChannelInfo *info = Measurements::info(CHANNEL_HUMIDITY);
+
+  TEST_ASSERT_NOT_NULL(info);
+  TEST_ASSERT_EQUAL_STRING("humidity", info->key);
+  TEST_ASSERT_EQUAL(3, info->scale);
+  TEST_ASSERT_NULL(Measurements::info(CHANNEL_COUNT));
+}
+
+// ========================================
+// Test Cases - Registry
+// ========================================
+
+void test_add_rejects_null_and_overflow(void) {
+  SensorHub hub;
+  FakeSensor sensor("a", 0, CHANNEL_TEMPERATURE, 1);
+
+  TEST_ASSERT_FALSE(hub.add(nullptr));
+  for (uint8_t i = 0; i < SensorHub::MAX_SENSORS; i++) {
+    TEST_ASSERT_TRUE(hub.add(&sensor));
+  }
+  TEST_ASSERT_FALSE(hub.add(&sensor));
+  TEST_ASSERT_EQUAL(SensorHub::MAX_SENSORS, hub.count());
+}
+
+void test_begin_leaves_failed_sensor_out(void) {
+  SensorHub hub;
+  FakeSensor good("good", 0, CHANNEL_TEMPERATURE, 2153);
+  FakeSensor bad("bad", 0, CHANNEL_HUMIDITY, 45100);
+  bad.beginOk = false;
+  hub.add(&good);
+  hub.add(&bad);
+
+  TEST_ASSERT_FALSE(hub.begin());
+  TEST_ASSERT_EQUAL(1, hub.activeCount());
+  TEST_ASSERT_EQUAL_STRING("bad: fake failure", hub.getLastError());
+
+  Measurements m = {};
+  TEST_ASSERT_TRUE(hub.sample(m));
+  TEST_ASSERT_EQUAL_STRING("T:good C:good ", calls.c_str());
+  TEST_ASSERT_EQUAL(1, m.count);
+}
+
+// ========================================
+// Test Cases - Scheduler
+// ========================================
+
+void test_sample_overlaps_conversions(void) {
+  SensorHub hub;
+  FakeSensor fast("fast", 10, CHANNEL_TEMPERATURE, 2153);
+  FakeSensor slow("slow", 40, CHANNEL_HUMIDITY, 45100);
+  FakeSensor continuous("continuous", 0, CHANNEL_PRESSURE, 101325);
+  hub.add(&fast);
+  hub.add(&slow);
+  hub.add(&continuous);
+  TEST_ASSERT_TRUE(hub.begin());
+
+  Measurements m = {};
+  TEST_ASSERT_TRUE(hub.sample(m));
+
+  // One wait for the slowest conversion instead of 10 + 40 ms in series
+  TEST_ASSERT_EQUAL(40, _mock_millis);
+  TEST_ASSERT_EQUAL_UINT32(40, hub.getLastWaitMs());
+  TEST_ASSERT_EQUAL_STRING("T:fast T:slow T:continuous C:fast C:slow C:continuous ", calls.c_str());
+  TEST_ASSERT_EQUAL(3, m.count);
+}
+
+void test_sample_without_conversions_does_not_wait(void) {
+  SensorHub hub;
+  FakeSensor continuous("continuous", 0, CHANNEL_PRESSURE, 101325);
+  hub.add(&continuous);
+  hub.begin();
+
+  Measurements m = {};
+  TEST_ASSERT_TRUE(hub.sample(m));
+  TEST_ASSERT_EQUAL(0, _mock_millis);
+}
+
+void test_sample_keeps_results_of_working_sensors(void) {
+  SensorHub hub;
+  FakeSensor bad("bad", 5, CHANNEL_TEMPERATURE, 2153);
+  FakeSensor good("good", 5, CHANNEL_HUMIDITY, 45100);
+  bad.collectOk = false;
+  hub.add(&bad);
+  hub.add(&good);
+  hub.begin();
+
+  Measurements m = {};
+  m.count = 3; // Leftovers are cleared
+  TEST_ASSERT_FALSE(hub.sample(m));
+  TEST_ASSERT_EQUAL_STRING("bad: fake failure", hub.getLastError());
+
+  int32_t value = 0;
+  TEST_ASSERT_EQUAL(1, m.count);
+  TEST_ASSERT_TRUE(m.get(CHANNEL_HUMIDITY, value));
+  TEST_ASSERT_EQUAL_INT32(45100, value);
+}
+
+// ========================================
+// Test Cases - Interval Statistics
+// ========================================
+
+Measurements pointSample(int32_t temperature, int32_t pressure) {
+  Measurements m = {};
+  m.add(CHANNEL_TEMPERATURE, temperature);
+  m.add(CHANNEL_PRESSURE, pressure);
+  return m;
+}
+
+void test_stats_reset_without_magic(void) {
+  IntervalStatsState state;
+  memset(&state, 0xA5, sizeof(state));
+
+  IntervalStats stats(state);
+
+  TEST_ASSERT_EQUAL_UINT32(IntervalStats::MAGIC, state.magic);
+  TEST_ASSERT_EQUAL(0, stats.samples());
+}
+
+void test_stats_summarize_interval(void) {
+  IntervalStatsState state = {};
+  IntervalStats stats(state);
+  const int32_t temperatures[] = {2000, 2100, 2200, 1900, 2300};
+  for (int32_t t : temperatures) {
+    stats.add(pointSample(t, 101325));
+  }
+
+  Measurements out = {};
+  TEST_ASSERT_TRUE(stats.summarize(out));
+
+  int32_t value = 0;
+  TEST_ASSERT_EQUAL(5, out.samples);
+  TEST_ASSERT_EQUAL(8, out.count);
+  TEST_ASSERT_TRUE(out.get(CHANNEL_TEMPERATURE, value, STAT_MIN));
+  TEST_ASSERT_EQUAL_INT32(1900, value);
+  TEST_ASSERT_TRUE(out.get(CHANNEL_TEMPERATURE, value, STAT_MAX));
+  TEST_ASSERT_EQUAL_INT32(2300, value);
+  TEST_ASSERT_TRUE(out.get(CHANNEL_TEMPERATURE, value, STAT_MEAN));
+  TEST_ASSERT_EQUAL_INT32(2100, value);
+  TEST_ASSERT_TRUE(out.get(CHANNEL_TEMPERATURE, value, STAT_STDDEV));
+  TEST_ASSERT_EQUAL_INT32(158, value); // sqrt(25000)
+  TEST_ASSERT_TRUE(out.get(CHANNEL_PRESSURE, value, STAT_STDDEV));
+  TEST_ASSERT_EQUAL_INT32(0, value);
+}
+
+void test_stats_track_double_reference(void) {
+  IntervalStatsState state = {};
+  IntervalStats stats(state);
+  double sum = 0;
+  double squares = 0;
+  const int n = 96; // A day of 15 minute samples
+  uint32_t seed = 12345;
+  for (int i = 0; i < n; i++) {
+    seed = seed * 1103515245 + 12345;
+    int32_t pressure = 98000 + static_cast<int32_t>((seed >> 8) % 6000);
+    stats.add(pointSample(-500 + i * 10, pressure));
+    sum += pressure;
+    squares += static_cast<double>(pressure) * pressure;
+  }
+
+  Measurements out = {};
+  TEST_ASSERT_TRUE(stats.summarize(out));
+
+  double mean = sum / n;
+  double deviation = sqrt((squares - n * mean * mean) / (n - 1));
+  int32_t value = 0;
+  TEST_ASSERT_TRUE(out.get(CHANNEL_PRESSURE, value, STAT_MEAN));
+  TEST_ASSERT_INT32_WITHIN(1, lround(mean), value);
+  TEST_ASSERT_TRUE(out.get(CHANNEL_PRESSURE, value, STAT_STDDEV));
+  TEST_ASSERT_INT32_WITHIN(1, lround(deviation), value);
+  TEST_ASSERT_TRUE(out.get(CHANNEL_TEMPERATURE, value, STAT_MIN));
+  TEST_ASSERT_EQUAL_INT32(-500, value);
+}
+
+void test_stats_ignore_statistics_and_extra_channels(void) {
+  IntervalStatsState state = {};
+  IntervalStats stats(state);
+  Measurements sample = pointSample(2000, 101325);
+  sample.add(CHANNEL_TEMPERATURE, 9999, STAT_MAX);
+
+  stats.add(sample);
+
+  TEST_ASSERT_EQUAL(2, state.count);
+  TEST_ASSERT_EQUAL_INT32(2000, state.channels[0].max);
+}
+
+void test_stats_summarize_reports_full_output(void) {
+  IntervalStatsState state = {};
+  IntervalStats stats(state);
+  stats.add(pointSample(2000, 101325));
+
+  Measurements out = {};
+  out.count = Measurements::MAX_MEASUREMENTS - 5;
+  TEST_ASSERT_FALSE(stats.summarize(out));
+}
+
+void test_stats_clear(void) {
+  IntervalStatsState state = {};
+  IntervalStats stats(state);
+  stats.add(pointSample(2000, 101325));
+
+  stats.clear();
+
+  Measurements out = {};
+  TEST_ASSERT_TRUE(stats.summarize(out));
+  TEST_ASSERT_EQUAL(0, out.count);
+  TEST_ASSERT_EQUAL(0, out.samples);
+  TEST_ASSERT_EQUAL_UINT32(IntervalStats::MAGIC, state.magic);
+}
+
+// ========================================
+// Test Cases - BME280
+// ========================================
+
+void test_bme280_reports_its_channels(void) {
+  SensorHub hub;
+  BME280Sensor sensor;
+  hub.add(&sensor);
+  TEST_ASSERT_TRUE(hub.begin());
+
+  Measurements m = {};
+  TEST_ASSERT_TRUE(hub.sample(m));
+
+  TEST_ASSERT_EQUAL_UINT32(sensor.conversionTimeMs(), hub.getLastWaitMs());
+  TEST_ASSERT_EQUAL(4, m.count);
+  TEST_ASSERT_EQUAL(CHANNEL_TEMPERATURE, m.items[0].channel);
+  TEST_ASSERT_EQUAL_INT32(2508, m.items[0].value);
+  TEST_ASSERT_EQUAL(CHANNEL_PRESSURE, m.items[2].channel);
+  TEST_ASSERT_EQUAL_INT32(100653, m.items[2].value);
+  TEST_ASSERT_EQUAL(CHANNEL_ALTITUDE, m.items[3].channel);
+}
+
+void test_bme280_without_altitude(void) {
+  SensorHub hub;
+  BME280Sensor sensor;
+  sensor.setAltitudeEnabled(false);
+  hub.add(&sensor);
+  hub.begin();
+
+  Measurements m = {};
+  TEST_ASSERT_TRUE(hub.sample(m));
+
+  int32_t value = 0;
+  TEST_ASSERT_EQUAL(3, m.count);
+  TEST_ASSERT_FALSE(m.get(CHANNEL_ALTITUDE, value));
+}
+
+void test_bme280_missing_is_left_out(void) {
+  chip.detach();
+  SensorHub hub;
+  BME280Sensor sensor;
+  hub.add(&sensor);
+
+  TEST_ASSERT_FALSE(hub.begin());
+  TEST_ASSERT_EQUAL(0, hub.activeCount());
+  TEST_ASSERT_EQUAL(0, strncmp("BME280: Could not find", hub.getLastError(), 22));
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Measurements tests
+  RUN_TEST(test_measurements_add_and_get);
+  RUN_TEST(test_measurements_reject_overflow);
+  RUN_TEST(test_channel_info);
+
+  // Registry tests
+  RUN_TEST(test_add_rejects_null_and_overflow);
+  RUN_TEST(test_begin_leaves_failed_sensor_out);
+
+  // Scheduler tests
+  RUN_TEST(test_sample_overlaps_conversions);
+  RUN_TEST(test_sample_without_conversions_does_not_wait);
+  RUN_TEST(test_sample_keeps_results_of_working_sensors);
+
+  // Interval statistics tests
+  RUN_TEST(test_stats_reset_without_magic);
+  RUN_TEST(test_stats_summarize_interval);
+  RUN_TEST(test_stats_track_double_reference);
+  RUN_TEST(test_stats_ignore_statistics_and_extra_channels);
+  RUN_TEST(test_stats_summarize_reports_full_output);
+  RUN_TEST(test_stats_clear);
+
+  // BME280 tests
+  RUN_TEST(test_bme280_reports_its_channels);
+  RUN_TEST(test_bme280_without_altitude);
+  RUN_TEST(test_bme280_missing_is_left_out);
+
+  return UNITY_END();
+}
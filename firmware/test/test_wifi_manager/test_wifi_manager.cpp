@@ -0,0 +1,197 @@
+#include <string.h>
+#include <unity.h>
+
+#ifdef UNIT_TEST
+#include "Arduino.h"
+
+// Override millis/delay for testing
+unsigned long _mock_millis = 0;
+unsigned long millis() { return _mock_millis; }
+void delay(unsigned long ms) { _mock_millis += ms; }
+#endif
+
+#include "../../lib/WiFiManager/WiFiManager.h"
+
+// Include implementation files for linking
+#include "../../lib/Crc32/Crc32.cpp"
+#include "../../lib/EventLog/EventLog.cpp"
+#include "../../lib/WiFiManager/WiFiManager.cpp"
+#include "../../test/mocks/mocks.cpp"
+
+// Each WiFiManager has its own (mock) NVS: a second instance sharing the
+// cache stands for the next wake, with nothing in NVS but what it wrote
+WiFiCacheState cache;
+
+// ========================================
+// Test Setup/Teardown
+// ========================================
+
+void setUp(void) {
+  _mock_millis = 0;
+  memset(&cache, 0, sizeof(cache));
+  WiFi.setNetwork(nullptr);
+  WiFi.disconnect();
+}
+
+void tearDown(void) {}
+
+// ========================================
+// Test Cases - Credentials
+// ========================================
+
+void test_begin_without_credentials_fails(void) {
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+
+  TEST_ASSERT_FALSE(wifi.begin());
+  TEST_ASSERT_TRUE(wifi.needsProvisioning());
+  TEST_ASSERT_EQUAL_UINT32(0, cache.magic);
+}
+
+void test_constructor_credentials_bypass_cache(void) {
+  WiFiManager wifi("ctor-net", "ctor-pass");
+  wifi.setCache(&cache);
+
+  TEST_ASSERT_TRUE(wifi.begin());
+  TEST_ASSERT_EQUAL_STRING("ctor-net", wifi.getSSID());
+  TEST_ASSERT_FALSE(wifi.isFromCache());
+}
+
+void test_reject_empty_credentials(void) {
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+
+  TEST_ASSERT_FALSE(wifi.storeCredentials("", "secret"));
+  TEST_ASSERT_EQUAL_STRING("Invalid WiFi credentials", wifi.getLastError());
+  TEST_ASSERT_EQUAL_UINT32(0, cache.magic);
+}
+
+// ========================================
+// Test Cases - RTC Cache
+// ========================================
+
+void test_store_fills_cache(void) {
+  WiFiManager provisioned;
+  provisioned.setCache(&cache);
+  TEST_ASSERT_TRUE(provisioned.storeCredentials("station-net", "secret"));
+
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+
+  TEST_ASSERT_TRUE(wifi.begin());
+  TEST_ASSERT_TRUE(wifi.isFromCache());
+  TEST_ASSERT_EQUAL_STRING("station-net", wifi.getSSID());
+  TEST_ASSERT_EQUAL_UINT32(1, wifi.getGeneration());
+}
+
+void test_store_bumps_generation(void) {
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+
+  wifi.storeCredentials("first-net", "secret");
+  wifi.storeCredentials("second-net", "secret");
+
+  TEST_ASSERT_EQUAL_UINT32(2, wifi.getGeneration());
+  TEST_ASSERT_EQUAL_UINT32(2, cache.generation);
+  TEST_ASSERT_EQUAL_STRING("second-net", cache.ssid);
+}
+
+void test_clear_empties_cache(void) {
+  WiFiManager provisioned;
+  provisioned.setCache(&cache);
+  provisioned.storeCredentials("station-net", "secret");
+
+  TEST_ASSERT_TRUE(provisioned.clearCredentials());
+  TEST_ASSERT_EQUAL_UINT32(2, provisioned.getGeneration());
+
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+  TEST_ASSERT_FALSE(wifi.begin());
+}
+
+void test_corrupted_cache_is_ignored(void) {
+  WiFiManager provisioned;
+  provisioned.setCache(&cache);
+  provisioned.storeCredentials("station-net", "secret");
+  cache.password[0] ^= 0x01;
+
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+
+  TEST_ASSERT_FALSE(wifi.begin());
+  TEST_ASSERT_FALSE(wifi.isFromCache());
+}
+
+void test_cache_of_other_layout_is_ignored(void) {
+  WiFiManager provisioned;
+  provisioned.setCache(&cache);
+  provisioned.storeCredentials("station-net", "secret");
+  cache.magic = 0x57464330;
+
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+
+  TEST_ASSERT_FALSE(wifi.begin());
+}
+
+void test_cache_connects_without_reading_nvs(void) {
+  WiFiManager provisioned;
+  provisioned.setCache(&cache);
+  provisioned.storeCredentials("station-net", "secret");
+  WiFi.setNetwork("station-net");
+
+  WiFiManager wifi;
+  wifi.setCache(&cache);
+
+  TEST_ASSERT_TRUE(wifi.begin());
+  TEST_ASSERT_TRUE(wifi.connect());
+  TEST_ASSERT_TRUE(wifi.isFromCache());
+}
+
+void test_stale_cache_is_rejected(void) {
+  WiFiManager provisioned;
+  provisioned.setCache(&cache);
+  provisioned.storeCredentials("old-net", "secret");
+
+  // NVS rewritten behind the cache's back: generation 2 holds no credentials
+  WiFiManager wifi;
+  wifi.storeCredentials("new-net", "secret");
+  wifi.clearCredentials();
+  wifi.setCache(&cache);
+  WiFi.setNetwork("new-net");
+
+  TEST_ASSERT_TRUE(wifi.begin());
+  TEST_ASSERT_EQUAL_UINT32(1, wifi.getGeneration());
+  TEST_ASSERT_FALSE(wifi.connect());
+  TEST_ASSERT_FALSE(wifi.isFromCache());
+  TEST_ASSERT_EQUAL_UINT32(2, wifi.getGeneration());
+  TEST_ASSERT_TRUE(wifi.needsProvisioning());
+  TEST_ASSERT_EQUAL_UINT32(0, cache.magic);
+}
+
+// ========================================
+// Main Test Runner
+// ========================================
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+
+  UNITY_BEGIN();
+
+  // Credentials tests
+  RUN_TEST(test_begin_without_credentials_fails);
+  RUN_TEST(test_constructor_credentials_bypass_cache);
+  RUN_TEST(test_reject_empty_credentials);
+
+  // RTC cache tests
+  RUN_TEST(test_store_fills_cache);
+  RUN_TEST(test_store_bumps_generation);
+  RUN_TEST(test_clear_empties_cache);
+  RUN_TEST(test_corrupted_cache_is_ignored);
+  RUN_TEST(test_cache_of_other_layout_is_ignored);
+  RUN_TEST(test_cache_connects_without_reading_nvs);
+  RUN_TEST(test_stale_cache_is_rejected);
+
+  return UNITY_END();
+}